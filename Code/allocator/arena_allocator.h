@@ -0,0 +1,120 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+namespace my {
+    /**
+     * 单调增长的内存池（arena）
+     * 1、从一块大内存中按顺序“切”出空间，分配只是移动一个指针。
+     * 2、单次释放什么也不做，所有空间在arena析构时一次性归还。
+     * 3、当前块用完时申请一块新块，块大小按2倍增长。
+     * 适合生命周期一致的一批对象（如一次请求内创建的所有数组），不适合频繁扩容、长期存活的容器。
+     */
+    class arena {
+    public:
+        arena(size_t initial_size = 64 * 1024); // 构造函数，initial_size为第一块的大小
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+        ~arena(); // 析构函数，归还所有块
+
+        void* allocate(size_t bytes, size_t align); // 切出bytes字节、按align对齐的空间
+        void release(); // 归还所有块，之前分配的空间全部失效
+
+    private:
+        // 每一块的头部，块之间用单链表串起来
+        struct _block {
+            _block* _next; // 上一块
+            size_t _size; // 本块可用的字节数（不含头部）
+        };
+
+        _block* _head; // 当前块
+        char* _cur; // 当前块中下一个可用位置
+        char* _end; // 当前块的结束位置
+        size_t _next_size; // 下一块的大小
+    };
+
+    // 单调增长的内存池具体实现
+
+    // 构造函数，第一块延迟到第一次分配时才申请
+    inline arena::arena(size_t initial_size)
+        : _head(nullptr)
+        , _cur(nullptr)
+        , _end(nullptr)
+        , _next_size(initial_size == 0 ? 1 : initial_size)
+    {}
+
+    // 析构函数
+    inline arena::~arena() {
+        release();
+    }
+
+    // 切出bytes字节、按align对齐的空间，当前块放不下时申请新块
+    inline void* arena::allocate(size_t bytes, size_t align) {
+        uintptr_t p = (reinterpret_cast<uintptr_t>(_cur) + align - 1) / align * align;
+        if (_cur == nullptr || p + bytes > reinterpret_cast<uintptr_t>(_end)) {
+            while (_next_size < bytes + align) {
+                _next_size *= 2;
+            }
+            _block* block = static_cast<_block*>(::operator new(sizeof(_block) + _next_size));
+            block->_next = _head;
+            block->_size = _next_size;
+            _head = block;
+            _cur = reinterpret_cast<char*>(block + 1);
+            _end = _cur + _next_size;
+            _next_size *= 2; // 块大小按2倍增长
+            p = (reinterpret_cast<uintptr_t>(_cur) + align - 1) / align * align;
+        }
+        _cur = reinterpret_cast<char*>(p + bytes);
+        return reinterpret_cast<void*>(p);
+    }
+
+    // 归还所有块
+    inline void arena::release() {
+        while (_head) {
+            _block* next = _head->_next;
+            ::operator delete(_head);
+            _head = next;
+        }
+        _cur = nullptr;
+        _end = nullptr;
+    }
+
+    /**
+     * arena分配器，所有空间都从指定的arena中切出
+     * deallocate什么也不做，空间随arena一起释放，因此arena的生命周期必须长于使用它的容器
+     */
+    template <class T>
+    struct arena_allocator {
+        typedef T value_type;
+        typedef std::false_type propagate_on_container_copy_assignment; // 拷贝出的容器仍使用自己的arena
+        typedef std::true_type propagate_on_container_move_assignment; // 移动时空间连同arena一起转移
+        typedef std::true_type propagate_on_container_swap;
+
+        arena_allocator(arena& a) : _arena(&a) {} // 构造函数
+        template <class U>
+        arena_allocator(const arena_allocator<U>& other) : _arena(other._arena) {} // 不同元素类型之间转换（rebind）
+
+        // 申请能存放n个T的空间
+        T* allocate(size_t n) {
+            return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        // 单个释放什么也不做
+        void deallocate(T*, size_t) {}
+
+        arena* _arena; // 所使用的arena
+    };
+
+    // 使用同一个arena的分配器才相等
+    template <class T, class U>
+    bool operator==(const arena_allocator<T>& x, const arena_allocator<U>& y) {
+        return x._arena == y._arena;
+    }
+
+    template <class T, class U>
+    bool operator!=(const arena_allocator<T>& x, const arena_allocator<U>& y) {
+        return x._arena != y._arena;
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <sys/mman.h>
+
+namespace my {
+    /**
+     * 大页分配器（Linux）
+     * 1、用mmap申请匿名内存，并把起始地址对齐到2MB，长度向上取整到2MB的整数倍。
+     * 2、用madvise(MADV_HUGEPAGE)建议内核使用透明大页（THP），一个TLB表项覆盖2MB而不是4KB，
+     *    对几GB的大数组做顺序或随机扫描时能大幅减少TLB缺失。
+     * 3、内核未开启THP时madvise失败会被忽略，退化为普通4KB页，功能不受影响。
+     * 每次分配至少占用2MB，只适合给大数组使用。
+     */
+    template <class T>
+    struct huge_page_allocator {
+        typedef T value_type;
+        typedef std::true_type is_always_equal; // 无状态，任意两个分配器可以互相释放
+        typedef std::true_type propagate_on_container_move_assignment;
+
+        static constexpr size_t huge_page_size = 2 * 1024 * 1024; // 2MB
+
+        huge_page_allocator() = default;
+        template <class U>
+        huge_page_allocator(const huge_page_allocator<U>&) {} // 不同元素类型之间转换（rebind）
+
+        T* allocate(size_t n); // 申请能存放n个T的空间
+        void deallocate(T* p, size_t n); // 释放allocate返回的空间
+
+        // 把字节数向上取整到大页的整数倍
+        static size_t roundUp(size_t bytes) {
+            return (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+        }
+    };
+
+    // 大页分配器具体实现
+
+    /**
+     * 申请能存放n个T的空间
+     * mmap只保证4KB对齐，所以多申请一个大页，再把对齐地址前后多余的部分还给内核
+     */
+    template <class T>
+    T* huge_page_allocator<T>::allocate(size_t n) {
+        size_t len = roundUp(n * sizeof(T));
+        void* raw = mmap(nullptr, len + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (begin + huge_page_size - 1) / huge_page_size * huge_page_size;
+        if (aligned > begin) {
+            munmap(raw, aligned - begin); // 释放对齐地址之前的部分
+        }
+        size_t tail = begin + len + huge_page_size - (aligned + len);
+        if (tail > 0) {
+            munmap(reinterpret_cast<void*>(aligned + len), tail); // 释放末尾多余的部分
+        }
+        madvise(reinterpret_cast<void*>(aligned), len, MADV_HUGEPAGE); // 失败说明未开启THP，忽略即可
+        return reinterpret_cast<T*>(aligned);
+    }
+
+    // 释放allocate返回的空间，长度要与申请时一样取整
+    template <class T>
+    void huge_page_allocator<T>::deallocate(T* p, size_t n) {
+        munmap(p, roundUp(n * sizeof(T)));
+    }
+
+    template <class T, class U>
+    bool operator==(const huge_page_allocator<T>&, const huge_page_allocator<U>&) {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const huge_page_allocator<T>&, const huge_page_allocator<U>&) {
+        return false;
+    }
+}
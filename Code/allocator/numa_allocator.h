@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace my {
+    /**
+     * NUMA节点绑定分配器（Linux）
+     * 1、用mmap申请匿名内存，再用mbind(MPOL_BIND)把这段内存绑定到指定的NUMA节点，
+     *    之后首次访问产生的物理页都会从该节点分配，线程只访问本节点内存时可避免跨节点访存。
+     * 2、直接走mbind系统调用，不依赖libnuma；机器没有NUMA、内核未开启NUMA或节点号非法时mbind失败，
+     *    此时保留默认的内存策略（通常是first-touch），分配本身不会失败。
+     * 释放时只需munmap，与节点无关，所以绑定到不同节点的分配器之间也可以互相释放。
+     */
+    template <class T>
+    struct numa_allocator {
+        typedef T value_type;
+        typedef std::false_type propagate_on_container_copy_assignment; // 拷贝出的容器仍放在自己的节点上
+        typedef std::true_type propagate_on_container_move_assignment; // 移动时空间连同节点信息一起转移
+        typedef std::true_type propagate_on_container_swap;
+
+        numa_allocator(int node = 0); // 构造函数，node为要绑定的NUMA节点号
+        template <class U>
+        numa_allocator(const numa_allocator<U>& other) : _node(other._node) {} // 不同元素类型之间转换（rebind）
+
+        T* allocate(size_t n); // 申请能存放n个T的空间
+        void deallocate(T* p, size_t n); // 释放allocate返回的空间
+        int node() const; // 获取绑定的NUMA节点号
+
+        int _node; // 绑定的NUMA节点号
+    };
+
+    // NUMA节点绑定分配器具体实现
+
+    // 构造函数
+    template <class T>
+    numa_allocator<T>::numa_allocator(int node)
+        : _node(node)
+    {}
+
+    // 申请能存放n个T的空间
+    template <class T>
+    T* numa_allocator<T>::allocate(size_t n) {
+        size_t len = n * sizeof(T);
+        void* p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#ifdef SYS_mbind
+        if (_node >= 0 && _node < static_cast<int>(sizeof(unsigned long) * 8)) {
+            const int mpol_bind = 2; // MPOL_BIND，与<numaif.h>中的定义一致
+            unsigned long nodemask = 1UL << _node;
+            syscall(SYS_mbind, p, len, mpol_bind, &nodemask, sizeof(nodemask) * 8, 0); // 失败时保留默认策略
+        }
+#endif
+        return static_cast<T*>(p);
+    }
+
+    // 释放allocate返回的空间
+    template <class T>
+    void numa_allocator<T>::deallocate(T* p, size_t n) {
+        munmap(p, n * sizeof(T));
+    }
+
+    // 获取绑定的NUMA节点号
+    template <class T>
+    int numa_allocator<T>::node() const {
+        return _node;
+    }
+
+    // 所有numa_allocator都能释放彼此的空间，因此总是相等
+    template <class T, class U>
+    bool operator==(const numa_allocator<T>&, const numa_allocator<U>&) {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const numa_allocator<T>&, const numa_allocator<U>&) {
+        return false;
+    }
+}
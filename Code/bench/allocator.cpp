@@ -0,0 +1,116 @@
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "allocator/arena_allocator.h"
+#include "allocator/huge_page_allocator.h"
+#include "bench.h"
+#include "vector/vector.h"
+
+/**
+ * 分配器：大页对TLB受限扫描的影响，以及arena分配器的分配开销
+ * 数组大小以MB为单位；随机访问的下标由线性同余生成器现算，不额外读一个下标数组
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    // 读取/proc/self/smaps_rollup中的AnonHugePages，确认透明大页是否真的生效
+    double anonHugeMB() {
+        std::ifstream in("/proc/self/smaps_rollup");
+        std::string key;
+        while (in >> key) {
+            if (key == "AnonHugePages:") {
+                double kb = 0;
+                in >> kb;
+                return kb / 1024;
+            }
+        }
+        return 0;
+    }
+
+    template <class Alloc>
+    my::vector<uint64_t, Alloc> makeArray(size_t n) {
+        my::vector<uint64_t, Alloc> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            v.push_back(i);
+        }
+        return v;
+    }
+
+    // 随机读：每次访问大概率落在不同的页上，4KB页时几乎每次都是TLB缺失
+    template <class Alloc>
+    void randomRead(state& st) {
+        size_t n = size_t(st.arg(0)) * 1024 * 1024 / sizeof(uint64_t); // 2的幂
+        auto v = makeArray<Alloc>(n);
+        st.counter("anon_huge_mb", anonHugeMB());
+        const size_t reads = 1 << 22;
+        const uint64_t* a = v.data();
+        uint64_t idx = 1;
+        for (auto _ : st) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < reads; i++) {
+                idx = (idx * 6364136223846793005ull + 1442695040888963407ull);
+                sum += a[(idx >> 20) & (n - 1)];
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * reads));
+    }
+
+    // 按页跨步读：每次访问一个新页，数据量很小但TLB表项很快被用完
+    template <class Alloc>
+    void pageStride(state& st) {
+        size_t n = size_t(st.arg(0)) * 1024 * 1024 / sizeof(uint64_t);
+        auto v = makeArray<Alloc>(n);
+        const size_t stride = 4096 / sizeof(uint64_t) + 8; // 每次跨过一页多一条缓存行，避开缓存组冲突
+        const uint64_t* a = v.data();
+        for (auto _ : st) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < n; i += stride) {
+                sum += a[i];
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * (n / stride)));
+    }
+
+    // arena：很多小vector逐个分配后整体释放，与std::allocator对比
+    template <bool Arena>
+    void smallVectors(state& st) {
+        size_t count = st.arg(0);
+        for (auto _ : st) {
+            if constexpr (Arena) {
+                my::arena a;
+                for (size_t i = 0; i < count; i++) {
+                    my::vector<int, my::arena_allocator<int>> v{my::arena_allocator<int>(a)};
+                    for (int k = 0; k < 16; k++) {
+                        v.push_back(k);
+                    }
+                    do_not_optimize(v.data());
+                }
+            } else {
+                for (size_t i = 0; i < count; i++) {
+                    my::vector<int> v;
+                    for (int k = 0; k < 16; k++) {
+                        v.push_back(k);
+                    }
+                    do_not_optimize(v.data());
+                }
+            }
+        }
+        st.set_items_processed(double(st.iterations() * count));
+    }
+
+#define MY_SIZES_MB ->arg_names({"mb"})->range({64, 512, 2048})
+
+    MY_BENCHMARK("allocator/random_read/std", randomRead<std::allocator<uint64_t>>) MY_SIZES_MB;
+    MY_BENCHMARK("allocator/random_read/huge_page", randomRead<my::huge_page_allocator<uint64_t>>) MY_SIZES_MB;
+    MY_BENCHMARK("allocator/page_stride/std", pageStride<std::allocator<uint64_t>>) MY_SIZES_MB;
+    MY_BENCHMARK("allocator/page_stride/huge_page", pageStride<my::huge_page_allocator<uint64_t>>) MY_SIZES_MB;
+    MY_BENCHMARK("allocator/small_vectors/std", smallVectors<false>)->arg_names({"count"})->arg(10000);
+    MY_BENCHMARK("allocator/small_vectors/arena", smallVectors<true>)->arg_names({"count"})->arg(10000);
+
+#undef MY_SIZES_MB
+}
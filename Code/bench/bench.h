@@ -0,0 +1,227 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * 基准测试框架
+ * 每个基准是一个接收state的函数，被测代码写在 for (auto _ : st) 循环里，循环之前的准备工作不计时：
+ *
+ *     static void pushBack(my::bench::state& st) {
+ *         size_t n = st.arg(0);
+ *         for (auto _ : st) {
+ *             my::vector<int> v;
+ *             for (size_t i = 0; i < n; i++) v.push_back(int(i));
+ *             my::bench::do_not_optimize(v.data());
+ *         }
+ *         st.set_items_processed(st.iterations() * n);
+ *     }
+ *     MY_BENCHMARK("vector/push_back<int>/my", pushBack)->arg_names({"n"})->range({1024, 65536});
+ *
+ * 框架自动增加迭代次数，直到一次测量至少持续--min-time秒，重复--repetitions次取中位数；
+ * 结果打印成表格，并可用--json输出为JSON（与Google Benchmark的格式兼容），交给compare.py比较两次结果。
+ * 基准按"模块/操作<元素类型>/实现"命名，参数依次追加在后面，如"vector/push_back<int>/my/n:1024"。
+ */
+namespace my::bench {
+    // 阻止编译器把结果没有被使用的计算优化掉
+    template <class T>
+    inline void do_not_optimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // 阻止编译器把内存读写移出或合并出计时区间
+    inline void clobber_memory() {
+        asm volatile("" : : : "memory");
+    }
+
+    // 进程所有线程累计的CPU时间（秒）
+    inline double cpu_seconds() {
+        timespec ts;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return double(ts.tv_sec) + double(ts.tv_nsec) * 1e-9;
+    }
+
+    // 读取/proc/self/status中的一项（单位KB），不支持时返回0
+    inline size_t _proc_status_kb(const char* key) {
+        FILE* f = std::fopen("/proc/self/status", "r");
+        if (!f) {
+            return 0;
+        }
+        char line[256];
+        size_t kb = 0;
+        size_t len = std::strlen(key);
+        while (std::fgets(line, sizeof(line), f)) {
+            if (std::strncmp(line, key, len) == 0 && line[len] == ':') {
+                kb = std::strtoull(line + len + 1, nullptr, 10);
+                break;
+            }
+        }
+        std::fclose(f);
+        return kb;
+    }
+
+    // 当前常驻内存和峰值常驻内存（字节）
+    inline size_t current_rss() { return _proc_status_kb("VmRSS") * 1024; }
+    inline size_t peak_rss() { return _proc_status_kb("VmHWM") * 1024; }
+
+    // 把峰值常驻内存重置为当前值（Linux 4.0起支持），之后的peak_rss()只反映重置之后的峰值
+    inline bool reset_peak_rss() {
+        FILE* f = std::fopen("/proc/self/clear_refs", "w");
+        if (!f) {
+            return false;
+        }
+        bool ok = std::fputs("5", f) >= 0;
+        return std::fclose(f) == 0 && ok;
+    }
+
+    // 把延迟样本排序后取分位数（p取0~1）
+    inline double percentile(std::vector<double>& samples, double p) {
+        if (samples.empty()) {
+            return 0;
+        }
+        size_t k = std::min(samples.size() - 1, size_t(p * double(samples.size())));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return samples[k];
+    }
+
+    class state;
+
+    // for (auto _ : st) 中_的类型，不携带数据；unused属性让没有用到_的循环不产生警告
+    struct __attribute__((unused)) _iteration_value {};
+
+    // for (auto _ : st) 使用的迭代器，最后一次比较时停止计时
+    struct _state_iterator {
+        state* _st;
+        size_t _left;
+
+        _iteration_value operator*() const { return {}; }
+        _state_iterator& operator++() { --_left; return *this; }
+        bool operator!=(const _state_iterator&);
+    };
+
+    /**
+     * 一次测量的状态：参数、迭代次数、计时和输出的指标
+     * 需要每次迭代都重新准备数据时，用pause_timing/resume_timing把准备工作排除在计时之外
+     */
+    class state {
+    public:
+        state(const std::vector<long>& args, size_t iterations) : _args(args), _iterations(iterations) {}
+
+        long arg(size_t i) const { return _args.at(i); }
+        size_t iterations() const { return _iterations; }
+
+        _state_iterator begin() { start(); return {this, _iterations}; }
+        _state_iterator end() { return {this, 0}; }
+
+        void pause_timing() { stop(); }
+        void resume_timing() { start(); }
+
+        // 每秒处理的元素个数/字节数由总量除以计时得到
+        void set_items_processed(double n) { _items = n; }
+        void set_bytes_processed(double n) { _bytes = n; }
+        // 自定义指标，如p99延迟、排名误差、峰值内存，重复测量时取中位数
+        void counter(const std::string& name, double value) {
+            for (auto& c : _counters) {
+                if (c.first == name) {
+                    c.second = value;
+                    return;
+                }
+            }
+            _counters.emplace_back(name, value);
+        }
+        void set_label(std::string label) { _label = std::move(label); }
+        // 当前环境不能运行（如CPU不支持AVX-512），不计入结果
+        void skip(std::string reason) { _skipped = std::move(reason); }
+
+    private:
+        friend struct _state_iterator;
+        friend class runner;
+
+        void start() {
+            if (!_running) {
+                _running = true;
+                _t0 = std::chrono::steady_clock::now();
+                _c0 = cpu_seconds();
+            }
+        }
+        void stop() {
+            if (_running) {
+                _running = false;
+                _real += std::chrono::duration<double>(std::chrono::steady_clock::now() - _t0).count();
+                _cpu += cpu_seconds() - _c0;
+            }
+        }
+
+        std::vector<long> _args;
+        size_t _iterations;
+        bool _running = false;
+        std::chrono::steady_clock::time_point _t0;
+        double _c0 = 0;
+        double _real = 0; // 累计计时（秒）
+        double _cpu = 0;
+        double _items = 0;
+        double _bytes = 0;
+        std::vector<std::pair<std::string, double>> _counters;
+        std::string _label;
+        std::string _skipped;
+    };
+
+    inline bool _state_iterator::operator!=(const _state_iterator&) {
+        if (_left != 0) {
+            return true;
+        }
+        _st->stop();
+        return false;
+    }
+
+    // 一个基准及其所有参数组合
+    struct benchmark {
+        std::string _name;
+        std::function<void(state&)> _fn;
+        std::vector<std::string> _argNames;
+        std::vector<std::vector<long>> _argSets;
+        size_t _iterations = 0; // 0表示自动决定
+
+        benchmark* arg(long a) { _argSets.push_back({a}); return this; }
+        benchmark* args(std::vector<long> a) { _argSets.push_back(std::move(a)); return this; }
+        benchmark* range(std::initializer_list<long> list) {
+            for (long a : list) {
+                arg(a);
+            }
+            return this;
+        }
+        benchmark* arg_names(std::vector<std::string> names) { _argNames = std::move(names); return this; }
+        benchmark* iterations(size_t n) { _iterations = n; return this; } // 固定迭代次数，用于一次就要几秒的基准
+    };
+
+    inline std::vector<std::unique_ptr<benchmark>>& _registry() {
+        static std::vector<std::unique_ptr<benchmark>> r;
+        return r;
+    }
+
+    // 注册一个基准，返回值用于继续设置参数
+    inline benchmark* add(std::string name, std::function<void(state&)> fn) {
+        _registry().push_back(std::make_unique<benchmark>());
+        benchmark* b = _registry().back().get();
+        b->_name = std::move(name);
+        b->_fn = std::move(fn);
+        return b;
+    }
+
+    // 解析命令行、运行所有匹配的基准并输出结果，定义在main.cpp中
+    int run_main(int argc, char** argv);
+}
+
+#define MY_BENCH_CONCAT2(a, b) a##b
+#define MY_BENCH_CONCAT(a, b) MY_BENCH_CONCAT2(a, b)
+#define MY_BENCHMARK(name, ...) \
+    [[maybe_unused]] static ::my::bench::benchmark* MY_BENCH_CONCAT(_my_bench_, __COUNTER__) = ::my::bench::add(name, __VA_ARGS__)
@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <map>
+#include "bench.h"
+#include "btree/btree.h"
+
+/**
+ * B+树：1e6~1e8个元素时随机插入、随机查找和范围扫描的吞吐量，对照组是std::map
+ * 插入测试的键由序号经可逆的混合函数得到，互不相同且不需要额外保存一个键数组；
+ * 查找和扫描测试按升序插入偶数键建树，建树是O(n log n)的顺序访问，1e8个元素也只要十几秒；
+ * std::map每个元素一个结点，1e8个元素需要五六GB内存，只测到1e7
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    // splitmix64的混合步骤，是2^64上的双射
+    uint64_t keyOf(uint64_t i) {
+        i ^= i >> 30;
+        i *= 0xbf58476d1ce4e5b9ull;
+        i ^= i >> 27;
+        i *= 0x94d049bb133111ebull;
+        i ^= i >> 31;
+        return i;
+    }
+
+    // 按升序插入键0, 2, 4, ...，值为序号
+    template <class Map>
+    void fillSorted(Map& m, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            m.insert(std::make_pair(uint64_t(2 * i), uint64_t(i)));
+        }
+    }
+
+    // 从空容器开始随机插入n个元素，析构不计时
+    template <class Map>
+    void insertRandom(state& st) {
+        size_t n = st.arg(0);
+        for (auto _ : st) {
+            Map m;
+            for (size_t i = 0; i < n; i++) {
+                m.insert(std::make_pair(keyOf(i), uint64_t(i)));
+            }
+            st.pause_timing();
+            m.clear();
+            st.resume_timing();
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // 随机查找已存在的键，每次迭代查找lookups次
+    template <class Map>
+    void findRandom(state& st) {
+        size_t n = st.arg(0);
+        Map m;
+        fillSorted(m, n);
+        const size_t lookups = 1 << 20;
+        uint64_t idx = 1;
+        for (auto _ : st) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < lookups; i++) {
+                idx = idx * 6364136223846793005ull + 1442695040888963407ull;
+                sum += m.find(2 * ((idx >> 16) % n))->second;
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * lookups));
+    }
+
+    // 从随机位置lower_bound后顺序扫描span个元素，B+树沿叶子链表走，std::map逐个结点跳
+    template <class Map>
+    void scanRange(state& st) {
+        size_t n = st.arg(0);
+        Map m;
+        fillSorted(m, n);
+        const size_t scans = 1 << 10, span = 1000;
+        uint64_t idx = 1;
+        size_t visited = 0;
+        for (auto _ : st) {
+            uint64_t sum = 0;
+            for (size_t i = 0; i < scans; i++) {
+                idx = idx * 6364136223846793005ull + 1442695040888963407ull;
+                auto it = m.lower_bound((idx >> 16) % (2 * n));
+                for (size_t k = 0; k < span && it != m.end(); ++k, ++it) {
+                    sum += it->second;
+                    ++visited;
+                }
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(visited));
+    }
+
+    typedef my::btree_map<uint64_t, uint64_t> btree_u64;
+    typedef std::map<uint64_t, uint64_t> map_u64;
+
+    // 一次建树就要几秒到一分钟，固定迭代次数，避免框架为了凑够测量时间反复建树
+#define MY_SIZES_BTREE ->arg_names({"n"})->range({1000000, 10000000, 100000000})->iterations(1)
+#define MY_SIZES_MAP ->arg_names({"n"})->range({1000000, 10000000})->iterations(1)
+
+    MY_BENCHMARK("btree/insert_random<u64>/btree", insertRandom<btree_u64>) MY_SIZES_BTREE;
+    MY_BENCHMARK("btree/insert_random<u64>/std_map", insertRandom<map_u64>) MY_SIZES_MAP;
+    MY_BENCHMARK("btree/find_random<u64>/btree", findRandom<btree_u64>) MY_SIZES_BTREE;
+    MY_BENCHMARK("btree/find_random<u64>/std_map", findRandom<map_u64>) MY_SIZES_MAP;
+    MY_BENCHMARK("btree/scan_range<u64>/btree", scanRange<btree_u64>) MY_SIZES_BTREE;
+    MY_BENCHMARK("btree/scan_range<u64>/std_map", scanRange<map_u64>) MY_SIZES_MAP;
+
+#undef MY_SIZES_BTREE
+#undef MY_SIZES_MAP
+}
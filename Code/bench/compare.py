@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""
+比较两次my_bench的JSON结果，作为性能回归的门禁
+
+    compare.py baseline.json current.json [--threshold 0.05] [--metric real_time] [--filter REGEX]
+        按名字配对，逐项打印变化；任何一项变差超过阈值时以状态码1退出，没有回归时为0。
+        时间类指标（real_time、cpu_time、*_ns、*_us、*_ms）越小越好，其余（items_per_second等）越大越好，
+        可以用 --lower-is-better / --higher-is-better 覆盖自定义指标的方向。
+
+    compare.py --versus my std current.json
+        同一次结果中，把名字里的"/my"换成"/std"后配对，打印my::与std::的耗时比值，只用于查看，不判定回归。
+
+也能读取Google Benchmark输出的JSON：重复测量时优先使用median聚合结果。
+"""
+
+import argparse
+import json
+import re
+import sys
+
+TIME_METRICS = ("real_time", "real_time_min", "real_time_max", "cpu_time")
+TIME_SUFFIXES = ("_ns", "_us", "_ms", "_s", "_time")
+
+
+def load(path, metric):
+    """读取结果文件，返回 {名字: 指标值}"""
+    with open(path) as f:
+        data = json.load(f)
+    entries = data.get("benchmarks", [])
+    has_median = any(e.get("aggregate_name") == "median" for e in entries)
+    values = {}
+    for e in entries:
+        if e.get("error_occurred"):
+            continue
+        if has_median and e.get("aggregate_name") not in ("median", None):
+            continue
+        if has_median and e.get("run_type") == "iteration":
+            continue
+        name = e.get("run_name", e["name"]) if e.get("aggregate_name") else e["name"]
+        if metric in e:
+            values[name] = float(e[metric])
+    return data.get("context", {}), values
+
+
+def lower_is_better(metric, args):
+    if args.lower_is_better:
+        return True
+    if args.higher_is_better:
+        return False
+    return metric in TIME_METRICS or metric.endswith(TIME_SUFFIXES)
+
+
+def fmt(v):
+    if v == 0:
+        return "0"
+    if abs(v) >= 1e5 or abs(v) < 1e-2:
+        return "%.3e" % v
+    return "%.3f" % v
+
+
+def compare(args):
+    ctx_a, base = load(args.files[0], args.metric)
+    ctx_b, cur = load(args.files[1], args.metric)
+    for key in ("cpu_model", "num_cpus", "library_build_type", "hardening_level"):
+        if key in ctx_a and key in ctx_b and ctx_a[key] != ctx_b[key]:
+            print("warning: %s differs: %r vs %r" % (key, ctx_a[key], ctx_b[key]))
+    pattern = re.compile(args.filter) if args.filter else None
+    lower = lower_is_better(args.metric, args)
+    regressions = []
+    width = max([len(n) for n in base] + [9])
+    print("%-*s %14s %14s %9s" % (width, "benchmark", "baseline", "current", "change"))
+    for name in sorted(base):
+        if pattern and not pattern.search(name):
+            continue
+        if name not in cur:
+            print("%-*s %14s %14s %9s" % (width, name, fmt(base[name]), "missing", ""))
+            continue
+        a, b = base[name], cur[name]
+        change = (b - a) / a if a else 0.0
+        worse = change > args.threshold if lower else change < -args.threshold
+        mark = "  REGRESSION" if worse else ""
+        print("%-*s %14s %14s %+8.1f%%%s" % (width, name, fmt(a), fmt(b), change * 100, mark))
+        if worse:
+            regressions.append(name)
+    for name in sorted(set(cur) - set(base)):
+        if not pattern or pattern.search(name):
+            print("%-*s %14s %14s %9s" % (width, name, "new", fmt(cur[name]), ""))
+    if regressions:
+        print("\n%d regression(s) beyond %.1f%% on %s" % (len(regressions), args.threshold * 100, args.metric))
+        return 1
+    print("\nno regressions beyond %.1f%% on %s" % (args.threshold * 100, args.metric))
+    return 0
+
+
+def versus(args):
+    mine, theirs = args.versus
+    _, values = load(args.files[0], args.metric)
+    lower = lower_is_better(args.metric, args)
+    pattern = re.compile(args.filter) if args.filter else None
+    rows = []
+    for name in sorted(values):
+        parts = name.split("/")
+        if mine not in parts:
+            continue
+        other = "/".join(theirs if p == mine else p for p in parts)
+        if other in values and (not pattern or pattern.search(name)):
+            a, b = values[name], values[other]
+            ratio = a / b if lower else b / a
+            rows.append((name, a, b, ratio))
+    if not rows:
+        print("no %s/%s pairs found" % (mine, theirs))
+        return 0
+    width = max(len(r[0]) for r in rows)
+    print("%-*s %14s %14s %9s" % (width, "benchmark", mine, theirs, "ratio"))
+    for name, a, b, ratio in rows:
+        print("%-*s %14s %14s %8.2fx" % (width, name, fmt(a), fmt(b), ratio))
+    print("\nratio = %s cost / %s cost (below 1 means %s is faster)" % (mine, theirs, mine))
+    return 0
+
+
+def main():
+    p = argparse.ArgumentParser(description="Compare my_bench JSON results.")
+    p.add_argument("files", nargs="+", help="baseline.json current.json, or one file with --versus")
+    p.add_argument("--metric", default="real_time", help="field to compare (default real_time)")
+    p.add_argument("--threshold", type=float, default=0.05, help="allowed relative slowdown (default 0.05)")
+    p.add_argument("--filter", help="only compare benchmarks whose name matches this regex")
+    p.add_argument("--versus", nargs=2, metavar=("MINE", "THEIRS"), help="pair MINE/THEIRS name components in one file")
+    direction = p.add_mutually_exclusive_group()
+    direction.add_argument("--lower-is-better", action="store_true")
+    direction.add_argument("--higher-is-better", action="store_true")
+    args = p.parse_args()
+    if args.versus:
+        if len(args.files) != 1:
+            p.error("--versus takes exactly one result file")
+        return versus(args)
+    if len(args.files) != 2:
+        p.error("expected baseline.json and current.json")
+    return compare(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,147 @@
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "concurrent_priority_queue/concurrent_priority_queue.h"
+#include "priority_queue/priority_queue.h"
+
+/**
+ * 并发优先队列：不同线程数下的吞吐量与排名误差
+ * 对照组是一把std::mutex保护的my::priority_queue，所有push/pop串行执行
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    const size_t Prefill = 100000; // 开始计时前队列中的元素个数，保持堆的深度稳定
+    const size_t OpsPerIteration = 200000; // 每次迭代所有线程合计的push+pop次数
+
+    // 一把锁保护的优先队列，接口与concurrent_priority_queue一致
+    struct locked_priority_queue {
+        explicit locked_priority_queue(size_t) {}
+        void push(const long& x) {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _pq.push(x);
+        }
+        bool try_pop(long& out) {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if (_pq.empty()) {
+                return false;
+            }
+            out = _pq.top();
+            _pq.pop();
+            return true;
+        }
+
+        std::mutex _mtx;
+        my::priority_queue<long> _pq;
+    };
+
+    // 每个线程交替push一个随机键、pop一个元素，队列大小基本不变
+    template <class Q>
+    void pushPop(state& st) {
+        size_t threads = st.arg(0);
+        Q q(threads);
+        std::mt19937_64 rng(1);
+        for (size_t i = 0; i < Prefill; i++) {
+            q.push(long(rng() >> 1));
+        }
+        size_t perThread = OpsPerIteration / 2 / threads;
+        for (auto _ : st) {
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; t++) {
+                workers.emplace_back([&q, perThread, t] {
+                    std::minstd_rand r(unsigned(t + 1));
+                    long x = 0;
+                    for (size_t i = 0; i < perThread; i++) {
+                        q.push(long(r()));
+                        q.try_pop(x);
+                    }
+                    do_not_optimize(x);
+                });
+            }
+            for (auto& w : workers) {
+                w.join();
+            }
+        }
+        st.set_items_processed(double(st.iterations() * perThread * threads * 2));
+    }
+
+    // 树状数组，统计还在队列中、比某个键更优（更大）的元素个数
+    struct fenwick {
+        explicit fenwick(size_t n) : _tree(n + 1, 0) {}
+        void add(size_t i, int v) {
+            for (i++; i < _tree.size(); i += i & -i) {
+                _tree[i] += v;
+            }
+        }
+        long prefix(size_t i) const { // [0, i)之和
+            long s = 0;
+            for (; i > 0; i -= i & -i) {
+                s += _tree[i];
+            }
+            return s;
+        }
+        std::vector<int> _tree;
+    };
+
+    /**
+     * 排名误差：队列中放入0~n-1（大堆，n-1最优），多个线程并发弹空
+     * 每次弹出后立即从全局计数器领取序号，按序号回放弹出顺序；
+     * 弹出键k时，还在队列中且比k大的元素个数就是这次的排名误差（严格有序的队列恒为0）
+     */
+    void rankError(state& st) {
+        size_t threads = st.arg(0);
+        const size_t n = 100000;
+        double meanError = 0, maxError = 0;
+        for (auto _ : st) {
+            my::concurrent_priority_queue<long> q(threads);
+            for (size_t i = 0; i < n; i++) {
+                q.push(long(i));
+            }
+            std::vector<long> order(n, -1);
+            std::atomic<size_t> seq{0};
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; t++) {
+                workers.emplace_back([&] {
+                    long x;
+                    while (q.try_pop(x)) {
+                        order[seq.fetch_add(1, std::memory_order_relaxed)] = x;
+                    }
+                });
+            }
+            for (auto& w : workers) {
+                w.join();
+            }
+            st.pause_timing();
+            fenwick remaining(n);
+            for (size_t i = 0; i < n; i++) {
+                remaining.add(i, 1);
+            }
+            double sum = 0;
+            size_t popped = seq.load();
+            for (size_t i = 0; i < popped; i++) {
+                size_t k = size_t(order[i]);
+                long better = remaining.prefix(n) - remaining.prefix(k + 1);
+                sum += double(better);
+                maxError = std::max(maxError, double(better));
+                remaining.add(k, -1);
+            }
+            meanError = popped ? sum / double(popped) : 0;
+            st.resume_timing();
+        }
+        st.counter("mean_rank_error", meanError);
+        st.counter("max_rank_error", maxError);
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+#define MY_THREADS ->arg_names({"threads"})->range({1, 2, 4, 8})
+
+    MY_BENCHMARK("concurrent_priority_queue/push_pop/multiqueue", pushPop<my::concurrent_priority_queue<long>>) MY_THREADS;
+    MY_BENCHMARK("concurrent_priority_queue/push_pop/mutex", pushPop<locked_priority_queue>) MY_THREADS;
+    MY_BENCHMARK("concurrent_priority_queue/rank_error/multiqueue", rankError) MY_THREADS;
+
+#undef MY_THREADS
+}
@@ -0,0 +1,101 @@
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "concurrent_stack/concurrent_stack.h"
+#include "stack/stack.h"
+
+/**
+ * 无锁栈：1、2、4、8个线程同时push/pop时的吞吐量
+ * 对照组是一把std::mutex保护的my::stack，所有操作串行执行
+ * push_pop每个线程交替push、pop，竞争集中在栈顶，也最容易在消除数组上配对；
+ * burst每个线程先连续push一批再全部pop，栈的深度随线程数增长
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    const size_t OpsPerIteration = 200000; // 每次迭代所有线程合计的push+pop次数
+    const size_t Burst = 64; // burst中每个线程一批的元素个数
+
+    // 一把锁保护的栈，接口与concurrent_stack一致
+    struct locked_stack {
+        void push(const long& x) {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _s.push(x);
+        }
+        bool try_pop(long& out) {
+            std::lock_guard<std::mutex> lock(_mtx);
+            if (_s.empty()) {
+                return false;
+            }
+            out = _s.top();
+            _s.pop();
+            return true;
+        }
+
+        std::mutex _mtx;
+        my::stack<long> _s;
+    };
+
+    // 启动threads个线程各执行一次body(线程编号)，全部结束后返回
+    template <class F>
+    void runThreads(size_t threads, F body) {
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back(body, t);
+        }
+        for (auto& w : workers) {
+            w.join();
+        }
+    }
+
+    template <class S>
+    void pushPop(state& st) {
+        size_t threads = st.arg(0);
+        S s;
+        size_t perThread = OpsPerIteration / 2 / threads;
+        for (auto _ : st) {
+            runThreads(threads, [&s, perThread](size_t t) {
+                long x = 0;
+                for (size_t i = 0; i < perThread; i++) {
+                    s.push(long(t * perThread + i));
+                    s.try_pop(x);
+                }
+                do_not_optimize(x);
+            });
+        }
+        st.set_items_processed(double(st.iterations() * perThread * threads * 2));
+    }
+
+    template <class S>
+    void burst(state& st) {
+        size_t threads = st.arg(0);
+        S s;
+        size_t rounds = OpsPerIteration / 2 / threads / Burst;
+        for (auto _ : st) {
+            runThreads(threads, [&s, rounds](size_t t) {
+                long x = 0;
+                for (size_t r = 0; r < rounds; r++) {
+                    for (size_t i = 0; i < Burst; i++) {
+                        s.push(long(t * Burst + i));
+                    }
+                    for (size_t i = 0; i < Burst; i++) {
+                        s.try_pop(x);
+                    }
+                }
+                do_not_optimize(x);
+            });
+        }
+        st.set_items_processed(double(st.iterations() * rounds * Burst * threads * 2));
+    }
+
+#define MY_THREADS ->arg_names({"threads"})->range({1, 2, 4, 8})
+
+    MY_BENCHMARK("concurrent_stack/push_pop<long>/lock_free", pushPop<my::concurrent_stack<long>>) MY_THREADS;
+    MY_BENCHMARK("concurrent_stack/push_pop<long>/mutex", pushPop<locked_stack>) MY_THREADS;
+    MY_BENCHMARK("concurrent_stack/burst<long>/lock_free", burst<my::concurrent_stack<long>>) MY_THREADS;
+    MY_BENCHMARK("concurrent_stack/burst<long>/mutex", burst<locked_stack>) MY_THREADS;
+
+#undef MY_THREADS
+}
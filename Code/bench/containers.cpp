@@ -0,0 +1,290 @@
+#include <list>
+#include <queue>
+#include <stack>
+#include <string>
+#include <vector>
+#include "bench.h"
+#include "list/list.h"
+#include "priority_queue/priority_queue.h"
+#include "queue/queue.h"
+#include "stack/stack.h"
+#include "string/string.h"
+#include "vector/vector.h"
+
+/**
+ * 基础容器与std::对应容器的对比：string、vector、list、priority_queue、queue、stack
+ * 元素类型取int（平凡拷贝）和std::string（32个字符，超出短字符串优化，拷贝要申请内存）
+ * 每个基准的items_per_second按处理的元素个数计算
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    template <class T>
+    T makeValue(size_t i);
+
+    template <>
+    int makeValue<int>(size_t i) { return int(i * 2654435761u); }
+
+    template <>
+    std::string makeValue<std::string>(size_t i) {
+        std::string s(32, 'a');
+        for (size_t k = 0; k < 8; k++) {
+            s[k] = char('a' + (i >> (k * 3)) % 26);
+        }
+        return s;
+    }
+
+    // vector：逐个尾插（包含扩容）
+    template <class V>
+    void vectorPushBack(state& st) {
+        typedef std::remove_cvref_t<decltype(*V().begin())> T;
+        size_t n = st.arg(0);
+        std::vector<T> src;
+        for (size_t i = 0; i < n; i++) {
+            src.push_back(makeValue<T>(i));
+        }
+        for (auto _ : st) {
+            V v;
+            for (size_t i = 0; i < n; i++) {
+                v.push_back(src[i]);
+            }
+            do_not_optimize(v);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // vector：拷贝构造
+    template <class V>
+    void vectorCopy(state& st) {
+        typedef std::remove_cvref_t<decltype(*V().begin())> T;
+        size_t n = st.arg(0);
+        V v;
+        for (size_t i = 0; i < n; i++) {
+            v.push_back(makeValue<T>(i));
+        }
+        for (auto _ : st) {
+            V copy(v);
+            do_not_optimize(copy);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // vector：下标遍历求和
+    template <class V>
+    void vectorIndexSum(state& st) {
+        size_t n = st.arg(0);
+        V v;
+        for (size_t i = 0; i < n; i++) {
+            v.push_back(makeValue<int>(i));
+        }
+        for (auto _ : st) {
+            long long sum = 0;
+            for (size_t i = 0; i < v.size(); i++) {
+                sum += v[i];
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // list：逐个尾插后整体析构
+    template <class L>
+    void listPushBack(state& st) {
+        typedef std::remove_cvref_t<decltype(*L().begin())> T;
+        size_t n = st.arg(0);
+        T x = makeValue<T>(1);
+        for (auto _ : st) {
+            L l;
+            for (size_t i = 0; i < n; i++) {
+                l.push_back(x);
+            }
+            do_not_optimize(l);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // list：顺序遍历，结点分散在堆上，主要测量指针追逐
+    template <class L>
+    void listIterate(state& st) {
+        typedef std::remove_cvref_t<decltype(*L().begin())> T;
+        size_t n = st.arg(0);
+        L l;
+        for (size_t i = 0; i < n; i++) {
+            l.push_back(makeValue<T>(i));
+        }
+        for (auto _ : st) {
+            size_t count = 0;
+            for (auto it = l.begin(); it != l.end(); ++it) {
+                do_not_optimize(*it);
+                count++;
+            }
+            do_not_optimize(count);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // priority_queue：插入n个元素后全部弹出
+    template <class PQ, class T>
+    void pqPushPop(state& st) {
+        size_t n = st.arg(0);
+        std::vector<T> src;
+        for (size_t i = 0; i < n; i++) {
+            src.push_back(makeValue<T>(i));
+        }
+        for (auto _ : st) {
+            PQ pq;
+            for (size_t i = 0; i < n; i++) {
+                pq.push(src[i]);
+            }
+            while (!pq.empty()) {
+                do_not_optimize(pq.top());
+                pq.pop();
+            }
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // queue/stack：插入n个元素后全部弹出，Front取队头或栈顶
+    template <class Q, class T, bool Front>
+    void adapterPushPop(state& st) {
+        size_t n = st.arg(0);
+        T x = makeValue<T>(7);
+        for (auto _ : st) {
+            Q q;
+            for (size_t i = 0; i < n; i++) {
+                q.push(x);
+            }
+            while (!q.empty()) {
+                if constexpr (Front) {
+                    do_not_optimize(q.front());
+                } else {
+                    do_not_optimize(q.top());
+                }
+                q.pop();
+            }
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // string：逐个字符追加
+    template <class S>
+    void stringPushBack(state& st) {
+        size_t n = st.arg(0);
+        for (auto _ : st) {
+            S s;
+            for (size_t i = 0; i < n; i++) {
+                s.push_back(char('a' + i % 26));
+            }
+            do_not_optimize(s);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // string：以16字节为一段追加
+    template <class S>
+    void stringAppend(state& st) {
+        size_t n = st.arg(0);
+        const char* piece = "0123456789abcdef";
+        for (auto _ : st) {
+            S s;
+            for (size_t i = 0; i < n; i += 16) {
+                s.append(piece, 16);
+            }
+            do_not_optimize(s);
+        }
+        st.set_bytes_processed(double(st.iterations() * n));
+    }
+
+    // string：拷贝构造
+    template <class S>
+    void stringCopy(state& st) {
+        size_t n = st.arg(0);
+        S s;
+        for (size_t i = 0; i < n; i++) {
+            s.push_back(char('a' + i % 26));
+        }
+        for (auto _ : st) {
+            S copy(s);
+            do_not_optimize(copy);
+        }
+        st.set_bytes_processed(double(st.iterations() * n));
+    }
+
+    // string：查找只出现在末尾的子串
+    template <class S>
+    void stringFind(state& st) {
+        size_t n = st.arg(0);
+        S s;
+        for (size_t i = 0; i + 4 < n; i++) {
+            s.push_back(char('a' + i % 26));
+        }
+        s.append("XYZ!", 4);
+        for (auto _ : st) {
+            do_not_optimize(s.find("XYZ!"));
+        }
+        st.set_bytes_processed(double(st.iterations() * n));
+    }
+
+    // string：比较两个只有最后一个字符不同的字符串
+    template <class S>
+    void stringCompare(state& st) {
+        size_t n = st.arg(0);
+        S a, b;
+        for (size_t i = 0; i < n; i++) {
+            a.push_back(char('a' + i % 26));
+            b.push_back(i + 1 == n ? 'Z' : char('a' + i % 26));
+        }
+        for (auto _ : st) {
+            do_not_optimize(a < b);
+        }
+        st.set_bytes_processed(double(st.iterations() * n));
+    }
+
+#define MY_SIZES ->arg_names({"n"})->range({64, 4096, 262144})
+
+    MY_BENCHMARK("vector/push_back<int>/my", vectorPushBack<my::vector<int>>) MY_SIZES;
+    MY_BENCHMARK("vector/push_back<int>/std", vectorPushBack<std::vector<int>>) MY_SIZES;
+    MY_BENCHMARK("vector/push_back<string>/my", vectorPushBack<my::vector<std::string>>) MY_SIZES;
+    MY_BENCHMARK("vector/push_back<string>/std", vectorPushBack<std::vector<std::string>>) MY_SIZES;
+    MY_BENCHMARK("vector/copy<int>/my", vectorCopy<my::vector<int>>) MY_SIZES;
+    MY_BENCHMARK("vector/copy<int>/std", vectorCopy<std::vector<int>>) MY_SIZES;
+    MY_BENCHMARK("vector/copy<string>/my", vectorCopy<my::vector<std::string>>) MY_SIZES;
+    MY_BENCHMARK("vector/copy<string>/std", vectorCopy<std::vector<std::string>>) MY_SIZES;
+    MY_BENCHMARK("vector/index_sum<int>/my", vectorIndexSum<my::vector<int>>) MY_SIZES;
+    MY_BENCHMARK("vector/index_sum<int>/std", vectorIndexSum<std::vector<int>>) MY_SIZES;
+
+    MY_BENCHMARK("list/push_back<int>/my", listPushBack<my::list<int>>) MY_SIZES;
+    MY_BENCHMARK("list/push_back<int>/std", listPushBack<std::list<int>>) MY_SIZES;
+    MY_BENCHMARK("list/push_back<string>/my", listPushBack<my::list<std::string>>) MY_SIZES;
+    MY_BENCHMARK("list/push_back<string>/std", listPushBack<std::list<std::string>>) MY_SIZES;
+    MY_BENCHMARK("list/iterate<int>/my", listIterate<my::list<int>>) MY_SIZES;
+    MY_BENCHMARK("list/iterate<int>/std", listIterate<std::list<int>>) MY_SIZES;
+
+    MY_BENCHMARK("priority_queue/push_pop<int>/my", pqPushPop<my::priority_queue<int>, int>) MY_SIZES;
+    MY_BENCHMARK("priority_queue/push_pop<int>/std", pqPushPop<std::priority_queue<int>, int>) MY_SIZES;
+    MY_BENCHMARK("priority_queue/push_pop<string>/my", pqPushPop<my::priority_queue<std::string>, std::string>) MY_SIZES;
+    MY_BENCHMARK("priority_queue/push_pop<string>/std", pqPushPop<std::priority_queue<std::string>, std::string>) MY_SIZES;
+
+    MY_BENCHMARK("queue/push_pop<int>/my", adapterPushPop<my::queue<int>, int, true>) MY_SIZES;
+    MY_BENCHMARK("queue/push_pop<int>/std", adapterPushPop<std::queue<int>, int, true>) MY_SIZES;
+    MY_BENCHMARK("queue/push_pop<string>/my", adapterPushPop<my::queue<std::string>, std::string, true>) MY_SIZES;
+    MY_BENCHMARK("queue/push_pop<string>/std", adapterPushPop<std::queue<std::string>, std::string, true>) MY_SIZES;
+    MY_BENCHMARK("stack/push_pop<int>/my", adapterPushPop<my::stack<int>, int, false>) MY_SIZES;
+    MY_BENCHMARK("stack/push_pop<int>/std", adapterPushPop<std::stack<int>, int, false>) MY_SIZES;
+    MY_BENCHMARK("stack/push_pop<string>/my", adapterPushPop<my::stack<std::string>, std::string, false>) MY_SIZES;
+    MY_BENCHMARK("stack/push_pop<string>/std", adapterPushPop<std::stack<std::string>, std::string, false>) MY_SIZES;
+
+    MY_BENCHMARK("string/push_back/my", stringPushBack<my::string>) MY_SIZES;
+    MY_BENCHMARK("string/push_back/std", stringPushBack<std::string>) MY_SIZES;
+    MY_BENCHMARK("string/append/my", stringAppend<my::string>) MY_SIZES;
+    MY_BENCHMARK("string/append/std", stringAppend<std::string>) MY_SIZES;
+    MY_BENCHMARK("string/copy/my", stringCopy<my::string>) MY_SIZES;
+    MY_BENCHMARK("string/copy/std", stringCopy<std::string>) MY_SIZES;
+    MY_BENCHMARK("string/find/my", stringFind<my::string>) MY_SIZES;
+    MY_BENCHMARK("string/find/std", stringFind<std::string>) MY_SIZES;
+    MY_BENCHMARK("string/compare/my", stringCompare<my::string>) MY_SIZES;
+    MY_BENCHMARK("string/compare/std", stringCompare<std::string>) MY_SIZES;
+
+#undef MY_SIZES
+}
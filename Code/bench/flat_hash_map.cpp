@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include "bench.h"
+#include "flat_hash_map/flat_hash_map.h"
+#include "vector/vector.h"
+
+/**
+ * 哈希表：开放寻址的flat_hash_map与链式的std::unordered_map
+ * n从1e3（全部在L1/L2中）到1e6（远超缓存），元素越多，每次查找的缓存未命中越能体现差距
+ * 查找命中与不命中分开测：不命中时flat_hash_map只比较控制字节，链式哈希表要走完整条链
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    // 随机打乱的键，避免按插入顺序访问带来的局部性
+    template <class K>
+    my::vector<K> makeKeys(size_t n, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        my::vector<K> keys;
+        keys.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            if constexpr (std::is_same_v<K, std::string>) {
+                keys.push_back("key:" + std::to_string(rng()));
+            } else {
+                keys.push_back(K(rng()));
+            }
+        }
+        return keys;
+    }
+
+    template <class Map, class K>
+    void insertBench(state& st) {
+        size_t n = st.arg(0);
+        auto keys = makeKeys<K>(n, 1);
+        for (auto _ : st) {
+            Map m;
+            for (size_t i = 0; i < n; i++) {
+                m[keys[i]] = i;
+            }
+            do_not_optimize(m.size());
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // hit为true时查找表中已有的键，否则查找另一组随机键（几乎全部不命中）
+    template <class Map, class K, bool hit>
+    void findBench(state& st) {
+        size_t n = st.arg(0);
+        auto keys = makeKeys<K>(n, 1);
+        auto probes = hit ? keys : makeKeys<K>(n, 2);
+        Map m;
+        for (size_t i = 0; i < n; i++) {
+            m[keys[i]] = i;
+        }
+        for (auto _ : st) {
+            size_t found = 0;
+            for (size_t i = 0; i < n; i++) {
+                found += m.find(probes[i]) != m.end();
+            }
+            do_not_optimize(found);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // 删除一半再插回，衡量删除（flat_hash_map为backward shift）的开销
+    template <class Map, class K>
+    void eraseBench(state& st) {
+        size_t n = st.arg(0);
+        auto keys = makeKeys<K>(n, 1);
+        Map m;
+        for (size_t i = 0; i < n; i++) {
+            m[keys[i]] = i;
+        }
+        for (auto _ : st) {
+            for (size_t i = 0; i < n; i += 2) {
+                m.erase(keys[i]);
+            }
+            for (size_t i = 0; i < n; i += 2) {
+                m[keys[i]] = i;
+            }
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    typedef my::flat_hash_map<uint64_t, size_t> my_u64;
+    typedef std::unordered_map<uint64_t, size_t> std_u64;
+    typedef my::flat_hash_map<std::string, size_t> my_str;
+    typedef std::unordered_map<std::string, size_t> std_str;
+
+#define MY_SIZES ->arg_names({"n"})->range({1000, 100000, 1000000})
+
+    MY_BENCHMARK("flat_hash_map/insert<uint64_t>/my", insertBench<my_u64, uint64_t>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/insert<uint64_t>/std", insertBench<std_u64, uint64_t>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/find_hit<uint64_t>/my", findBench<my_u64, uint64_t, true>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/find_hit<uint64_t>/std", findBench<std_u64, uint64_t, true>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/find_miss<uint64_t>/my", findBench<my_u64, uint64_t, false>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/find_miss<uint64_t>/std", findBench<std_u64, uint64_t, false>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/erase<uint64_t>/my", eraseBench<my_u64, uint64_t>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/erase<uint64_t>/std", eraseBench<std_u64, uint64_t>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/insert<string>/my", insertBench<my_str, std::string>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/insert<string>/std", insertBench<std_str, std::string>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/find_hit<string>/my", findBench<my_str, std::string, true>) MY_SIZES;
+    MY_BENCHMARK("flat_hash_map/find_hit<string>/std", findBench<std_str, std::string, true>) MY_SIZES;
+
+#undef MY_SIZES
+}
@@ -0,0 +1,5 @@
+// cheap等级下vector的开销，基准主体见hardening_levels.h
+#undef MY_HARDENING_LEVEL
+#define MY_HARDENING_LEVEL 1
+#define MY_HARDENING_BENCH_LEVEL "cheap"
+#include "hardening_levels.h"
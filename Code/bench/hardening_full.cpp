@@ -0,0 +1,5 @@
+// full等级下vector的开销，基准主体见hardening_levels.h
+#undef MY_HARDENING_LEVEL
+#define MY_HARDENING_LEVEL 2
+#define MY_HARDENING_BENCH_LEVEL "full"
+#include "hardening_levels.h"
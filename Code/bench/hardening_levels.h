@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <random>
+#include "bench.h"
+#include "vector/vector.h"
+
+/**
+ * 安全检查等级的开销：同一组vector基准在off、cheap、full三个等级下各编译一次
+ * 包含本文件之前需要定义MY_HARDENING_LEVEL和MY_HARDENING_BENCH_LEVEL（等级名，出现在基准名中），
+ * 见hardening_off.cpp、hardening_cheap.cpp、hardening_full.cpp。
+ * vector按等级放在不同的内联命名空间中，三个目标文件链接进同一个my_bench不会互相冲突
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    my::vector<int> shuffled(size_t n) {
+        my::vector<int> v;
+        std::mt19937 rng(1);
+        for (size_t i = 0; i < n; i++) {
+            v.push_back(int(rng()));
+        }
+        return v;
+    }
+
+    // operator[]：cheap起每次检查下标
+    void indexSum(state& st) {
+        size_t n = st.arg(0);
+        auto v = shuffled(n);
+        for (auto _ : st) {
+            long sum = 0;
+            for (size_t i = 0; i < n; i++) {
+                sum += v[i];
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // 迭代器遍历：full等级下每次解引用检查版本号和范围
+    void iteratorSum(state& st) {
+        size_t n = st.arg(0);
+        auto v = shuffled(n);
+        for (auto _ : st) {
+            long sum = 0;
+            for (auto it = v.begin(); it != v.end(); ++it) {
+                sum += *it;
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    void pushBack(state& st) {
+        size_t n = st.arg(0);
+        for (auto _ : st) {
+            my::vector<int> v;
+            for (size_t i = 0; i < n; i++) {
+                v.push_back(int(i));
+            }
+            do_not_optimize(v.data());
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // 通过迭代器交给std::sort，full等级下的检查迭代器会妨碍编译器优化
+    void sortIterators(state& st) {
+        size_t n = st.arg(0);
+        auto src = shuffled(n);
+        my::vector<int> v(src);
+        for (auto _ : st) {
+            st.pause_timing();
+            std::copy(src.data(), src.data() + n, v.data());
+            st.resume_timing();
+            std::sort(v.begin(), v.end());
+            do_not_optimize(v.data());
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+#define MY_SIZES ->arg_names({"n"})->range({4096, 1 << 20})
+
+    MY_BENCHMARK("hardening/index_sum<int>/" MY_HARDENING_BENCH_LEVEL, indexSum) MY_SIZES;
+    MY_BENCHMARK("hardening/iterator_sum<int>/" MY_HARDENING_BENCH_LEVEL, iteratorSum) MY_SIZES;
+    MY_BENCHMARK("hardening/push_back<int>/" MY_HARDENING_BENCH_LEVEL, pushBack) MY_SIZES;
+    MY_BENCHMARK("hardening/sort<int>/" MY_HARDENING_BENCH_LEVEL, sortIterators) MY_SIZES;
+
+#undef MY_SIZES
+}
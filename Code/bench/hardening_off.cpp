@@ -0,0 +1,5 @@
+// off等级下vector的开销，基准主体见hardening_levels.h
+#undef MY_HARDENING_LEVEL
+#define MY_HARDENING_LEVEL 0
+#define MY_HARDENING_BENCH_LEVEL "off"
+#include "hardening_levels.h"
@@ -0,0 +1,134 @@
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "bench.h"
+#include "iobuf/iobuf.h"
+#include "string/string.h"
+#include "vector/vector.h"
+
+/**
+ * iobuf：由frags个256字节片段组成的响应写入socket的吞吐量
+ * 片段各自属于不同的内存块（模拟缓存中的页面、头部和正文分别来自不同的地方），不会被合并
+ * 三种做法：iobuf共享片段后用writev一次写出多个片段；先拼接到一个my::string再write；每个片段单独write
+ * 写端是非阻塞的AF_UNIX socketpair，写满时在同一线程中把读端读空，三种做法读的代价相同
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    const size_t FragmentBytes = 256;
+
+    struct socket_sink {
+        socket_sink() {
+            socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, _fds);
+            fcntl(_fds[0], F_SETFL, O_NONBLOCK);
+            fcntl(_fds[1], F_SETFL, O_NONBLOCK);
+        }
+        ~socket_sink() {
+            ::close(_fds[0]);
+            ::close(_fds[1]);
+        }
+        int fd() const { return _fds[0]; }
+        void drain() {
+            char buf[65536];
+            while (::read(_fds[1], buf, sizeof(buf)) > 0) {}
+        }
+        // 写出[data, data+len)，写满时读空对端后继续
+        void writeAll(const char* data, size_t len) {
+            while (len > 0) {
+                ssize_t n = ::write(_fds[0], data, len);
+                if (n < 0) {
+                    drain();
+                    continue;
+                }
+                data += n;
+                len -= size_t(n);
+            }
+        }
+
+        int _fds[2];
+    };
+
+    // frags个片段，每个片段单独占一个内存块
+    my::vector<my::iobuf> makeFragments(size_t frags) {
+        my::vector<my::iobuf> v;
+        for (size_t i = 0; i < frags; i++) {
+            my::string s;
+            for (size_t k = 0; k < FragmentBytes; k++) {
+                s.push_back(char('a' + i % 26));
+            }
+            my::iobuf b;
+            b.append(std::move(s));
+            v.push_back(std::move(b));
+        }
+        return v;
+    }
+
+    // iobuf：追加片段只增加引用计数，write_to每次用writev写出至多64个片段
+    void writevIobuf(state& st) {
+        size_t frags = st.arg(0);
+        auto parts = makeFragments(frags);
+        socket_sink sink;
+        size_t calls = 0;
+        for (auto _ : st) {
+            my::iobuf resp;
+            for (const my::iobuf& p : parts) {
+                resp.append(p);
+            }
+            while (!resp.empty()) {
+                ++calls;
+                if (resp.write_to(sink.fd()) < 0) {
+                    sink.drain();
+                }
+            }
+        }
+        st.counter("syscalls_per_resp", double(calls) / double(st.iterations()));
+        st.set_bytes_processed(double(st.iterations() * frags * FragmentBytes));
+    }
+
+    // 拼接：每个片段拷贝进一个连续的字符串，再用write写出
+    void writeConcat(state& st) {
+        size_t frags = st.arg(0);
+        auto parts = makeFragments(frags);
+        my::vector<my::string> strs;
+        for (const my::iobuf& p : parts) {
+            strs.push_back(p.to_string());
+        }
+        socket_sink sink;
+        for (auto _ : st) {
+            my::string resp;
+            for (const my::string& s : strs) {
+                resp.append(s.c_str(), s.size());
+            }
+            sink.writeAll(resp.c_str(), resp.size());
+        }
+        st.set_bytes_processed(double(st.iterations() * frags * FragmentBytes));
+    }
+
+    // 逐个写：不拷贝，但每个片段一次系统调用
+    void writeEach(state& st) {
+        size_t frags = st.arg(0);
+        auto parts = makeFragments(frags);
+        my::vector<my::string> strs;
+        for (const my::iobuf& p : parts) {
+            strs.push_back(p.to_string());
+        }
+        socket_sink sink;
+        for (auto _ : st) {
+            for (const my::string& s : strs) {
+                sink.writeAll(s.c_str(), s.size());
+            }
+        }
+        st.set_bytes_processed(double(st.iterations() * frags * FragmentBytes));
+    }
+
+#define MY_FRAGS ->arg_names({"frags"})->range({16, 256, 4096})
+
+    MY_BENCHMARK("iobuf/write_fragments/writev", writevIobuf) MY_FRAGS;
+    MY_BENCHMARK("iobuf/write_fragments/concat", writeConcat) MY_FRAGS;
+    MY_BENCHMARK("iobuf/write_fragments/write_each", writeEach) MY_FRAGS;
+
+#undef MY_FRAGS
+}
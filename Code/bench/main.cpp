@@ -0,0 +1,357 @@
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "bench.h"
+#include "hardening/hardening.h"
+
+/**
+ * my_bench的入口
+ *   --filter=<正则>     只运行名字中能匹配该正则的基准
+ *   --min-time=<秒>     每次测量的最短时间，默认0.1
+ *   --repetitions=<n>   重复测量次数，结果取中位数，默认3
+ *   --json=<文件>       把结果写成JSON，交给compare.py比较
+ *   --smoke             每个基准只用第一组参数跑一次迭代，用来检查基准本身能否运行
+ *   --list              只列出基准的名字
+ */
+namespace my::bench {
+    struct options {
+        std::string filter;
+        double minTime = 0.1;
+        size_t repetitions = 3;
+        std::string json;
+        bool smoke = false;
+        bool list = false;
+    };
+
+    // 一组参数的测量结果，时间为每次迭代的中位数（纳秒）
+    struct result {
+        std::string name;
+        std::string label;
+        size_t iterations = 0;
+        size_t repetitions = 0;
+        double realTime = 0;
+        double realMin = 0;
+        double realMax = 0;
+        double cpuTime = 0;
+        double itemsPerSecond = 0;
+        double bytesPerSecond = 0;
+        std::vector<std::pair<std::string, double>> counters;
+        std::string skipped;
+    };
+
+    static double median(std::vector<double> v) {
+        if (v.empty()) {
+            return 0;
+        }
+        std::sort(v.begin(), v.end());
+        size_t n = v.size();
+        return n % 2 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+    }
+
+    class runner {
+    public:
+        explicit runner(const options& opt) : _opt(opt) {}
+
+        // 运行一个基准的一组参数
+        result run(const benchmark& b, const std::vector<long>& args, const std::string& name) {
+            result r;
+            r.name = name;
+            size_t iters = b._iterations;
+            if (_opt.smoke) {
+                iters = 1;
+            } else if (iters == 0) {
+                iters = calibrate(b, args, r);
+                if (!r.skipped.empty()) {
+                    return r;
+                }
+            }
+            size_t reps = _opt.smoke ? 1 : _opt.repetitions;
+            std::vector<double> real, cpu, items, bytes;
+            std::vector<std::vector<std::pair<std::string, double>>> counters;
+            for (size_t i = 0; i < reps; i++) {
+                state st(args, iters);
+                b._fn(st);
+                if (!st._skipped.empty()) {
+                    r.skipped = st._skipped;
+                    return r;
+                }
+                real.push_back(st._real);
+                cpu.push_back(st._cpu);
+                items.push_back(st._real > 0 ? st._items / st._real : 0);
+                bytes.push_back(st._real > 0 ? st._bytes / st._real : 0);
+                counters.push_back(st._counters);
+                r.label = st._label;
+            }
+            r.iterations = iters;
+            r.repetitions = reps;
+            double scale = 1e9 / double(iters);
+            r.realTime = median(real) * scale;
+            r.realMin = *std::min_element(real.begin(), real.end()) * scale;
+            r.realMax = *std::max_element(real.begin(), real.end()) * scale;
+            r.cpuTime = median(cpu) * scale;
+            r.itemsPerSecond = median(items);
+            r.bytesPerSecond = median(bytes);
+            for (const auto& c : counters.front()) {
+                std::vector<double> v;
+                for (const auto& rep : counters) {
+                    for (const auto& x : rep) {
+                        if (x.first == c.first) {
+                            v.push_back(x.second);
+                        }
+                    }
+                }
+                r.counters.emplace_back(c.first, median(v));
+            }
+            return r;
+        }
+
+    private:
+        // 迭代次数从1开始按实际耗时放大，直到一次测量超过min-time
+        size_t calibrate(const benchmark& b, const std::vector<long>& args, result& r) {
+            size_t iters = 1;
+            while (true) {
+                state st(args, iters);
+                b._fn(st);
+                if (!st._skipped.empty()) {
+                    r.skipped = st._skipped;
+                    return 0;
+                }
+                if (st._real >= _opt.minTime || iters >= 1000000000) {
+                    return iters;
+                }
+                double factor = st._real > 0 ? _opt.minTime * 1.4 / st._real : 100;
+                factor = std::min(100.0, std::max(2.0, factor));
+                iters = size_t(double(iters) * factor);
+            }
+        }
+
+        const options& _opt;
+    };
+
+    static std::string fullName(const benchmark& b, const std::vector<long>& args) {
+        std::string name = b._name;
+        for (size_t i = 0; i < args.size(); i++) {
+            name += '/';
+            if (i < b._argNames.size()) {
+                name += b._argNames[i] + ':';
+            }
+            name += std::to_string(args[i]);
+        }
+        return name;
+    }
+
+    static std::string jsonEscape(const std::string& s) {
+        std::string out;
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if ((unsigned char)c < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                out += buf;
+            } else {
+                out += c;
+            }
+        }
+        return out;
+    }
+
+    static std::string jsonNumber(double v) {
+        if (!std::isfinite(v)) {
+            return "0";
+        }
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.6g", v);
+        return buf;
+    }
+
+    // 读取CPU型号，用于在结果中标明测量环境
+    static std::string cpuModel() {
+        std::ifstream in("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.compare(0, 10, "model name") == 0) {
+                size_t p = line.find(':');
+                return p == std::string::npos ? line : line.substr(p + 2);
+            }
+        }
+        return "unknown";
+    }
+
+    static void writeJson(const std::string& path, const std::vector<result>& results) {
+        std::ofstream out(path);
+        char host[256] = "unknown";
+        gethostname(host, sizeof(host) - 1);
+        char date[64];
+        std::time_t now = std::time(nullptr);
+        std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+        out << "{\n  \"context\": {\n"
+            << "    \"date\": \"" << date << "\",\n"
+            << "    \"host_name\": \"" << jsonEscape(host) << "\",\n"
+            << "    \"cpu_model\": \"" << jsonEscape(cpuModel()) << "\",\n"
+            << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+            << "    \"library_build_type\": \"release\",\n"
+#else
+            << "    \"library_build_type\": \"debug\",\n"
+#endif
+            << "    \"compiler\": \"" << jsonEscape(__VERSION__) << "\",\n"
+            << "    \"hardening_level\": " << MY_HARDENING_LEVEL << "\n"
+            << "  },\n  \"benchmarks\": [";
+        bool first = true;
+        for (const result& r : results) {
+            if (!r.skipped.empty()) {
+                continue;
+            }
+            out << (first ? "\n" : ",\n") << "    {\n"
+                << "      \"name\": \"" << jsonEscape(r.name) << "\",\n"
+                << "      \"run_type\": \"aggregate\",\n"
+                << "      \"aggregate_name\": \"median\",\n"
+                << "      \"iterations\": " << r.iterations << ",\n"
+                << "      \"repetitions\": " << r.repetitions << ",\n"
+                << "      \"real_time\": " << jsonNumber(r.realTime) << ",\n"
+                << "      \"real_time_min\": " << jsonNumber(r.realMin) << ",\n"
+                << "      \"real_time_max\": " << jsonNumber(r.realMax) << ",\n"
+                << "      \"cpu_time\": " << jsonNumber(r.cpuTime) << ",\n"
+                << "      \"time_unit\": \"ns\"";
+            if (r.itemsPerSecond > 0) {
+                out << ",\n      \"items_per_second\": " << jsonNumber(r.itemsPerSecond);
+            }
+            if (r.bytesPerSecond > 0) {
+                out << ",\n      \"bytes_per_second\": " << jsonNumber(r.bytesPerSecond);
+            }
+            for (const auto& c : r.counters) {
+                out << ",\n      \"" << jsonEscape(c.first) << "\": " << jsonNumber(c.second);
+            }
+            if (!r.label.empty()) {
+                out << ",\n      \"label\": \"" << jsonEscape(r.label) << "\"";
+            }
+            out << "\n    }";
+            first = false;
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    // 按数量级选择合适的单位
+    static std::string humanTime(double ns) {
+        char buf[32];
+        if (ns < 1e3) {
+            std::snprintf(buf, sizeof(buf), "%.2f ns", ns);
+        } else if (ns < 1e6) {
+            std::snprintf(buf, sizeof(buf), "%.2f us", ns / 1e3);
+        } else if (ns < 1e9) {
+            std::snprintf(buf, sizeof(buf), "%.2f ms", ns / 1e6);
+        } else {
+            std::snprintf(buf, sizeof(buf), "%.2f s", ns / 1e9);
+        }
+        return buf;
+    }
+
+    static std::string humanRate(double v, const char* unit) {
+        const char* prefix[] = {"", "k", "M", "G", "T"};
+        int i = 0;
+        while (v >= 1000 && i < 4) {
+            v /= 1000;
+            i++;
+        }
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%.2f %s%s/s", v, prefix[i], unit);
+        return buf;
+    }
+
+    static void printResult(const result& r) {
+        if (!r.skipped.empty()) {
+            std::printf("%-56s skipped: %s\n", r.name.c_str(), r.skipped.c_str());
+            return;
+        }
+        std::printf("%-56s %12s %12zu", r.name.c_str(), humanTime(r.realTime).c_str(), r.iterations);
+        if (r.itemsPerSecond > 0) {
+            std::printf("  %s", humanRate(r.itemsPerSecond, "items").c_str());
+        }
+        if (r.bytesPerSecond > 0) {
+            std::printf("  %s", humanRate(r.bytesPerSecond, "B").c_str());
+        }
+        for (const auto& c : r.counters) {
+            std::printf("  %s=%.4g", c.first.c_str(), c.second);
+        }
+        if (!r.label.empty()) {
+            std::printf("  %s", r.label.c_str());
+        }
+        std::printf("\n");
+        std::fflush(stdout);
+    }
+
+    static bool parseOption(const std::string& a, const char* key, std::string& value) {
+        std::string prefix = std::string("--") + key + "=";
+        if (a.compare(0, prefix.size(), prefix) == 0) {
+            value = a.substr(prefix.size());
+            return true;
+        }
+        return false;
+    }
+
+    int run_main(int argc, char** argv) {
+        options opt;
+        for (int i = 1; i < argc; i++) {
+            std::string a = argv[i];
+            std::string v;
+            if (parseOption(a, "filter", v)) {
+                opt.filter = v;
+            } else if (parseOption(a, "min-time", v)) {
+                opt.minTime = std::stod(v);
+            } else if (parseOption(a, "repetitions", v)) {
+                opt.repetitions = std::max<size_t>(1, std::stoul(v));
+            } else if (parseOption(a, "json", v)) {
+                opt.json = v;
+            } else if (a == "--smoke") {
+                opt.smoke = true;
+            } else if (a == "--list") {
+                opt.list = true;
+            } else {
+                std::fprintf(stderr, "usage: %s [--filter=regex] [--min-time=s] [--repetitions=n] [--json=file] [--smoke] [--list]\n", argv[0]);
+                return 2;
+            }
+        }
+
+        std::regex re(opt.filter.empty() ? ".*" : opt.filter);
+        runner run(opt);
+        std::vector<result> results;
+        if (!opt.list) {
+            std::printf("%-56s %12s %12s\n", "benchmark", "time", "iterations");
+        }
+        for (const auto& b : _registry()) {
+            std::vector<std::vector<long>> sets = b->_argSets;
+            if (sets.empty()) {
+                sets.push_back({});
+            }
+            if (opt.smoke) {
+                sets.resize(1);
+            }
+            for (const auto& args : sets) {
+                std::string name = fullName(*b, args);
+                if (!std::regex_search(name, re)) {
+                    continue;
+                }
+                if (opt.list) {
+                    std::printf("%s\n", name.c_str());
+                    continue;
+                }
+                results.push_back(run.run(*b, args, name));
+                printResult(results.back());
+            }
+        }
+        if (!opt.json.empty()) {
+            writeJson(opt.json, results);
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    return my::bench::run_main(argc, argv);
+}
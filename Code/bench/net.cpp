@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "bench.h"
+#include "net/tcp_server.h"
+
+/**
+ * TCP服务器：回环地址上的回显服务器，客户端用conns条连接同时各发一个请求、再逐个读回响应，
+ * 统计每秒请求数（items/s）和请求往返延迟的p50/p99
+ * 服务器在单独的线程中运行，threads为reactor线程数；客户端只有一个线程，使用阻塞socket
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    const size_t MessageBytes = 64;
+    const size_t Rounds = 2000; // 每次迭代每条连接的请求数
+
+    int connectTo(uint16_t port) {
+        int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            ::close(fd);
+            return -1;
+        }
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        return fd;
+    }
+
+    // 读满len字节，连接出错时返回false
+    bool readFull(int fd, char* buf, size_t len) {
+        while (len > 0) {
+            ssize_t n = ::read(fd, buf, len);
+            if (n <= 0) {
+                return false;
+            }
+            buf += n;
+            len -= size_t(n);
+        }
+        return true;
+    }
+
+    void echoRps(state& st) {
+        size_t threads = st.arg(0), conns = st.arg(1);
+        my::net::tcp_server server(threads);
+        server.on_message([](my::net::tcp_connection& conn) {
+            conn.send(conn.input());
+            conn.input().erase(0, conn.input().size());
+        });
+        if (!server.listen(0, "127.0.0.1")) {
+            st.skip("listen failed");
+            return;
+        }
+        std::thread serverThread([&server] { server.run(); });
+        std::vector<int> fds;
+        for (size_t i = 0; i < conns; i++) {
+            int fd = connectTo(server.port());
+            if (fd < 0) {
+                break;
+            }
+            fds.push_back(fd);
+        }
+        if (fds.size() == conns) {
+            char request[MessageBytes], response[MessageBytes];
+            std::memset(request, 'x', sizeof(request));
+            std::vector<double> latencies;
+            latencies.reserve(Rounds * conns);
+            bool ok = true;
+            for (auto _ : st) {
+                latencies.clear();
+                for (size_t r = 0; r < Rounds && ok; r++) {
+                    auto t0 = std::chrono::steady_clock::now();
+                    for (int fd : fds) {
+                        ok = ok && ::send(fd, request, sizeof(request), MSG_NOSIGNAL) == ssize_t(sizeof(request));
+                    }
+                    for (int fd : fds) {
+                        ok = ok && readFull(fd, response, sizeof(response));
+                        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count());
+                    }
+                    do_not_optimize(response);
+                }
+            }
+            if (ok) {
+                st.counter("p50_us", my::bench::percentile(latencies, 0.50));
+                st.counter("p99_us", my::bench::percentile(latencies, 0.99));
+                st.set_items_processed(double(st.iterations() * Rounds * conns));
+            } else {
+                st.skip("connection error");
+            }
+        } else {
+            st.skip("connect failed");
+        }
+        for (int fd : fds) {
+            ::close(fd);
+        }
+        server.stop();
+        serverThread.join();
+    }
+
+    MY_BENCHMARK("net/echo_rps/tcp_server", echoRps)->arg_names({"threads", "conns"})
+        ->args({1, 1})->args({1, 16})->args({1, 64})->args({2, 64})->args({4, 64});
+}
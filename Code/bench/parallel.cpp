@@ -0,0 +1,103 @@
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include "bench.h"
+#include "parallel/parallel.h"
+#include "vector/vector.h"
+
+/**
+ * 并行算法：线程数从1到8的扩展性，与顺序执行的std::算法对比
+ * threads为参与计算的线程总数（工作线程 + 调用线程），超过CPU核数时只会更慢，用来观察超额订阅的代价
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    const size_t N = size_t(1) << 24;
+
+    my::vector<uint32_t> randomData(size_t n) {
+        my::vector<uint32_t> v;
+        v.reserve(n);
+        std::mt19937 rng(1);
+        for (size_t i = 0; i < n; i++) {
+            v.push_back(uint32_t(rng()));
+        }
+        return v;
+    }
+
+    void setThreads(state& st) {
+        my::parallel::set_thread_count(size_t(st.arg(0)) - 1);
+    }
+
+    void reduceMy(state& st) {
+        setThreads(st);
+        auto v = randomData(N);
+        for (auto _ : st) {
+            do_not_optimize(my::parallel::reduce(v.begin(), v.end(), uint64_t(0)));
+        }
+        st.set_bytes_processed(double(st.iterations() * N * sizeof(uint32_t)));
+    }
+
+    void reduceStd(state& st) {
+        auto v = randomData(N);
+        for (auto _ : st) {
+            do_not_optimize(std::accumulate(v.begin(), v.end(), uint64_t(0)));
+        }
+        st.set_bytes_processed(double(st.iterations() * N * sizeof(uint32_t)));
+    }
+
+    void scanMy(state& st) {
+        setThreads(st);
+        auto v = randomData(N);
+        my::vector<uint32_t> out(N, 0);
+        for (auto _ : st) {
+            my::parallel::inclusive_scan(v.begin(), v.end(), out.begin());
+            do_not_optimize(out.data());
+        }
+        st.set_items_processed(double(st.iterations() * N));
+    }
+
+    void scanStd(state& st) {
+        auto v = randomData(N);
+        my::vector<uint32_t> out(N, 0);
+        for (auto _ : st) {
+            std::inclusive_scan(v.begin(), v.end(), out.begin());
+            do_not_optimize(out.data());
+        }
+        st.set_items_processed(double(st.iterations() * N));
+    }
+
+    // 每次迭代先恢复成同一份乱序数据，恢复的时间不计入
+    template <bool Parallel>
+    void sortBench(state& st) {
+        if constexpr (Parallel) {
+            setThreads(st);
+        }
+        auto src = randomData(N);
+        my::vector<uint32_t> v(src);
+        for (auto _ : st) {
+            st.pause_timing();
+            std::copy(src.begin(), src.end(), v.begin());
+            st.resume_timing();
+            if constexpr (Parallel) {
+                my::parallel::sort(v.begin(), v.end());
+            } else {
+                std::sort(v.begin(), v.end());
+            }
+            do_not_optimize(v.data());
+        }
+        st.set_items_processed(double(st.iterations() * N));
+    }
+
+#define MY_THREADS ->arg_names({"threads"})->range({1, 2, 4, 8})
+
+    MY_BENCHMARK("parallel/reduce<uint32_t>/my", reduceMy) MY_THREADS;
+    MY_BENCHMARK("parallel/reduce<uint32_t>/std", reduceStd);
+    MY_BENCHMARK("parallel/inclusive_scan<uint32_t>/my", scanMy) MY_THREADS;
+    MY_BENCHMARK("parallel/inclusive_scan<uint32_t>/std", scanStd);
+    MY_BENCHMARK("parallel/sort<uint32_t>/my", sortBench<true>) MY_THREADS;
+    MY_BENCHMARK("parallel/sort<uint32_t>/std", sortBench<false>);
+
+#undef MY_THREADS
+}
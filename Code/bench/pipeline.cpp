@@ -0,0 +1,113 @@
+#include <cstdint>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+#include "bench.h"
+#include "coroutine/generator.h"
+#include "coroutine/pipeline.h"
+#include "string/string.h"
+#include "string/string_view.h"
+#include "vector/vector.h"
+
+/**
+ * 协程流水线：n行数字字符串经过解析、过滤、变换、求和四个阶段的吞吐量和峰值内存
+ * 对照组把每个阶段的结果都物化成vector再交给下一阶段，峰值内存与n成正比；
+ * 流水线只在通道中保留几批元素，batch为每批的元素个数，批越大协程切换越少
+ * peak_rss_mb是计时区间内常驻内存峰值相对开始时的增量
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    my::string line(size_t i) {
+        my::string s;
+        s.append_uint(i * 7919 % 1000003);
+        return s;
+    }
+
+    my::generator<my::string> lines(size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            co_yield line(i);
+        }
+    }
+
+    long long parse(const my::string& s) {
+        long long v = 0;
+        my::parse_int(my::string_view(s.c_str(), s.size()), v);
+        return v;
+    }
+
+    // 在计时开始前重置峰值，结束后记录增量；先把前面基准释放的堆内存还给系统，否则它们已经常驻，增量偏小
+    struct rss_probe {
+        explicit rss_probe(state& st) : _st(st) {
+#if defined(__GLIBC__)
+            malloc_trim(0);
+#endif
+            my::bench::reset_peak_rss();
+            _base = my::bench::current_rss();
+        }
+        ~rss_probe() {
+            size_t peak = my::bench::peak_rss();
+            _st.counter("peak_rss_mb", peak > _base ? double(peak - _base) / (1 << 20) : 0);
+        }
+        state& _st;
+        size_t _base;
+    };
+
+    void streamed(state& st) {
+        size_t n = st.arg(0), batch = st.arg(1);
+        rss_probe probe(st);
+        for (auto _ : st) {
+            my::pipeline p;
+            auto& text = p.make_channel<my::string>(4, batch);
+            auto& nums = p.make_channel<long long>(4, batch);
+            auto& even = p.make_channel<long long>(4, batch);
+            auto& scaled = p.make_channel<long long>(4, batch);
+            p.source(lines(n), text);
+            p.transform(text, nums, [](my::string s) { return parse(s); });
+            p.filter(nums, even, [](long long v) { return v % 2 == 0; });
+            p.transform(even, scaled, [](long long v) { return v * 3 + 1; });
+            long long sum = 0;
+            p.sink(scaled, [&](long long v) { sum += v; });
+            p.run();
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    void materialized(state& st) {
+        size_t n = st.arg(0);
+        rss_probe probe(st);
+        for (auto _ : st) {
+            my::vector<my::string> text;
+            for (my::string& s : lines(n)) {
+                text.push_back(std::move(s));
+            }
+            my::vector<long long> nums;
+            for (const my::string& s : text) {
+                nums.push_back(parse(s));
+            }
+            my::vector<long long> even;
+            for (long long v : nums) {
+                if (v % 2 == 0) {
+                    even.push_back(v);
+                }
+            }
+            my::vector<long long> scaled;
+            for (long long v : even) {
+                scaled.push_back(v * 3 + 1);
+            }
+            long long sum = 0;
+            for (long long v : scaled) {
+                sum += v;
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    MY_BENCHMARK("pipeline/parse_filter_sum/coroutine", streamed)->arg_names({"n", "batch"})
+        ->args({1000000, 1})->args({1000000, 16})->args({1000000, 256})->args({10000000, 256});
+    MY_BENCHMARK("pipeline/parse_filter_sum/materialized", materialized)->arg_names({"n"})
+        ->range({1000000, 10000000});
+}
@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+#include "bench.h"
+#include "priority_queue/priority_queue.h"
+#include "priority_queue/radix_heap.h"
+#include "vector/vector.h"
+
+/**
+ * 基数堆：随机稀疏图上的单源最短路（Dijkstra，惰性删除），与二叉堆实现的优先队列对比
+ * 图有n个顶点，每个顶点8条出边，边权在[1, 1000]内均匀分布，存成CSR（偏移数组 + 边数组）
+ * dist_sum是所有可达顶点的距离之和，三种实现必须相同
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    const size_t Degree = 8;
+
+    struct graph {
+        my::vector<uint32_t> offsets; // 顶点v的出边为edges[offsets[v], offsets[v + 1])
+        my::vector<std::pair<uint32_t, uint32_t>> edges; // (终点, 边权)
+    };
+
+    graph randomGraph(size_t n) {
+        std::mt19937 rng(static_cast<uint32_t>(n));
+        graph g;
+        g.offsets.reserve(n + 1);
+        g.edges.reserve(n * Degree);
+        for (size_t v = 0; v < n; v++) {
+            g.offsets.push_back(uint32_t(g.edges.size()));
+            for (size_t k = 0; k < Degree; k++) {
+                g.edges.push_back(std::make_pair(uint32_t(rng() % n), uint32_t(1 + rng() % 1000)));
+            }
+        }
+        g.offsets.push_back(uint32_t(g.edges.size()));
+        return g;
+    }
+
+    // 堆适配：radix_heap的push参数是(键, 值)，二叉堆存(距离, 顶点)并用greater变成小堆
+    struct radix_queue {
+        my::radix_heap<uint64_t, uint32_t> _h;
+        void push(uint64_t d, uint32_t v) { _h.push(d, v); }
+        std::pair<uint64_t, uint32_t> top() const { return _h.top(); }
+        void pop() { _h.pop(); }
+        bool empty() const { return _h.empty(); }
+    };
+
+    template <class PQ>
+    struct binary_queue {
+        PQ _h;
+        void push(uint64_t d, uint32_t v) { _h.push(std::make_pair(d, v)); }
+        std::pair<uint64_t, uint32_t> top() const { return _h.top(); }
+        void pop() { _h.pop(); }
+        bool empty() const { return _h.empty(); }
+    };
+
+    typedef std::pair<uint64_t, uint32_t> entry;
+    typedef binary_queue<my::priority_queue<entry, my::vector<entry>, my::greater<entry>>> my_binary;
+    typedef binary_queue<std::priority_queue<entry, std::vector<entry>, std::greater<entry>>> std_binary;
+
+    template <class Q>
+    void dijkstra(state& st) {
+        size_t n = st.arg(0);
+        graph g = randomGraph(n);
+        const uint64_t inf = ~uint64_t(0);
+        my::vector<uint64_t> dist(n, inf);
+        uint64_t checksum = 0;
+        size_t pops = 0;
+        for (auto _ : st) {
+            for (size_t v = 0; v < n; v++) {
+                dist[v] = inf;
+            }
+            Q q;
+            dist[0] = 0;
+            q.push(0, 0);
+            while (!q.empty()) {
+                auto [d, v] = q.top();
+                q.pop();
+                ++pops;
+                if (d != dist[v]) {
+                    continue; // 过期的项
+                }
+                for (uint32_t e = g.offsets[v]; e < g.offsets[v + 1]; e++) {
+                    auto [to, w] = g.edges[e];
+                    if (d + w < dist[to]) {
+                        dist[to] = d + w;
+                        q.push(d + w, to);
+                    }
+                }
+            }
+            checksum = 0;
+            for (size_t v = 0; v < n; v++) {
+                checksum += dist[v] == inf ? 0 : dist[v];
+            }
+            do_not_optimize(checksum);
+        }
+        st.counter("dist_sum", double(checksum));
+        st.counter("pops_per_vertex", double(pops) / double(st.iterations() * n));
+        st.set_items_processed(double(st.iterations() * n * Degree)); // 每秒松弛的边数
+    }
+
+#define MY_SIZES ->arg_names({"n"})->range({10000, 100000, 1000000})
+
+    MY_BENCHMARK("radix_heap/dijkstra<u64>/radix_heap", dijkstra<radix_queue>) MY_SIZES;
+    MY_BENCHMARK("radix_heap/dijkstra<u64>/my_priority_queue", dijkstra<my_binary>) MY_SIZES;
+    MY_BENCHMARK("radix_heap/dijkstra<u64>/std_priority_queue", dijkstra<std_binary>) MY_SIZES;
+
+#undef MY_SIZES
+}
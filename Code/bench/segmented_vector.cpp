@@ -0,0 +1,71 @@
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "bench.h"
+#include "segmented_vector/segmented_vector.h"
+#include "vector/vector.h"
+
+/**
+ * 分段vector：连续push_back n个long时最慢的一次push_back，以及总的吞吐量
+ * vector扩容时要搬动全部元素，最慢的一次随n线性增长；segmented_vector只申请下一段，不搬动已有元素
+ * 延迟版本给每次push_back单独计时（包含一次读时钟的开销，两种容器相同），吞吐量版本不逐次计时
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    // 最慢一次的耗时max_push_us，以及超过100微秒的次数slow_pushes
+    template <class V>
+    void pushLatency(state& st) {
+        size_t n = st.arg(0);
+        double worst = 0;
+        size_t slow = 0;
+        for (auto _ : st) {
+            V v;
+            auto prev = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < n; i++) {
+                v.push_back(long(i));
+                auto now = std::chrono::steady_clock::now();
+                double us = std::chrono::duration<double, std::micro>(now - prev).count();
+                worst = us > worst ? us : worst;
+                slow += us > 100;
+                prev = now;
+            }
+            do_not_optimize(&v[n - 1]);
+            st.pause_timing();
+            v = V(); // 释放不计时
+            st.resume_timing();
+        }
+        st.counter("max_push_us", worst);
+        st.counter("slow_pushes", double(slow) / double(st.iterations()));
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    template <class V>
+    void pushThroughput(state& st) {
+        size_t n = st.arg(0);
+        for (auto _ : st) {
+            V v;
+            for (size_t i = 0; i < n; i++) {
+                v.push_back(long(i));
+            }
+            do_not_optimize(&v[n - 1]);
+            st.pause_timing();
+            v = V();
+            st.resume_timing();
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    // 1e8个long的vector扩容时新旧两块共需1.6GB，迭代次数固定为1
+#define MY_SIZES ->arg_names({"n"})->range({1000000, 10000000, 100000000})->iterations(1)
+
+    MY_BENCHMARK("segmented_vector/push_latency<long>/segmented", pushLatency<my::segmented_vector<long>>) MY_SIZES;
+    MY_BENCHMARK("segmented_vector/push_latency<long>/my_vector", pushLatency<my::vector<long>>) MY_SIZES;
+    MY_BENCHMARK("segmented_vector/push_latency<long>/std_vector", pushLatency<std::vector<long>>) MY_SIZES;
+    MY_BENCHMARK("segmented_vector/push_back<long>/segmented", pushThroughput<my::segmented_vector<long>>) MY_SIZES;
+    MY_BENCHMARK("segmented_vector/push_back<long>/my_vector", pushThroughput<my::vector<long>>) MY_SIZES;
+    MY_BENCHMARK("segmented_vector/push_back<long>/std_vector", pushThroughput<std::vector<long>>) MY_SIZES;
+
+#undef MY_SIZES
+}
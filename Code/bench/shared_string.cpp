@@ -0,0 +1,44 @@
+#include <cstdint>
+#include <string>
+#include "bench.h"
+#include "string/shared_string.h"
+#include "string/string.h"
+#include "vector/vector.h"
+
+/**
+ * shared_string：一条bytes字节的消息分发给Receivers个接收者（每个接收者保存一份拷贝），再全部释放
+ * 对照组是my::string和std::string的拷贝构造，每个接收者一次内存申请加一次完整复制；
+ * shared_string每个接收者只是一次原子加一和一次原子减一；字节数按交给接收者的逻辑数据量计算
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    const size_t Receivers = 1000;
+
+    template <class Str>
+    void fanOut(state& st) {
+        size_t bytes = st.arg(0);
+        std::string payload(bytes, 'x');
+        Str msg(payload.c_str());
+        my::vector<Str> inbox;
+        inbox.reserve(Receivers);
+        for (auto _ : st) {
+            for (size_t i = 0; i < Receivers; i++) {
+                inbox.push_back(msg);
+            }
+            do_not_optimize(inbox.data());
+            inbox.clear();
+        }
+        st.set_items_processed(double(st.iterations() * Receivers));
+        st.set_bytes_processed(double(st.iterations() * Receivers * bytes));
+    }
+
+#define MY_BYTES ->arg_names({"bytes"})->range({64, 4096, 65536})
+
+    MY_BENCHMARK("shared_string/fan_out/shared_string", fanOut<my::shared_string>) MY_BYTES;
+    MY_BENCHMARK("shared_string/fan_out/my_string", fanOut<my::string>) MY_BYTES;
+    MY_BENCHMARK("shared_string/fan_out/std_string", fanOut<std::string>) MY_BYTES;
+
+#undef MY_BYTES
+}
@@ -0,0 +1,126 @@
+#include <cstdint>
+#include <numeric>
+#include "bench.h"
+#include "simd/simd.h"
+#include "vector/vector.h"
+
+/**
+ * SIMD：同一算法在基线、AVX2、AVX-512三个版本下的吞吐量，以及逐个元素的标量循环
+ * n取4096（L1内）、2^18（L2/L3内）、2^24（主存），数据量大时三个版本都会受限于内存带宽
+ * CPU不支持的指令集跳过，不计入结果
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+    using my::simd::isa;
+
+    template <class T>
+    my::vector<T> makeData(size_t n) {
+        my::vector<T> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            v.push_back(T(i % 97) - T(48));
+        }
+        return v;
+    }
+
+    // 切换到指定指令集，CPU不支持时返回false并跳过这一项
+    bool useIsa(state& st, isa which) {
+        if (my::simd::set_isa(which) != which) {
+            st.skip("cpu does not support this isa");
+            return false;
+        }
+        return true;
+    }
+
+    // 标量版本关闭自动向量化，作为SIMD带来加速的参照
+    template <class T>
+    __attribute__((optimize("no-tree-vectorize"))) T scalarSum(const T* p, size_t n) {
+        T s = 0;
+        for (size_t i = 0; i < n; i++) {
+            s += p[i];
+        }
+        return s;
+    }
+
+    template <class T>
+    __attribute__((optimize("no-tree-vectorize"))) T scalarDot(const T* x, const T* y, size_t n) {
+        T s = 0;
+        for (size_t i = 0; i < n; i++) {
+            s += x[i] * y[i];
+        }
+        return s;
+    }
+
+    template <class T>
+    __attribute__((optimize("no-tree-vectorize"))) size_t scalarCount(const T* p, size_t n, T x) {
+        size_t c = 0;
+        for (size_t i = 0; i < n; i++) {
+            c += p[i] == x;
+        }
+        return c;
+    }
+
+    // Scalar为true时运行标量循环，否则运行指定指令集的my::simd版本
+    template <class T, bool Scalar, isa Which>
+    void sumBench(state& st) {
+        if (!Scalar && !useIsa(st, Which)) {
+            return;
+        }
+        size_t n = st.arg(0);
+        auto v = makeData<T>(n);
+        for (auto _ : st) {
+            do_not_optimize(Scalar ? scalarSum(v.data(), n) : my::simd::sum(v.data(), n));
+        }
+        st.set_bytes_processed(double(st.iterations() * n * sizeof(T)));
+        my::simd::set_isa(my::simd::detect());
+    }
+
+    template <class T, bool Scalar, isa Which>
+    void dotBench(state& st) {
+        if (!Scalar && !useIsa(st, Which)) {
+            return;
+        }
+        size_t n = st.arg(0);
+        auto x = makeData<T>(n);
+        auto y = makeData<T>(n);
+        for (auto _ : st) {
+            do_not_optimize(Scalar ? scalarDot(x.data(), y.data(), n) : my::simd::dot(x.data(), y.data(), n));
+        }
+        st.set_bytes_processed(double(st.iterations() * n * sizeof(T) * 2));
+        my::simd::set_isa(my::simd::detect());
+    }
+
+    template <class T, bool Scalar, isa Which>
+    void countBench(state& st) {
+        if (!Scalar && !useIsa(st, Which)) {
+            return;
+        }
+        size_t n = st.arg(0);
+        auto v = makeData<T>(n);
+        for (auto _ : st) {
+            do_not_optimize(Scalar ? scalarCount(v.data(), n, T(5)) : my::simd::count(v.data(), n, T(5)));
+        }
+        st.set_bytes_processed(double(st.iterations() * n * sizeof(T)));
+        my::simd::set_isa(my::simd::detect());
+    }
+
+#define MY_SIZES ->arg_names({"n"})->range({4096, 1 << 18, 1 << 24})
+#define MY_SIMD_BENCH(op, fn, type) \
+    MY_BENCHMARK("simd/" #op "<" #type ">/scalar", fn<type, true, isa::baseline>) MY_SIZES; \
+    MY_BENCHMARK("simd/" #op "<" #type ">/baseline", fn<type, false, isa::baseline>) MY_SIZES; \
+    MY_BENCHMARK("simd/" #op "<" #type ">/avx2", fn<type, false, isa::avx2>) MY_SIZES; \
+    MY_BENCHMARK("simd/" #op "<" #type ">/avx512", fn<type, false, isa::avx512>) MY_SIZES
+
+    MY_SIMD_BENCH(sum, sumBench, float);
+    MY_SIMD_BENCH(sum, sumBench, double);
+    MY_SIMD_BENCH(sum, sumBench, int32_t);
+    MY_SIMD_BENCH(sum, sumBench, int64_t);
+    MY_SIMD_BENCH(dot, dotBench, float);
+    MY_SIMD_BENCH(dot, dotBench, double);
+    MY_SIMD_BENCH(count, countBench, int32_t);
+    MY_SIMD_BENCH(count, countBench, int64_t);
+
+#undef MY_SIMD_BENCH
+#undef MY_SIZES
+}
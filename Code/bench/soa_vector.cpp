@@ -0,0 +1,117 @@
+#include <cstdint>
+#include "bench.h"
+#include "soa_vector/soa_vector.h"
+#include "vector/vector.h"
+
+/**
+ * 结构体数组：只扫描一个字段时，AoS与SoA的访存差异
+ * 每条记录64字节（一条缓存行），AoS扫描price时每读8字节有用数据就要加载一整条缓存行；
+ * SoA的price列是连续的double数组，同样的数据量只需八分之一的缓存行
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+
+    struct record {
+        uint64_t id;
+        double price;
+        uint32_t qty;
+        uint32_t flags;
+        char name[40];
+    };
+    static_assert(sizeof(record) == 64);
+
+    typedef my::soa_vector<uint64_t, double, uint32_t, uint32_t> table;
+
+    my::vector<record> makeAos(size_t n) {
+        my::vector<record> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            v.push_back(record{i, double(i % 1000) * 0.25, uint32_t(i), 0, {}});
+        }
+        return v;
+    }
+
+    table makeSoa(size_t n) {
+        table v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            v.emplace_back(i, double(i % 1000) * 0.25, uint32_t(i), 0u);
+        }
+        return v;
+    }
+
+    // AoS：遍历记录数组，只读price
+    void scanAos(state& st) {
+        size_t n = st.arg(0);
+        auto v = makeAos(n);
+        for (auto _ : st) {
+            double sum = 0;
+            for (const record& r : v) {
+                sum += r.price;
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+        st.set_bytes_processed(double(st.iterations() * n * sizeof(double)));
+    }
+
+    // SoA：直接遍历price列的span，热循环的推荐写法
+    void scanSoaColumn(state& st) {
+        size_t n = st.arg(0);
+        auto v = makeSoa(n);
+        for (auto _ : st) {
+            double sum = 0;
+            for (double p : v.column<1>()) {
+                sum += p;
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+        st.set_bytes_processed(double(st.iterations() * n * sizeof(double)));
+    }
+
+    // SoA：通过代理引用遍历整条记录，衡量代理迭代器本身的开销
+    void scanSoaProxy(state& st) {
+        size_t n = st.arg(0);
+        auto v = makeSoa(n);
+        for (auto _ : st) {
+            double sum = 0;
+            for (auto [id, price, qty, flags] : v) {
+                sum += price;
+            }
+            do_not_optimize(sum);
+        }
+        st.set_items_processed(double(st.iterations() * n));
+        st.set_bytes_processed(double(st.iterations() * n * sizeof(double)));
+    }
+
+    // 逐条插入：SoA每条记录要分别写入四列
+    void buildAos(state& st) {
+        size_t n = st.arg(0);
+        for (auto _ : st) {
+            auto v = makeAos(n);
+            do_not_optimize(v.data());
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+    void buildSoa(state& st) {
+        size_t n = st.arg(0);
+        for (auto _ : st) {
+            auto v = makeSoa(n);
+            do_not_optimize(v.column<0>().data());
+        }
+        st.set_items_processed(double(st.iterations() * n));
+    }
+
+#define MY_SIZES ->arg_names({"n"})->range({100000, 1000000, 10000000})
+
+    MY_BENCHMARK("soa_vector/scan_field<double>/aos", scanAos) MY_SIZES;
+    MY_BENCHMARK("soa_vector/scan_field<double>/soa_column", scanSoaColumn) MY_SIZES;
+    MY_BENCHMARK("soa_vector/scan_field<double>/soa_proxy", scanSoaProxy) MY_SIZES;
+    MY_BENCHMARK("soa_vector/build/aos", buildAos) MY_SIZES;
+    MY_BENCHMARK("soa_vector/build/soa", buildSoa) MY_SIZES;
+
+#undef MY_SIZES
+}
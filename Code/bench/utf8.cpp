@@ -0,0 +1,117 @@
+#include <cstdint>
+#include "bench.h"
+#include "simd/simd.h"
+#include "string/string.h"
+#include "string/utf8.h"
+#include "vector/vector.h"
+
+/**
+ * UTF-8：校验、码点计数、转UTF-16的吞吐量（GB/s按输入的UTF-8字节数计算）
+ * 文本分四种：纯ASCII、以ASCII为主夹杂少量多字节字符、全是三字节的中日韩文字、全是四字节的表情符号
+ * 校验和计数分别测标量、SSSE3、AVX2三个版本，SSSE3通过把my::simd的指令集降到基线来选中
+ */
+namespace {
+    using my::bench::state;
+    using my::bench::do_not_optimize;
+    using my::simd::isa;
+
+    const size_t TextBytes = size_t(1) << 20;
+
+    enum text { ascii, mostly_ascii, cjk, emoji };
+    enum impl { scalar, ssse3, avx2 };
+
+    // 按text的字符分布生成约TextBytes字节的合法UTF-8
+    my::string makeText(text t) {
+        my::string s;
+        uint32_t x = 1;
+        char buf[4];
+        while (s.size() < TextBytes) {
+            x = x * 1103515245u + 12345u;
+            uint32_t r = x >> 8;
+            char32_t cp;
+            if (t == ascii || (t == mostly_ascii && r % 16 != 0)) {
+                cp = 0x20 + r % 0x5f;
+            } else if (t == mostly_ascii) {
+                cp = r % 2 ? 0xc0 + r % 0x100 : 0x4e00 + r % 0x5000; // 拉丁字母扩展或汉字
+            } else if (t == cjk) {
+                cp = 0x4e00 + r % 0x5000;
+            } else {
+                cp = 0x1f300 + r % 0x300;
+            }
+            char* end = my::utf8::_scalar::encode(cp, buf);
+            s.append(buf, size_t(end - buf));
+        }
+        return s;
+    }
+
+    // 选中指令集，CPU不支持时跳过这一项
+    bool useImpl(state& st, impl which) {
+        if (which == scalar) {
+            return true;
+        }
+        isa want = which == avx2 ? isa::avx2 : isa::baseline;
+        if (my::simd::set_isa(want) != want || (which == ssse3 && !my::utf8::_has_ssse3())) {
+            st.skip("cpu does not support this isa");
+            return false;
+        }
+        return true;
+    }
+
+    template <text T, impl I>
+    void validate(state& st) {
+        if (!useImpl(st, I)) {
+            return;
+        }
+        my::string s = makeText(T);
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(s.c_str());
+        for (auto _ : st) {
+            bool ok = I == scalar ? my::utf8::_scalar::validate(p, s.size()) : my::utf8::validate(s.c_str(), s.size());
+            do_not_optimize(ok);
+        }
+        my::simd::set_isa(my::simd::detect());
+        st.set_bytes_processed(double(st.iterations() * s.size()));
+    }
+
+    template <text T, impl I>
+    void count(state& st) {
+        if (!useImpl(st, I)) {
+            return;
+        }
+        my::string s = makeText(T);
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(s.c_str());
+        for (auto _ : st) {
+            size_t four = 0;
+            size_t n = I == scalar ? my::utf8::_scalar::count(p, s.size(), four) : my::utf8::count(s.c_str(), s.size());
+            do_not_optimize(n);
+        }
+        my::simd::set_isa(my::simd::detect());
+        st.set_bytes_processed(double(st.iterations() * s.size()));
+    }
+
+    template <text T>
+    void toUtf16(state& st) {
+        my::string s = makeText(T);
+        my::vector<char16_t> out(s.size(), 0);
+        for (auto _ : st) {
+            do_not_optimize(my::utf8::to_utf16(s.c_str(), s.size(), out.data()));
+        }
+        st.set_bytes_processed(double(st.iterations() * s.size()));
+    }
+
+#define MY_UTF8_IMPLS(op, fn, name) \
+    MY_BENCHMARK("utf8/" op "<" #name ">/scalar", fn<name, scalar>); \
+    MY_BENCHMARK("utf8/" op "<" #name ">/ssse3", fn<name, ssse3>); \
+    MY_BENCHMARK("utf8/" op "<" #name ">/avx2", fn<name, avx2>)
+
+    MY_UTF8_IMPLS("validate", validate, ascii);
+    MY_UTF8_IMPLS("validate", validate, mostly_ascii);
+    MY_UTF8_IMPLS("validate", validate, cjk);
+    MY_UTF8_IMPLS("validate", validate, emoji);
+    MY_UTF8_IMPLS("count", count, ascii);
+    MY_UTF8_IMPLS("count", count, cjk);
+    MY_BENCHMARK("utf8/to_utf16<ascii>/my", toUtf16<ascii>);
+    MY_BENCHMARK("utf8/to_utf16<mostly_ascii>/my", toUtf16<mostly_ascii>);
+    MY_BENCHMARK("utf8/to_utf16<cjk>/my", toUtf16<cjk>);
+
+#undef MY_UTF8_IMPLS
+}
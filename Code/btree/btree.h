@@ -0,0 +1,688 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "../flat_map/flat_map.h"
+#include "../priority_queue/priority_queue.h"
+#include "../hardening/hardening.h"
+
+namespace my {
+    /**
+     * B+树
+     * 所有元素都存放在叶子结点中，内部结点只保存分隔键和孩子指针，
+     * 叶子结点之间用双向链表串起来，顺序遍历和范围扫描时直接沿链表走，不需要回到上层
+     * 结点大小按缓存行对齐，一个结点就是几条连续的缓存行，在结点内用无分支二分查找，
+     * 树高只有log_B(n)，比红黑树每层一次缓存未命中要少得多
+     * 键和值保存在结点内的数组中，要求可默认构造和赋值
+     */
+
+    // 叶子结点，V为void时（集合）不存值
+    template <class K, class V, size_t N>
+    struct alignas(64) _btree_leaf {
+        uint16_t _count = 0; // 元素个数
+        _btree_leaf* _prev = nullptr; // 前一个叶子
+        _btree_leaf* _next = nullptr; // 后一个叶子
+        K _keys[N];
+        V _values[N];
+    };
+
+    template <class K, size_t N>
+    struct alignas(64) _btree_leaf<K, void, N> {
+        uint16_t _count = 0;
+        _btree_leaf* _prev = nullptr;
+        _btree_leaf* _next = nullptr;
+        K _keys[N];
+    };
+
+    // 内部结点，_count个分隔键，_count + 1个孩子
+    // 孩子_children[i]中的键都小于_keys[i]，_children[i + 1]中的键都不小于_keys[i]
+    template <class K, size_t M>
+    struct alignas(64) _btree_inner {
+        uint16_t _count = 0;
+        K _keys[M];
+        void* _children[M + 1];
+    };
+
+    // B+树的迭代器，记录所在的叶子和叶子内的下标，沿叶子链表移动
+    // map的Ref是由键和值的引用组成的pair（代理引用），set的Ref是const K&
+    template <class Leaf, class Ref>
+    struct _btree_iterator {
+        typedef _btree_iterator<Leaf, Ref> self;
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef std::ptrdiff_t difference_type;
+        typedef Ref reference;
+
+        // 代理引用是临时对象，operator->只能包一层
+        struct arrow {
+            Ref _ref;
+            std::remove_reference_t<Ref>* operator->() { return &_ref; }
+        };
+
+        _btree_iterator(Leaf* leaf = nullptr, size_t index = 0) : _leaf(leaf), _index(index) {}
+        template <class R>
+        _btree_iterator(const _btree_iterator<Leaf, R>& it) : _leaf(it._leaf), _index(it._index) {} // 普通迭代器转换成const迭代器
+
+        self& operator++() {
+            if (++_index == _leaf->_count && _leaf->_next) {
+                _leaf = _leaf->_next;
+                _index = 0;
+            }
+            return *this;
+        }
+        self& operator--() {
+            if (_index == 0) {
+                _leaf = _leaf->_prev;
+                _index = _leaf->_count;
+            }
+            --_index;
+            return *this;
+        }
+        self operator++(int) {
+            self tmp(*this);
+            ++*this;
+            return tmp;
+        }
+        self operator--(int) {
+            self tmp(*this);
+            --*this;
+            return tmp;
+        }
+        bool operator==(const self& rhs) const { return _leaf == rhs._leaf && _index == rhs._index; }
+        bool operator!=(const self& rhs) const { return !(*this == rhs); }
+        Ref operator*() const {
+            if constexpr (std::is_reference_v<Ref>) {
+                return _leaf->_keys[_index];
+            } else {
+                return Ref(_leaf->_keys[_index], _leaf->_values[_index]);
+            }
+        }
+        auto operator->() const {
+            if constexpr (std::is_reference_v<Ref>) {
+                return &_leaf->_keys[_index];
+            } else {
+                return arrow{**this};
+            }
+        }
+
+        Leaf* _leaf; // 所在的叶子
+        size_t _index; // 叶子内的下标
+    };
+
+    /**
+     * B+树的公共部分，btree_map和btree_set在此基础上封装
+     * NodeBytes为结点的目标大小，默认256字节即4条缓存行，据此算出每个结点能放几个元素
+     * 删除采用惰性策略：叶子变空时才把它从树中摘掉，不做借位与合并，
+     * 插入为主、删除较少的场景下树高不受影响
+     */
+    template <class K, class V, class Compare, size_t NodeBytes>
+    class _btree {
+        static constexpr size_t _value_bytes = std::is_void_v<V> ? 0 : sizeof(std::conditional_t<std::is_void_v<V>, char, V>);
+    public:
+        static constexpr size_t leaf_slots = std::max<size_t>(4, (NodeBytes - 3 * sizeof(void*)) / (sizeof(K) + _value_bytes));
+        static constexpr size_t inner_slots = std::max<size_t>(4, (NodeBytes - 2 * sizeof(void*)) / (sizeof(K) + sizeof(void*)));
+        typedef _btree_leaf<K, V, leaf_slots> leaf;
+        typedef _btree_inner<K, inner_slots> inner;
+        typedef K key_type;
+        typedef Compare key_compare;
+
+        _btree() : _root(nullptr), _head(nullptr), _tail(nullptr), _height(0), _size(0) {}
+        explicit _btree(const Compare& comp) : _btree() { _comp = comp; }
+        _btree(const _btree& t) : _btree(t._comp) {
+            bulkLoad(t.beginLeaf(), t._size); // 已经有序，直接批量加载
+        }
+        _btree(_btree&& t) noexcept : _btree() {
+            swap(t);
+        }
+        _btree& operator=(_btree t) {
+            swap(t);
+            return *this;
+        }
+        ~_btree() {
+            clear();
+        }
+
+        // 容量和大小
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        size_t height() const { return _root ? _height + 1 : 0; } // 树的层数
+
+        // 清空，释放所有结点
+        void clear() {
+            if (_root) {
+                freeNode(_root, _height);
+            }
+            _root = _head = _tail = nullptr;
+            _height = 0;
+            _size = 0;
+        }
+
+        void swap(_btree& t) {
+            std::swap(_root, t._root);
+            std::swap(_head, t._head);
+            std::swap(_tail, t._tail);
+            std::swap(_height, t._height);
+            std::swap(_size, t._size);
+            std::swap(_comp, t._comp);
+        }
+
+        key_compare key_comp() const { return _comp; }
+
+    protected:
+        static constexpr size_t _max_height = 64;
+
+        // 从根走到key所在的叶子，记录经过的内部结点和走向的孩子下标
+        leaf* descend(const K& key, inner** path, size_t* slot) const {
+            void* node = _root;
+            for (size_t d = 0; d < _height; ++d) {
+                inner* in = static_cast<inner*>(node);
+                size_t ci = _branchless_upper_bound(in->_keys, in->_count, key, _comp);
+                if (path) {
+                    path[d] = in;
+                    slot[d] = ci;
+                }
+                node = in->_children[ci];
+            }
+            return static_cast<leaf*>(node);
+        }
+
+        // 第一个不小于key的位置，落在叶子末尾时移到下一个叶子的开头
+        std::pair<leaf*, size_t> lowerPos(const K& key) const {
+            if (!_root) {
+                return std::make_pair(nullptr, 0);
+            }
+            leaf* lf = descend(key, nullptr, nullptr);
+            size_t i = _branchless_lower_bound(lf->_keys, lf->_count, key, _comp);
+            return normalize(lf, i);
+        }
+        std::pair<leaf*, size_t> upperPos(const K& key) const {
+            if (!_root) {
+                return std::make_pair(nullptr, 0);
+            }
+            leaf* lf = descend(key, nullptr, nullptr);
+            size_t i = _branchless_upper_bound(lf->_keys, lf->_count, key, _comp);
+            return normalize(lf, i);
+        }
+        std::pair<leaf*, size_t> findPos(const K& key) const {
+            std::pair<leaf*, size_t> p = lowerPos(key);
+            if (p.first == nullptr || p.second == p.first->_count || _comp(key, p.first->_keys[p.second])) {
+                return endPos();
+            }
+            return p;
+        }
+        static std::pair<leaf*, size_t> normalize(leaf* lf, size_t i) {
+            if (i == lf->_count && lf->_next) {
+                return std::make_pair(lf->_next, 0);
+            }
+            return std::make_pair(lf, i);
+        }
+        std::pair<leaf*, size_t> beginPos() const {
+            return std::make_pair(_head, 0);
+        }
+        std::pair<leaf*, size_t> endPos() const {
+            return std::make_pair(_tail, _tail ? _tail->_count : 0);
+        }
+        leaf* beginLeaf() const {
+            return _head;
+        }
+
+        /**
+         * 插入key，已存在时返回原有的位置和false
+         * 叶子满了就对半分裂，新叶子的第一个键作为分隔键插入父结点，父结点满了继续向上分裂，
+         * 根分裂时树长高一层
+         * 在最右叶子的末尾追加时（有序插入）不对半分，原叶子保持全满，新元素单独放入新叶子
+         */
+        template <class... Args>
+        std::pair<std::pair<leaf*, size_t>, bool> insertKey(const K& key, Args&&... args) {
+            if (!_root) {
+                _root = _head = _tail = new leaf;
+            }
+            inner* path[_max_height];
+            size_t slot[_max_height];
+            leaf* lf = descend(key, path, slot);
+            size_t pos = _branchless_lower_bound(lf->_keys, lf->_count, key, _comp);
+            if (pos < lf->_count && !_comp(key, lf->_keys[pos])) {
+                return std::make_pair(std::make_pair(lf, pos), false);
+            }
+            if (lf->_count < leaf_slots) {
+                insertInLeaf(lf, pos, key, std::forward<Args>(args)...);
+                return std::make_pair(std::make_pair(lf, pos), true);
+            }
+
+            // 分裂叶子
+            leaf* nl = new leaf;
+            size_t mid = (pos == lf->_count && lf->_next == nullptr) ? lf->_count : lf->_count / 2;
+            for (size_t i = mid; i < lf->_count; ++i) {
+                moveSlot(nl, i - mid, lf, i);
+            }
+            nl->_count = uint16_t(lf->_count - mid);
+            lf->_count = uint16_t(mid);
+            nl->_next = lf->_next;
+            nl->_prev = lf;
+            if (lf->_next) {
+                lf->_next->_prev = nl;
+            } else {
+                _tail = nl;
+            }
+            lf->_next = nl;
+
+            std::pair<leaf*, size_t> where;
+            if (pos <= mid && mid < leaf_slots) {
+                insertInLeaf(lf, pos, key, std::forward<Args>(args)...);
+                where = std::make_pair(lf, pos);
+            } else {
+                insertInLeaf(nl, pos - mid, key, std::forward<Args>(args)...);
+                where = std::make_pair(nl, pos - mid);
+            }
+            insertInParent(path, slot, nl->_keys[0], nl);
+            return std::make_pair(where, true);
+        }
+
+        // 删除key，返回删除的元素个数
+        size_t eraseKey(const K& key) {
+            if (!_root) {
+                return 0;
+            }
+            inner* path[_max_height];
+            size_t slot[_max_height];
+            leaf* lf = descend(key, path, slot);
+            size_t pos = _branchless_lower_bound(lf->_keys, lf->_count, key, _comp);
+            if (pos == lf->_count || _comp(key, lf->_keys[pos])) {
+                return 0;
+            }
+            for (size_t i = pos + 1; i < lf->_count; ++i) {
+                moveSlot(lf, i - 1, lf, i);
+            }
+            lf->_count--;
+            _size--;
+            if (lf->_count != 0 || _height == 0) {
+                return 1;
+            }
+
+            // 叶子空了，从链表和父结点中摘掉
+            if (lf->_prev) {
+                lf->_prev->_next = lf->_next;
+            } else {
+                _head = lf->_next;
+            }
+            if (lf->_next) {
+                lf->_next->_prev = lf->_prev;
+            } else {
+                _tail = lf->_prev;
+            }
+            delete lf;
+            size_t d = _height;
+            while (d-- > 0) {
+                inner* in = path[d];
+                if (in->_count == 0) { // 只有这一个孩子，整个结点也空了
+                    delete in;
+                    if (d == 0) {
+                        _root = nullptr;
+                        _height = 0;
+                    }
+                    continue;
+                }
+                size_t ci = slot[d];
+                size_t k = ci == 0 ? 0 : ci - 1; // 和孩子一起删掉的分隔键
+                for (size_t i = k + 1; i < in->_count; ++i) {
+                    in->_keys[i - 1] = std::move(in->_keys[i]);
+                }
+                for (size_t i = ci + 1; i <= in->_count; ++i) {
+                    in->_children[i - 1] = in->_children[i];
+                }
+                in->_count--;
+                break;
+            }
+            // 根只剩一个孩子时树降低一层
+            while (_height > 0 && static_cast<inner*>(_root)->_count == 0) {
+                inner* r = static_cast<inner*>(_root);
+                _root = r->_children[0];
+                delete r;
+                _height--;
+            }
+            return 1;
+        }
+
+        /**
+         * 由有序且无重复的输入批量建树，O(n)
+         * 先把元素依次填满叶子，再自底向上每次把至多inner_slots + 1个孩子组成一个内部结点，
+         * 一层的孩子平均分配到各个结点中，分隔键是每个孩子子树中最小的键
+         */
+        template <class InputIterator>
+        void bulkLoad(InputIterator first, InputIterator last) {
+            clear();
+            leaf* lf = nullptr;
+            for (; first != last; ++first) {
+                if (lf == nullptr || lf->_count == leaf_slots) {
+                    leaf* nl = new leaf;
+                    if (lf) {
+                        lf->_next = nl;
+                        nl->_prev = lf;
+                    } else {
+                        _head = nl;
+                    }
+                    lf = nl;
+                }
+                assignSlot(lf, lf->_count, *first);
+                MY_CHECK_CHEAP(lf->_count == 0 ? (lf->_prev == nullptr || _comp(lf->_prev->_keys[lf->_prev->_count - 1], lf->_keys[0]))
+                    : _comp(lf->_keys[lf->_count - 1], lf->_keys[lf->_count])); // 输入必须严格递增
+                lf->_count++;
+                _size++;
+            }
+            _tail = lf;
+            buildInner();
+        }
+        // 从叶子链表中的一段已排好序的元素建树，拷贝构造时使用
+        void bulkLoad(leaf* src, size_t n) {
+            struct cursor {
+                leaf* _leaf;
+                size_t _index;
+                bool operator!=(const cursor& c) const { return _leaf != c._leaf || _index != c._index; }
+                cursor& operator++() {
+                    if (++_index == _leaf->_count) {
+                        _leaf = _leaf->_next;
+                        _index = 0;
+                    }
+                    return *this;
+                }
+                const cursor& operator*() const { return *this; }
+            };
+            if (n == 0) {
+                clear();
+                return;
+            }
+            bulkLoad(cursor{src, 0}, cursor{nullptr, 0});
+        }
+
+        void* _root; // 根结点，_height为0时是叶子
+        leaf* _head; // 第一个叶子
+        leaf* _tail; // 最后一个叶子
+        size_t _height; // 内部结点的层数
+        size_t _size; // 元素个数
+        [[no_unique_address]] Compare _comp; // 比较器
+
+    private:
+        // 叶子中的一个元素搬到另一个位置
+        static void moveSlot(leaf* dst, size_t di, leaf* src, size_t si) {
+            dst->_keys[di] = std::move(src->_keys[si]);
+            if constexpr (!std::is_void_v<V>) {
+                dst->_values[di] = std::move(src->_values[si]);
+            }
+        }
+
+        // 批量加载时写入一个元素：map的输入是pair，set的输入是键，拷贝构造时是叶子游标
+        template <class T>
+        static void assignSlot(leaf* lf, size_t i, const T& x) {
+            if constexpr (requires { x._leaf; }) {
+                lf->_keys[i] = x._leaf->_keys[x._index];
+                if constexpr (!std::is_void_v<V>) {
+                    lf->_values[i] = x._leaf->_values[x._index];
+                }
+            } else if constexpr (std::is_void_v<V>) {
+                lf->_keys[i] = x;
+            } else {
+                lf->_keys[i] = x.first;
+                lf->_values[i] = x.second;
+            }
+        }
+
+        // 在未满的叶子中插入
+        template <class... Args>
+        void insertInLeaf(leaf* lf, size_t pos, const K& key, Args&&... args) {
+            for (size_t i = lf->_count; i > pos; --i) {
+                moveSlot(lf, i, lf, i - 1);
+            }
+            lf->_keys[pos] = key;
+            if constexpr (!std::is_void_v<V>) {
+                lf->_values[pos] = V(std::forward<Args>(args)...);
+            }
+            lf->_count++;
+            _size++;
+        }
+
+        // 把分裂出的新结点child和分隔键sep插入父结点，父结点满了继续向上分裂
+        void insertInParent(inner** path, size_t* slot, K sep, void* child) {
+            size_t d = _height;
+            while (d-- > 0) {
+                inner* in = path[d];
+                size_t ci = slot[d];
+                if (in->_count < inner_slots) {
+                    for (size_t i = in->_count; i > ci; --i) {
+                        in->_keys[i] = std::move(in->_keys[i - 1]);
+                        in->_children[i + 1] = in->_children[i];
+                    }
+                    in->_keys[ci] = std::move(sep);
+                    in->_children[ci + 1] = child;
+                    in->_count++;
+                    return;
+                }
+                // 分裂内部结点：先合并成inner_slots + 1个键，中间的键上移，右半部分放入新结点
+                K keys[inner_slots + 1];
+                void* children[inner_slots + 2];
+                for (size_t i = 0, j = 0; i <= inner_slots; ++i) {
+                    keys[i] = i == ci ? sep : std::move(in->_keys[j++]);
+                }
+                for (size_t i = 0, j = 0; i <= inner_slots + 1; ++i) {
+                    children[i] = i == ci + 1 ? child : in->_children[j++];
+                }
+                size_t mid = (inner_slots + 1) / 2;
+                inner* right = new inner;
+                for (size_t i = 0; i < mid; ++i) {
+                    in->_keys[i] = std::move(keys[i]);
+                    in->_children[i] = children[i];
+                }
+                in->_children[mid] = children[mid];
+                in->_count = uint16_t(mid);
+                for (size_t i = mid + 1; i <= inner_slots; ++i) {
+                    right->_keys[i - mid - 1] = std::move(keys[i]);
+                    right->_children[i - mid - 1] = children[i];
+                }
+                right->_children[inner_slots - mid] = children[inner_slots + 1];
+                right->_count = uint16_t(inner_slots - mid);
+                sep = std::move(keys[mid]);
+                child = right;
+            }
+            // 根分裂，树长高一层
+            inner* r = new inner;
+            r->_count = 1;
+            r->_keys[0] = std::move(sep);
+            r->_children[0] = _root;
+            r->_children[1] = child;
+            _root = r;
+            _height++;
+        }
+
+        // 批量加载时由叶子链表自底向上建立内部结点
+        void buildInner() {
+            if (_head == nullptr) {
+                return;
+            }
+            vector<void*> level; // 当前层的结点
+            vector<K> firsts; // 每个结点子树中最小的键
+            for (leaf* lf = _head; lf; lf = lf->_next) {
+                level.push_back(lf);
+                firsts.push_back(lf->_keys[0]);
+            }
+            _height = 0;
+            while (level.size() > 1) {
+                size_t n = level.size();
+                size_t groups = (n + inner_slots) / (inner_slots + 1);
+                vector<void*> up;
+                vector<K> upFirsts;
+                for (size_t g = 0, i = 0; g < groups; ++g) {
+                    size_t cnt = n / groups + (g < n % groups); // 平均分配
+                    inner* in = new inner;
+                    for (size_t c = 0; c < cnt; ++c) {
+                        in->_children[c] = level[i + c];
+                        if (c > 0) {
+                            in->_keys[c - 1] = firsts[i + c];
+                        }
+                    }
+                    in->_count = uint16_t(cnt - 1);
+                    up.push_back(in);
+                    upFirsts.push_back(firsts[i]);
+                    i += cnt;
+                }
+                level.swap(up);
+                firsts.swap(upFirsts);
+                _height++;
+            }
+            _root = level[0];
+        }
+
+        // 递归释放以node为根、有h层内部结点的子树
+        void freeNode(void* node, size_t h) {
+            if (h == 0) {
+                delete static_cast<leaf*>(node);
+                return;
+            }
+            inner* in = static_cast<inner*>(node);
+            for (size_t i = 0; i <= in->_count; ++i) {
+                freeNode(in->_children[i], h - 1);
+            }
+            delete in;
+        }
+    };
+
+    /**
+     * B+树实现的有序映射表
+     * 插入删除会使迭代器失效（元素会在叶子内、叶子间搬移）
+     */
+    template <class K, class V, class Compare = less<K>, size_t NodeBytes = 256>
+    class btree_map : public _btree<K, V, Compare, NodeBytes> {
+        typedef _btree<K, V, Compare, NodeBytes> Base;
+        typedef typename Base::leaf leaf;
+    public:
+        typedef V mapped_type;
+        typedef std::pair<K, V> value_type;
+        typedef _btree_iterator<leaf, std::pair<const K&, V&>> iterator;
+        typedef _btree_iterator<leaf, std::pair<const K&, const V&>> const_iterator;
+
+        btree_map() {}
+        explicit btree_map(const Compare& comp) : Base(comp) {}
+        btree_map(std::initializer_list<value_type> il) {
+            for (const value_type& kv : il) {
+                insert(kv);
+            }
+        }
+
+        // 迭代器
+        iterator begin() { return wrap(this->beginPos()); }
+        iterator end() { return wrap(this->endPos()); }
+        const_iterator begin() const { return wrap(this->beginPos()); }
+        const_iterator end() const { return wrap(this->endPos()); }
+
+        // 插入，键已存在时不修改原有的值
+        std::pair<iterator, bool> insert(const value_type& kv) {
+            auto r = this->insertKey(kv.first, kv.second);
+            return std::make_pair(wrap(r.first), r.second);
+        }
+        template <class... Args>
+        std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+            auto r = this->insertKey(key, std::forward<Args>(args)...);
+            return std::make_pair(wrap(r.first), r.second);
+        }
+        V& operator[](const K& key) {
+            auto r = this->insertKey(key);
+            return r.first.first->_values[r.first.second];
+        }
+
+        // 由按键严格递增的pair序列批量建树，会先清空原有元素
+        template <class InputIterator>
+        void assign_sorted(InputIterator first, InputIterator last) {
+            this->bulkLoad(first, last);
+        }
+
+        // 删除
+        size_t erase(const K& key) {
+            return this->eraseKey(key);
+        }
+        // 删除迭代器指向的元素，返回下一个元素的迭代器
+        iterator erase(iterator pos) {
+            K key = pos->first;
+            this->eraseKey(key);
+            return lower_bound(key);
+        }
+
+        // 查找
+        iterator find(const K& key) { return wrap(this->findPos(key)); }
+        const_iterator find(const K& key) const { return wrap(this->findPos(key)); }
+        bool contains(const K& key) const { return this->findPos(key) != this->endPos(); }
+        size_t count(const K& key) const { return contains(key); }
+        iterator lower_bound(const K& key) { return wrap(this->lowerPos(key)); }
+        const_iterator lower_bound(const K& key) const { return wrap(this->lowerPos(key)); }
+        iterator upper_bound(const K& key) { return wrap(this->upperPos(key)); }
+        const_iterator upper_bound(const K& key) const { return wrap(this->upperPos(key)); }
+        V& at(const K& key) {
+            iterator it = find(key);
+            MY_CHECK_CHEAP(it != end());
+            return it->second;
+        }
+        const V& at(const K& key) const {
+            const_iterator it = find(key);
+            MY_CHECK_CHEAP(it != end());
+            return it->second;
+        }
+
+    private:
+        static iterator wrap(std::pair<leaf*, size_t> p) { return iterator(p.first, p.second); }
+    };
+
+    // B+树实现的有序集合
+    template <class K, class Compare = less<K>, size_t NodeBytes = 256>
+    class btree_set : public _btree<K, void, Compare, NodeBytes> {
+        typedef _btree<K, void, Compare, NodeBytes> Base;
+        typedef typename Base::leaf leaf;
+    public:
+        typedef K value_type;
+        typedef _btree_iterator<leaf, const K&> iterator;
+        typedef iterator const_iterator;
+
+        btree_set() {}
+        explicit btree_set(const Compare& comp) : Base(comp) {}
+        btree_set(std::initializer_list<K> il) {
+            for (const K& k : il) {
+                insert(k);
+            }
+        }
+
+        // 迭代器
+        const_iterator begin() const { return wrap(this->beginPos()); }
+        const_iterator end() const { return wrap(this->endPos()); }
+
+        // 插入
+        std::pair<const_iterator, bool> insert(const K& key) {
+            auto r = this->insertKey(key);
+            return std::make_pair(wrap(r.first), r.second);
+        }
+
+        // 由严格递增的序列批量建树，会先清空原有元素
+        template <class InputIterator>
+        void assign_sorted(InputIterator first, InputIterator last) {
+            this->bulkLoad(first, last);
+        }
+
+        // 删除
+        size_t erase(const K& key) {
+            return this->eraseKey(key);
+        }
+        const_iterator erase(const_iterator pos) {
+            K key = *pos;
+            this->eraseKey(key);
+            return lower_bound(key);
+        }
+
+        // 查找
+        const_iterator find(const K& key) const { return wrap(this->findPos(key)); }
+        bool contains(const K& key) const { return this->findPos(key) != this->endPos(); }
+        size_t count(const K& key) const { return contains(key); }
+        const_iterator lower_bound(const K& key) const { return wrap(this->lowerPos(key)); }
+        const_iterator upper_bound(const K& key) const { return wrap(this->upperPos(key)); }
+
+    private:
+        static const_iterator wrap(std::pair<leaf*, size_t> p) { return const_iterator(p.first, p.second); }
+    };
+}
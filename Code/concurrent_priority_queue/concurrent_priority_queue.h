@@ -0,0 +1,183 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "../priority_queue/priority_queue.h"
+
+// 自旋等待时提示CPU降低功耗、让出流水线给同一核心上的另一个超线程
+#ifndef MY_CPU_RELAX
+#if defined(__x86_64__) || defined(__i386__)
+#define MY_CPU_RELAX() __builtin_ia32_pause()
+#else
+#define MY_CPU_RELAX() ((void)0)
+#endif
+#endif
+
+namespace my {
+    /**
+     * 并发优先队列（MultiQueue，松弛有序）
+     * 1、内部维护 c*P 个子堆（P为线程数），每个子堆是一个带互斥锁的my::priority_queue。
+     * 2、push时随机选择一个子堆插入，多个线程几乎不会争用同一把锁。
+     * 3、pop时随机选两个子堆，比较堆顶后从更优的那个弹出（two-choice），
+     *    因此弹出的不一定是全局最优元素，但期望的排名误差只与子堆个数成正比。
+     * 适合调度器这类只要求“大致有序”、更看重吞吐量的场景。
+     */
+    template <class T, class Container = std::vector<T>, class Compare = less<T>>
+    class concurrent_priority_queue {
+    public:
+        concurrent_priority_queue(size_t threads = std::thread::hardware_concurrency(), size_t c = 2); // 构造函数
+        concurrent_priority_queue(const concurrent_priority_queue&) = delete;
+        concurrent_priority_queue& operator=(const concurrent_priority_queue&) = delete;
+
+        void push(const T& x); // 插入元素
+        bool try_pop(T& out); // 弹出一个（近似）最优元素，没有取到时返回false（并发修改时队列不一定真的为空）
+        size_t size() const; // 获取元素个数（并发修改时为近似值）
+        bool empty() const; // 检查队列是否为空（并发修改时为近似值）
+
+    private:
+        // 子堆，按缓存行对齐，避免相邻子堆的锁产生伪共享
+        struct alignas(64) _sub_queue {
+            std::mutex _mtx;
+            priority_queue<T, Container, Compare> _pq;
+        };
+
+        size_t randomIndex(); // 生成一个随机的子堆下标
+        bool popFrom(_sub_queue& q, T& out); // 从指定子堆弹出堆顶（调用方已加锁）
+        bool scanPop(T& out); // 依次扫描所有子堆，弹出遇到的第一个元素
+        void backoff(size_t attempt); // 加锁失败后的退避
+
+        std::vector<_sub_queue> _queues; // 子堆数组
+        std::atomic<size_t> _size; // 所有子堆的元素总数
+        Compare _compare; // 比较方式
+    };
+
+    // 并发优先队列具体实现
+
+    // 构造函数，子堆个数为 c * threads，至少为2个以便two-choice
+    template <class T, class Container, class Compare>
+    concurrent_priority_queue<T, Container, Compare>::concurrent_priority_queue(size_t threads, size_t c)
+        : _queues(std::max<size_t>(2, c * (threads == 0 ? 1 : threads)))
+        , _size(0)
+    {}
+
+    // 生成一个随机的子堆下标，每个线程独立的随机数引擎，无需同步
+    template <class T, class Container, class Compare>
+    size_t concurrent_priority_queue<T, Container, Compare>::randomIndex() {
+        thread_local std::minstd_rand engine(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        return engine() % _queues.size();
+    }
+
+    // 每次失败先用pause稍等；平均每个子堆都试过一次仍然失败，说明持锁线程可能被挂起，让出CPU
+    template <class T, class Container, class Compare>
+    void concurrent_priority_queue<T, Container, Compare>::backoff(size_t attempt) {
+        if (attempt % _queues.size() == 0) {
+            std::this_thread::yield();
+        } else {
+            MY_CPU_RELAX();
+        }
+    }
+
+    // 插入元素，随机选择子堆，锁被占用时换一个子堆重试，而不是原地等待
+    template <class T, class Container, class Compare>
+    void concurrent_priority_queue<T, Container, Compare>::push(const T& x) {
+        for (size_t attempt = 1; ; attempt++) {
+            _sub_queue& q = _queues[randomIndex()];
+            if (q._mtx.try_lock()) {
+                q._pq.push(x);
+                _size.fetch_add(1, std::memory_order_release); // 在锁内计数，保证弹出时计数不会先于插入减少
+                q._mtx.unlock();
+                return;
+            }
+            backoff(attempt);
+        }
+    }
+
+    // 从指定子堆弹出堆顶，调用方需已持有该子堆的锁
+    template <class T, class Container, class Compare>
+    bool concurrent_priority_queue<T, Container, Compare>::popFrom(_sub_queue& q, T& out) {
+        if (q._pq.empty()) {
+            return false;
+        }
+        out = std::move(q._pq.top());
+        q._pq.pop();
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 依次扫描所有子堆，弹出遇到的第一个非空子堆的堆顶
+    // 每次只锁一个子堆，扫描不是原子的：扫过的子堆之后又被插入、或者元素被其他线程先弹走，都可能扫不到
+    template <class T, class Container, class Compare>
+    bool concurrent_priority_queue<T, Container, Compare>::scanPop(T& out) {
+        for (auto& q : _queues) {
+            std::lock_guard<std::mutex> lock(q._mtx);
+            if (popFrom(q, out)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * 弹出一个（近似）最优元素
+     * 1、随机选取两个不同的子堆，都加锁成功后比较堆顶，从更优的那个弹出。
+     * 2、加锁失败或两个子堆都为空时退避后重试；连续多次失败则退化为顺序扫描。
+     * 没有其他线程同时修改时，队列非空就一定能弹出；并发插入、弹出时扫描不是原子的，
+     * 可能在队列实际非空时返回false，调用方应把false当作“暂时没有取到”，稍后再试。
+     */
+    template <class T, class Container, class Compare>
+    bool concurrent_priority_queue<T, Container, Compare>::try_pop(T& out) {
+        const size_t max_attempts = _queues.size();
+        for (size_t attempt = 0; attempt < max_attempts; attempt++) {
+            if (_size.load(std::memory_order_acquire) == 0) {
+                return false;
+            }
+            size_t i = randomIndex();
+            size_t j = randomIndex();
+            if (i == j) {
+                j = (j + 1) % _queues.size();
+            }
+            _sub_queue& a = _queues[i];
+            _sub_queue& b = _queues[j];
+            if (!a._mtx.try_lock()) {
+                backoff(attempt + 1);
+                continue;
+            }
+            if (!b._mtx.try_lock()) {
+                a._mtx.unlock();
+                backoff(attempt + 1);
+                continue;
+            }
+            _sub_queue* best = nullptr;
+            if (a._pq.empty()) {
+                best = b._pq.empty() ? nullptr : &b;
+            } else if (b._pq.empty()) {
+                best = &a;
+            } else {
+                best = _compare(a._pq.top(), b._pq.top()) ? &b : &a; // 通过给定的比较器选出更优的堆顶
+            }
+            bool ok = best != nullptr && popFrom(*best, out);
+            b._mtx.unlock();
+            a._mtx.unlock();
+            if (ok) {
+                return true;
+            }
+        }
+        return scanPop(out);
+    }
+
+    // 获取元素个数
+    template <class T, class Container, class Compare>
+    size_t concurrent_priority_queue<T, Container, Compare>::size() const {
+        return _size.load(std::memory_order_acquire);
+    }
+
+    // 检查队列是否为空
+    template <class T, class Container, class Compare>
+    bool concurrent_priority_queue<T, Container, Compare>::empty() const {
+        return size() == 0;
+    }
+}
@@ -0,0 +1,171 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <random>
+#include <thread>
+#include <utility>
+#include "../hazard_pointer/hazard_pointer.h"
+
+// 自旋等待时提示CPU降低功耗、让出流水线给同一核心上的另一个超线程
+#ifndef MY_CPU_RELAX
+#if defined(__x86_64__) || defined(__i386__)
+#define MY_CPU_RELAX() __builtin_ia32_pause()
+#else
+#define MY_CPU_RELAX() ((void)0)
+#endif
+#endif
+
+namespace my {
+    /**
+     * 无锁栈（Treiber栈）
+     * 1、栈顶是一个原子指针，push/pop都是一次CAS，不加锁，任何线程被挂起都不会阻塞其他线程。
+     * 2、pop读取栈顶节点的next之前先用风险指针保护该节点，节点被摘下后交给hazard_retire延迟释放：
+     *    别的线程还在读的节点不会被释放，也不会被重新分配到同一个地址，CAS不会遇到ABA问题。
+     * 3、消除退避（elimination backoff）：CAS因竞争失败时，push把节点挂到消除数组的一个随机槽位上等一小会，
+     *    同时失败的pop从槽位上直接取走节点。一对push/pop互相抵消，都不用再访问栈顶，
+     *    竞争越激烈配对成功的机会越大，栈顶不再是唯一的热点。
+     * 适合多线程共享的空闲列表（free-list）这类后进先出的场景。
+     */
+    template <class T>
+    class concurrent_stack {
+    public:
+        concurrent_stack() = default;
+        concurrent_stack(const concurrent_stack&) = delete;
+        concurrent_stack& operator=(const concurrent_stack&) = delete;
+        ~concurrent_stack(); // 析构时不能再有其他线程访问
+
+        void push(const T& x) { pushNode(new _node(x)); }
+        void push(T&& x) { pushNode(new _node(std::move(x))); }
+        template <class... Args>
+        void emplace(Args&&... args) { pushNode(new _node(std::forward<Args>(args)...)); }
+        bool try_pop(T& out); // 弹出栈顶元素，栈为空时返回false
+        bool empty() const { return _head.load(std::memory_order_acquire) == nullptr; } // 并发修改时为近似值
+
+    private:
+        struct _node {
+            template <class... Args>
+            explicit _node(Args&&... args) : _value(std::forward<Args>(args)...) {}
+
+            T _value;
+            _node* _next = nullptr;
+        };
+
+        // 消除数组的槽位，按缓存行对齐，避免相邻槽位伪共享
+        struct alignas(64) _slot {
+            std::atomic<_node*> _offer{nullptr}; // 等待配对的push挂上来的节点
+        };
+
+        // pop取走节点后在槽位上留下的标记，由挂节点的push清空；在此之前别的push不能使用该槽位，
+        // 否则节点被释放后地址被新节点复用并挂到同一槽位上时，原来的push会把别人的节点撤回（ABA）
+        static _node* taken() { return reinterpret_cast<_node*>(alignof(_node)); }
+
+        static constexpr size_t Slots = 8; // 消除数组大小
+        static constexpr int Spins = 128; // push在槽位上等待配对的轮数
+
+        void pushNode(_node* n);
+        bool eliminatePush(_node* n); // 在消除数组上等待一个pop，成功时节点已被取走
+        _node* eliminatePop(); // 从消除数组上取走一个等待中的push的节点
+        static size_t randomSlot();
+
+        alignas(64) std::atomic<_node*> _head{nullptr};
+        _slot _slots[Slots];
+    };
+
+    // 无锁栈具体实现
+
+    template <class T>
+    concurrent_stack<T>::~concurrent_stack() {
+        _node* n = _head.load(std::memory_order_relaxed);
+        while (n) {
+            _node* next = n->_next;
+            delete n;
+            n = next;
+        }
+    }
+
+    // 每个线程独立的随机数引擎，无需同步
+    template <class T>
+    size_t concurrent_stack<T>::randomSlot() {
+        thread_local std::minstd_rand engine(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        return engine() % Slots;
+    }
+
+    // release保证节点内容在节点可见之前已经写好
+    template <class T>
+    void concurrent_stack<T>::pushNode(_node* n) {
+        n->_next = _head.load(std::memory_order_relaxed);
+        while (true) {
+            if (_head.compare_exchange_weak(n->_next, n, std::memory_order_release, std::memory_order_relaxed)) {
+                return;
+            }
+            if (eliminatePush(n)) {
+                return;
+            }
+            n->_next = _head.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * 弹出栈顶
+     * 先用风险指针保护读到的栈顶，再读它的next：此时即使别的线程已经把它弹出，它也不会被释放
+     * CAS成功后节点只属于当前线程，取出值后交给hazard_retire，等没有风险指针保护时再释放
+     */
+    template <class T>
+    bool concurrent_stack<T>::try_pop(T& out) {
+        hazard_pointer hp;
+        while (true) {
+            _node* h = hp.protect(_head);
+            if (!h) {
+                return false;
+            }
+            _node* next = h->_next;
+            if (_head.compare_exchange_weak(h, next, std::memory_order_acquire, std::memory_order_relaxed)) {
+                hp.reset();
+                out = std::move(h->_value);
+                hazard_retire(h);
+                return true;
+            }
+            if (_node* n = eliminatePop()) { // 与一个同时进行的push抵消，节点从未进入栈，直接释放
+                hp.reset();
+                out = std::move(n->_value);
+                delete n;
+                return true;
+            }
+        }
+    }
+
+    // 槽位空闲时挂上节点，等待一会；槽位变成taken或撤回失败，说明已被某个pop取走，清空槽位
+    template <class T>
+    bool concurrent_stack<T>::eliminatePush(_node* n) {
+        _slot& s = _slots[randomSlot()];
+        _node* expected = nullptr;
+        if (!s._offer.compare_exchange_strong(expected, n, std::memory_order_release, std::memory_order_relaxed)) {
+            return false;
+        }
+        for (int i = 0; i < Spins; i++) {
+            if (s._offer.load(std::memory_order_relaxed) == taken()) {
+                s._offer.store(nullptr, std::memory_order_relaxed);
+                return true;
+            }
+            MY_CPU_RELAX();
+        }
+        expected = n;
+        if (s._offer.compare_exchange_strong(expected, nullptr, std::memory_order_relaxed, std::memory_order_relaxed)) {
+            return false; // 撤回成功，没有配对
+        }
+        s._offer.store(nullptr, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 与push的撤回竞争同一次CAS，只有一方成功，取走的节点只属于当前线程
+    template <class T>
+    typename concurrent_stack<T>::_node* concurrent_stack<T>::eliminatePop() {
+        _slot& s = _slots[randomSlot()];
+        _node* n = s._offer.load(std::memory_order_relaxed);
+        if (n && n != taken() && s._offer.compare_exchange_strong(n, taken(), std::memory_order_acquire, std::memory_order_relaxed)) {
+            return n;
+        }
+        return nullptr;
+    }
+}
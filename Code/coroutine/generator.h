@@ -0,0 +1,120 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace my {
+    /**
+     * 惰性生成器（C++20协程）
+     * 协程体用co_yield逐个产出元素，调用方用范围for逐个取走，取一个才往下执行一步，
+     * 整个序列不会同时存在于内存中
+     * co_yield的左值或临时对象在协程恢复之前一直有效，迭代器直接指向它，不拷贝；
+     * 只有co_yield一个const左值时才拷贝一份
+     * 生成器只能遍历一次，不能拷贝，可以移动
+     */
+    template <class T>
+    class generator {
+    public:
+        struct promise_type {
+            T* _value = nullptr; // 当前产出的元素
+            std::optional<T> _copy; // co_yield const左值时保存的副本
+            std::exception_ptr _exception;
+
+            generator get_return_object() {
+                return generator(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept { return {}; } // 创建后不执行，第一次取元素时才开始
+            std::suspend_always final_suspend() noexcept { return {}; }
+            std::suspend_always yield_value(T& value) noexcept {
+                _value = std::addressof(value);
+                return {};
+            }
+            std::suspend_always yield_value(T&& value) noexcept {
+                _value = std::addressof(value);
+                return {};
+            }
+            std::suspend_always yield_value(const T& value) {
+                _copy.emplace(value);
+                _value = std::addressof(*_copy);
+                return {};
+            }
+            void return_void() noexcept {}
+            void unhandled_exception() { _exception = std::current_exception(); } // 在取元素的地方重新抛出
+
+            // 生成器由调用方同步驱动，协程体中不能co_await
+            template <class U>
+            std::suspend_never await_transform(U&&) = delete;
+        };
+
+        typedef std::coroutine_handle<promise_type> handle;
+
+        class iterator {
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef std::ptrdiff_t difference_type;
+            typedef T value_type;
+            typedef T& reference;
+            typedef T* pointer;
+
+            iterator() = default;
+            explicit iterator(handle h) : _h(h) {}
+
+            T& operator*() const { return *_h.promise()._value; }
+            T* operator->() const { return _h.promise()._value; }
+            iterator& operator++() {
+                advance(_h);
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+            bool operator==(std::default_sentinel_t) const { return !_h || _h.done(); }
+
+        private:
+            handle _h;
+        };
+
+        generator() = default;
+        generator(const generator&) = delete;
+        generator& operator=(const generator&) = delete;
+        generator(generator&& g) noexcept : _h(std::exchange(g._h, nullptr)) {}
+        generator& operator=(generator&& g) noexcept {
+            if (this != &g) {
+                if (_h) {
+                    _h.destroy();
+                }
+                _h = std::exchange(g._h, nullptr);
+            }
+            return *this;
+        }
+        ~generator() {
+            if (_h) {
+                _h.destroy();
+            }
+        }
+
+        // 开始执行，直到产出第一个元素或者结束
+        iterator begin() {
+            if (_h) {
+                advance(_h);
+            }
+            return iterator(_h);
+        }
+        std::default_sentinel_t end() const noexcept { return {}; }
+
+    private:
+        explicit generator(handle h) : _h(h) {}
+
+        // 恢复协程执行到下一个co_yield，协程体抛出的异常在这里重新抛出
+        static void advance(handle h) {
+            h.promise()._copy.reset();
+            h.resume();
+            if (h.promise()._exception) {
+                std::rethrow_exception(std::exchange(h.promise()._exception, nullptr));
+            }
+        }
+
+        handle _h;
+    };
+}
@@ -0,0 +1,314 @@
+#pragma once
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "generator.h"
+#include "task.h"
+#include "../hardening/hardening.h"
+#include "../queue/queue.h"
+#include "../vector/vector.h"
+
+namespace my {
+    class pipeline;
+
+    class _channel_base {
+    public:
+        virtual ~_channel_base() = default;
+    };
+
+    /**
+     * 连接流水线上相邻两个阶段的有界通道，一个发送端、一个接收端
+     * 元素按批传递：发送端先攒满batch个元素，再把整批放入队列（my::queue），
+     * 队列中最多有capacity批，满了发送端就挂起，直到接收端取走一批（背压）；
+     * 接收端取空后挂起，直到有新的一批或通道关闭
+     * 协程只在整批交接时切换，每个元素的开销只是一次vector尾插和一次读取
+     * 流水线中间最多同时存在 capacity + 2 批数据，与输入总量无关
+     */
+    template <class T>
+    class channel : public _channel_base {
+    public:
+        channel(pipeline& p, size_t capacity, size_t batch);
+        channel(const channel&) = delete;
+        channel& operator=(const channel&) = delete;
+
+        // 发送端：co_await ch.push(v)，下游已满时挂起
+        auto push(T value) {
+            struct awaiter {
+                channel* _ch;
+                T _value;
+
+                bool await_ready() {
+                    MY_CHECK_CHEAP(!_ch->_closed); // 关闭后不能再发送
+                    _ch->_sending.push_back(std::move(_value));
+                    if (_ch->_sending.size() < _ch->_batch) {
+                        return true;
+                    }
+                    if (_ch->_batches.size() < _ch->_capacity) {
+                        _ch->send();
+                        return true;
+                    }
+                    return false; // 下游已满，攒好的这一批留在_sending中，由接收端腾出位置后放入
+                }
+                void await_suspend(std::coroutine_handle<> h) noexcept { _ch->_sender = h; }
+                void await_resume() noexcept {}
+            };
+            return awaiter{this, std::move(value)};
+        }
+
+        // 发送端：不再发送，未攒满的最后一批也交给接收端
+        void close();
+
+        // 接收端：co_await ch.pop()，通道已关闭并且取完时返回空
+        auto pop() {
+            struct awaiter {
+                channel* _ch;
+
+                bool await_ready() { return _ch->refill() || _ch->_closed; }
+                void await_suspend(std::coroutine_handle<> h) noexcept {
+                    MY_CHECK_CHEAP(!_ch->_receiver); // 只能有一个接收端
+                    _ch->_receiver = h;
+                }
+                std::optional<T> await_resume() {
+                    if (!_ch->refill()) {
+                        return std::nullopt;
+                    }
+                    return std::move(_ch->_receiving[_ch->_readPos++]);
+                }
+            };
+            return awaiter{this};
+        }
+
+        size_t capacity() const { return _capacity; }
+        size_t batch_size() const { return _batch; }
+        bool closed() const { return _closed; }
+
+    private:
+        void send(); // 把攒好的一批放入队列，唤醒接收端
+        bool refill(); // 确保_receiving中还有未读的元素，没有数据时返回false
+
+        pipeline* _pipeline;
+        size_t _capacity; // 队列中最多的批数
+        size_t _batch; // 每批的元素个数
+        vector<T> _sending; // 发送端正在攒的一批
+        queue<vector<T>> _batches; // 已发送、尚未被接收端取走的批
+        vector<T> _receiving; // 接收端正在读的一批
+        size_t _readPos = 0;
+        vector<T> _spare; // 接收端读完的批，清空后留给发送端复用，不用重新申请内存
+        std::coroutine_handle<> _sender; // 因下游已满而挂起的发送端
+        std::coroutine_handle<> _receiver; // 因没有数据而挂起的接收端
+        bool _closed = false;
+    };
+
+    /**
+     * 单线程协程流水线
+     * 每个阶段是一个task，阶段之间用channel连接，流式处理任意大的输入而不把中间结果整体存下来
+     * 调度器是一个就绪队列：阶段在通道上挂起时让出执行权，通道状态改变后被放回就绪队列
+     *
+     *     pipeline p;
+     *     auto& lines = p.make_channel<string>();
+     *     auto& nums = p.make_channel<long long>(4, 1024);
+     *     p.source(readLines(file), lines);
+     *     p.transform(lines, nums, [](string s) { long long v = 0; parse_int(s, v); return v; });
+     *     long long sum = 0;
+     *     p.sink(nums, [&](long long v) { sum += v; });
+     *     p.run();
+     */
+    class pipeline {
+    public:
+        pipeline() = default;
+        pipeline(const pipeline&) = delete;
+        pipeline& operator=(const pipeline&) = delete;
+
+        // 创建一个通道，队列中最多capacity批、每批batch个元素，通道的生命周期与流水线相同
+        template <class T>
+        channel<T>& make_channel(size_t capacity = 4, size_t batch = 256);
+
+        void spawn(task<> t); // 加入一个自定义阶段
+
+        // 常用阶段
+        template <class T>
+        void source(generator<T> g, channel<T>& out); // 把生成器产出的元素送入out
+        template <class T, class Pred>
+        void filter(channel<T>& in, channel<T>& out, Pred pred); // 只保留pred为真的元素
+        template <class T, class U, class F>
+        void transform(channel<T>& in, channel<U>& out, F f); // 把f的结果送入out
+        template <class T, class F>
+        void sink(channel<T>& in, F f); // 对每个元素调用f
+
+        // 运行到所有阶段结束；某个阶段抛出的异常在这里重新抛出
+        // 有阶段永远等不到数据（忘记close通道）时抛出std::logic_error
+        void run();
+
+    private:
+        template <class T>
+        friend class channel;
+
+        void schedule(std::coroutine_handle<> h) { _ready.push(h); }
+
+        template <class T>
+        static task<> sourceStage(generator<T> g, channel<T>& out);
+        template <class T, class Pred>
+        static task<> filterStage(channel<T>& in, channel<T>& out, Pred pred);
+        template <class T, class U, class F>
+        static task<> transformStage(channel<T>& in, channel<U>& out, F f);
+        template <class T, class F>
+        static task<> sinkStage(channel<T>& in, F f);
+
+        std::vector<std::unique_ptr<_channel_base>> _channels; // 在_tasks之后析构，阶段销毁时通道还在
+        std::vector<task<>> _tasks;
+        queue<std::coroutine_handle<>> _ready; // 就绪队列
+    };
+
+    // channel具体实现
+
+    template <class T>
+    channel<T>::channel(pipeline& p, size_t capacity, size_t batch)
+        : _pipeline(&p)
+        , _capacity(capacity)
+        , _batch(batch)
+    {
+        MY_CHECK_CHEAP(capacity > 0 && batch > 0);
+        _sending.reserve(batch);
+    }
+
+    template <class T>
+    void channel<T>::send() {
+        _batches.push(std::move(_sending));
+        _sending.swap(_spare); // 移动后_sending为空，换上接收端读完的那一批
+        if (_sending.capacity() == 0) {
+            _sending.reserve(_batch);
+        }
+        if (_receiver) {
+            _pipeline->schedule(std::exchange(_receiver, nullptr));
+        }
+    }
+
+    template <class T>
+    bool channel<T>::refill() {
+        if (_readPos < _receiving.size()) {
+            return true;
+        }
+        if (_batches.empty()) {
+            return false;
+        }
+        if (_spare.capacity() == 0) {
+            _receiving.clear();
+            _receiving.swap(_spare);
+        }
+        _receiving = std::move(_batches.front());
+        _batches.pop();
+        _readPos = 0;
+        // 队列腾出了位置，把挂起的发送端攒好的那一批放进去，再让它继续
+        if (_sender) {
+            send();
+            _pipeline->schedule(std::exchange(_sender, nullptr));
+        }
+        return true;
+    }
+
+    template <class T>
+    void channel<T>::close() {
+        if (_closed) {
+            return;
+        }
+        if (!_sending.empty()) {
+            _batches.push(std::move(_sending)); // 最后一批不受capacity限制
+        }
+        _closed = true;
+        if (_receiver) {
+            _pipeline->schedule(std::exchange(_receiver, nullptr));
+        }
+    }
+
+    // pipeline具体实现
+
+    template <class T>
+    channel<T>& pipeline::make_channel(size_t capacity, size_t batch) {
+        channel<T>* ch = new channel<T>(*this, capacity, batch);
+        _channels.emplace_back(ch);
+        return *ch;
+    }
+
+    inline void pipeline::spawn(task<> t) {
+        schedule(t._h);
+        _tasks.push_back(std::move(t));
+    }
+
+    template <class T>
+    void pipeline::source(generator<T> g, channel<T>& out) {
+        spawn(sourceStage(std::move(g), out));
+    }
+
+    template <class T, class Pred>
+    void pipeline::filter(channel<T>& in, channel<T>& out, Pred pred) {
+        spawn(filterStage(in, out, std::move(pred)));
+    }
+
+    template <class T, class U, class F>
+    void pipeline::transform(channel<T>& in, channel<U>& out, F f) {
+        spawn(transformStage(in, out, std::move(f)));
+    }
+
+    template <class T, class F>
+    void pipeline::sink(channel<T>& in, F f) {
+        spawn(sinkStage(in, std::move(f)));
+    }
+
+    // 阶段的参数都按值传入，保存在协程帧中；通道由流水线持有，传引用
+    template <class T>
+    task<> pipeline::sourceStage(generator<T> g, channel<T>& out) {
+        for (T& v : g) {
+            co_await out.push(std::move(v));
+        }
+        out.close();
+    }
+
+    template <class T, class Pred>
+    task<> pipeline::filterStage(channel<T>& in, channel<T>& out, Pred pred) {
+        while (std::optional<T> v = co_await in.pop()) {
+            if (pred(*v)) {
+                co_await out.push(std::move(*v));
+            }
+        }
+        out.close();
+    }
+
+    template <class T, class U, class F>
+    task<> pipeline::transformStage(channel<T>& in, channel<U>& out, F f) {
+        while (std::optional<T> v = co_await in.pop()) {
+            co_await out.push(f(std::move(*v)));
+        }
+        out.close();
+    }
+
+    template <class T, class F>
+    task<> pipeline::sinkStage(channel<T>& in, F f) {
+        while (std::optional<T> v = co_await in.pop()) {
+            f(std::move(*v));
+        }
+    }
+
+    inline void pipeline::run() {
+        while (!_ready.empty()) {
+            std::coroutine_handle<> h = _ready.front();
+            _ready.pop();
+            h.resume();
+        }
+        for (task<>& t : _tasks) {
+            if (t.done() && t._h.promise()._exception) {
+                std::rethrow_exception(t._h.promise()._exception);
+            }
+        }
+        for (task<>& t : _tasks) {
+            if (!t.done()) {
+                throw std::logic_error("my::pipeline: a stage is blocked forever, was a channel not closed?");
+            }
+        }
+        _tasks.clear();
+    }
+}
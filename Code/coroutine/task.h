@@ -0,0 +1,139 @@
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include "../hardening/hardening.h"
+
+namespace my {
+    template <class T = void>
+    class task;
+
+    class pipeline;
+
+    // task的promise中与返回值类型无关的部分
+    struct _task_promise_base {
+        std::coroutine_handle<> _continuation; // 等待本任务的协程，结束时转去执行它
+        std::exception_ptr _exception;
+
+        // 结束时对称转移到等待者，没有等待者（被调度器直接驱动）就返回调度器
+        struct _final_awaiter {
+            bool await_ready() noexcept { return false; }
+            template <class Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+                std::coroutine_handle<> c = h.promise()._continuation;
+                return c ? c : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+
+        std::suspend_always initial_suspend() noexcept { return {}; } // 惰性启动，被co_await或调度时才开始执行
+        _final_awaiter final_suspend() noexcept { return {}; }
+        void unhandled_exception() { _exception = std::current_exception(); }
+    };
+
+    template <class T>
+    struct _task_promise : _task_promise_base {
+        std::optional<T> _value; // T不一定有默认构造函数
+
+        task<T> get_return_object();
+        template <class U>
+        void return_value(U&& value) { _value.emplace(std::forward<U>(value)); }
+        T result() {
+            if (_exception) {
+                std::rethrow_exception(_exception);
+            }
+            return std::move(*_value);
+        }
+    };
+
+    template <>
+    struct _task_promise<void> : _task_promise_base {
+        task<void> get_return_object();
+        void return_void() noexcept {}
+        void result() {
+            if (_exception) {
+                std::rethrow_exception(_exception);
+            }
+        }
+    };
+
+    /**
+     * 惰性异步任务（C++20协程）
+     * 创建后不执行，被另一个协程co_await时才开始，结束后直接恢复等待者（对称转移），不经过调度器
+     * 返回值或异常在co_await处取得；不能拷贝，可以移动，析构时销毁协程帧
+     * 顶层任务交给pipeline调度，或者用sync_wait在当前线程同步执行
+     */
+    template <class T>
+    class task {
+    public:
+        typedef _task_promise<T> promise_type;
+        typedef std::coroutine_handle<promise_type> handle;
+
+        task() = default;
+        task(const task&) = delete;
+        task& operator=(const task&) = delete;
+        task(task&& t) noexcept : _h(std::exchange(t._h, nullptr)) {}
+        task& operator=(task&& t) noexcept {
+            if (this != &t) {
+                if (_h) {
+                    _h.destroy();
+                }
+                _h = std::exchange(t._h, nullptr);
+            }
+            return *this;
+        }
+        ~task() {
+            if (_h) {
+                _h.destroy();
+            }
+        }
+
+        bool done() const { return !_h || _h.done(); }
+
+        // co_await一个任务：记下等待者后直接转去执行该任务
+        auto operator co_await() noexcept {
+            struct awaiter {
+                handle _h;
+
+                bool await_ready() noexcept { return !_h || _h.done(); }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+                    _h.promise()._continuation = caller;
+                    return _h;
+                }
+                T await_resume() { return _h.promise().result(); }
+            };
+            return awaiter{_h};
+        }
+
+    private:
+        friend struct _task_promise<T>;
+        friend class pipeline;
+        template <class U>
+        friend U sync_wait(task<U> t);
+
+        explicit task(handle h) : _h(h) {}
+
+        handle _h;
+    };
+
+    template <class T>
+    task<T> _task_promise<T>::get_return_object() {
+        return task<T>(std::coroutine_handle<_task_promise<T>>::from_promise(*this));
+    }
+
+    inline task<void> _task_promise<void>::get_return_object() {
+        return task<void>(std::coroutine_handle<_task_promise<void>>::from_promise(*this));
+    }
+
+    /**
+     * 在当前线程执行任务直到结束，返回结果或重新抛出异常
+     * 只适用于只等待其他task的任务；等待channel的任务要交给pipeline调度
+     */
+    template <class T>
+    T sync_wait(task<T> t) {
+        t._h.resume();
+        MY_CHECK_CHEAP(t._h.done()); // 任务挂起在了需要调度器恢复的地方
+        return t._h.promise().result();
+    }
+}
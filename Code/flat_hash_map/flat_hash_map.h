@@ -0,0 +1,535 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <type_traits>
+#include <iterator>
+#include <tuple>
+#include <initializer_list>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "hash.h"
+#include "../hardening/hardening.h"
+
+namespace my {
+    /**
+     * 开放寻址哈希表（Swiss table）
+     * 元素直接存放在一段连续的槽数组中，另有一个控制字节数组，每个槽对应一个控制字节：
+     * 空槽为-128，有元素的槽保存哈希值的低7位（h2）
+     * 查找时一次取16个控制字节，用SSE2一条指令同时和h2比较，只有控制字节相等的槽才需要真正比较键
+     * 冲突采用线性探测，删除时把后面的元素往前移（backward shift），不留墓碑，
+     * 因此大量删除之后查找也不会变慢
+     */
+
+    // 控制字节组，一组16个
+    struct _ctrl_group {
+        static constexpr size_t width = 16;
+        static constexpr int8_t empty = -128;
+
+#if defined(__SSE2__)
+        __m128i _ctrl;
+        explicit _ctrl_group(const int8_t* p) : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+        // 控制字节等于h2的位置，第i位为1表示第i个槽匹配
+        uint32_t match(int8_t h2) const {
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(_ctrl, _mm_set1_epi8(h2)));
+        }
+        // 空槽的位置，空槽最高位为1而满槽最高位为0，直接取最高位即可
+        uint32_t matchEmpty() const {
+            return _mm_movemask_epi8(_ctrl);
+        }
+#else
+        const int8_t* _ctrl;
+        explicit _ctrl_group(const int8_t* p) : _ctrl(p) {}
+        uint32_t match(int8_t h2) const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < width; ++i) {
+                mask |= uint32_t(_ctrl[i] == h2) << i;
+            }
+            return mask;
+        }
+        uint32_t matchEmpty() const {
+            return match(empty);
+        }
+#endif
+    };
+
+    // 哈希表的迭代器，跳过空槽
+    template <class Slot, class Ref, class Ptr>
+    struct _flat_hash_iterator {
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Slot value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Ptr pointer;
+        typedef Ref reference;
+        typedef _flat_hash_iterator<Slot, Ref, Ptr> Self;
+
+        const int8_t* _ctrl;
+        Slot* _slot;
+        const int8_t* _last; // 最后一个槽的控制字节之后
+
+        _flat_hash_iterator() : _ctrl(nullptr), _slot(nullptr), _last(nullptr) {}
+        _flat_hash_iterator(const int8_t* ctrl, Slot* slot, const int8_t* last)
+            : _ctrl(ctrl), _slot(slot), _last(last) {
+            skipEmpty();
+        }
+        // 普通迭代器可以转换成const迭代器
+        _flat_hash_iterator(const _flat_hash_iterator<Slot, Slot&, Slot*>& it)
+            : _ctrl(it._ctrl), _slot(it._slot), _last(it._last) {}
+        Self& operator=(const Self& it) = default;
+
+        Ref operator*() const { return *_slot; }
+        Ptr operator->() const { return _slot; }
+        Self& operator++() {
+            ++_ctrl;
+            ++_slot;
+            skipEmpty();
+            return *this;
+        }
+        Self operator++(int) {
+            Self tmp(*this);
+            ++*this;
+            return tmp;
+        }
+        bool operator==(const Self& it) const { return _slot == it._slot; }
+        bool operator!=(const Self& it) const { return _slot != it._slot; }
+
+        void skipEmpty() {
+            while (_ctrl != _last && *_ctrl == _ctrl_group::empty) {
+                ++_ctrl;
+                ++_slot;
+            }
+        }
+    };
+
+    // 哈希表的公共部分，KeyOf从槽中取出键，flat_hash_map和flat_hash_set在此基础上封装
+    template <class Key, class Slot, class KeyOf, class Hash, class Eq>
+    class _flat_hash_table {
+    public:
+        typedef Key key_type;
+        typedef Slot value_type;
+        typedef Hash hasher;
+        typedef Eq key_equal;
+        typedef size_t size_type;
+        typedef _flat_hash_iterator<Slot, Slot&, Slot*> iterator;
+        typedef _flat_hash_iterator<Slot, const Slot&, const Slot*> const_iterator;
+
+        // Hash和Eq都声明了is_transparent时支持异构查找
+        template <class H, class E>
+        static constexpr bool _is_transparent = requires { typename H::is_transparent; typename E::is_transparent; };
+        static constexpr bool transparent = _is_transparent<Hash, Eq>;
+
+        _flat_hash_table() : _ctrl(nullptr), _slots(nullptr), _size(0), _capacity(0) {}
+        // 指定哈希函数和相等比较，并预留n个元素的空间
+        _flat_hash_table(size_t n, const Hash& hash, const Eq& eq)
+            : _ctrl(nullptr), _slots(nullptr), _size(0), _capacity(0), _hash(hash), _eq(eq) {
+            reserve(n);
+        }
+        // 拷贝时哈希函数和相等比较一起拷贝，带状态（如带随机种子）的哈希函数在副本中保持一致
+        _flat_hash_table(const _flat_hash_table& t)
+            : _ctrl(nullptr), _slots(nullptr), _size(0), _capacity(0), _hash(t._hash), _eq(t._eq) {
+            reserve(t._size);
+            for (const Slot& s : t) {
+                insertUnique(s);
+            }
+        }
+        // 被移动的表仍然可以继续使用，所以哈希函数和相等比较是拷贝而不是移动
+        _flat_hash_table(_flat_hash_table&& t) noexcept
+            : _ctrl(t._ctrl), _slots(t._slots), _size(t._size), _capacity(t._capacity), _hash(t._hash), _eq(t._eq) {
+            t._ctrl = nullptr;
+            t._slots = nullptr;
+            t._size = 0;
+            t._capacity = 0;
+        }
+        _flat_hash_table& operator=(_flat_hash_table t) {
+            swap(t);
+            return *this;
+        }
+        ~_flat_hash_table() {
+            destroy();
+        }
+
+        // 迭代器
+        iterator begin() { return iterator(_ctrl, _slots, _ctrl + _capacity); }
+        iterator end() { return iterator(_ctrl + _capacity, _slots + _capacity, _ctrl + _capacity); }
+        const_iterator begin() const { return const_iterator(_ctrl, _slots, _ctrl + _capacity); }
+        const_iterator end() const { return const_iterator(_ctrl + _capacity, _slots + _capacity, _ctrl + _capacity); }
+
+        // 容量和大小
+        size_t size() const { return _size; }
+        size_t capacity() const { return _capacity; }
+        bool empty() const { return _size == 0; }
+        double load_factor() const { return _capacity == 0 ? 0.0 : double(_size) / _capacity; }
+
+        // 预留空间，保证插入n个元素的过程中不会扩容
+        void reserve(size_t n) {
+            size_t cap = _group_width;
+            while (cap - cap / 8 < n) { // 最大负载因子7/8
+                cap *= 2;
+            }
+            if (cap > _capacity) {
+                rehash(cap);
+            }
+        }
+
+        // 查找
+        iterator find(const Key& key) { return iteratorAt(findIndex(key)); }
+        const_iterator find(const Key& key) const { return iteratorAt(findIndex(key)); }
+        bool contains(const Key& key) const { return findIndex(key) != _capacity; }
+        size_t count(const Key& key) const { return contains(key); }
+
+        // 异构查找，例如flat_hash_map<my::string, V>可以直接用"abc"或string_view查找
+        template <class K> requires transparent
+        iterator find(const K& key) { return iteratorAt(findIndex(key)); }
+        template <class K> requires transparent
+        const_iterator find(const K& key) const { return iteratorAt(findIndex(key)); }
+        template <class K> requires transparent
+        bool contains(const K& key) const { return findIndex(key) != _capacity; }
+        template <class K> requires transparent
+        size_t count(const K& key) const { return contains(key); }
+
+        // 删除，返回删除的元素个数
+        size_t erase(const Key& key) {
+            return eraseKey(key);
+        }
+        template <class K> requires (transparent && !std::is_convertible_v<K, iterator> && !std::is_convertible_v<K, const_iterator>)
+        size_t erase(const K& key) {
+            return eraseKey(key);
+        }
+        /**
+         * 删除迭代器指向的元素，返回下一个元素的迭代器
+         * 后面的元素会前移填补空位，所以返回的迭代器可能仍指向原来的位置
+         * 注意：若前移发生在表尾绕回表头的情况下，一个已经遍历过的元素可能被移到表尾，边遍历边删除时会再次遇到它
+         */
+        iterator erase(const_iterator pos) {
+            MY_CHECK_CHEAP(pos._slot != _slots + _capacity && *pos._ctrl != _ctrl_group::empty);
+            size_t i = pos._slot - _slots;
+            eraseAt(i);
+            return iterator(_ctrl + i, _slots + i, _ctrl + _capacity);
+        }
+        iterator erase(iterator pos) {
+            return erase(const_iterator(pos));
+        }
+
+        void clear() {
+            for (size_t i = 0; i < _capacity; ++i) {
+                if (_ctrl[i] != _ctrl_group::empty) {
+                    _slots[i].~Slot();
+                }
+            }
+            if (_capacity != 0) {
+                memset(_ctrl, _ctrl_group::empty, _capacity + _group_width);
+            }
+            _size = 0;
+        }
+
+        void swap(_flat_hash_table& t) {
+            std::swap(_ctrl, t._ctrl);
+            std::swap(_slots, t._slots);
+            std::swap(_size, t._size);
+            std::swap(_capacity, t._capacity);
+            std::swap(_hash, t._hash);
+            std::swap(_eq, t._eq);
+        }
+
+        hasher hash_function() const { return _hash; }
+        key_equal key_eq() const { return _eq; }
+
+    protected:
+        static constexpr size_t _group_width = _ctrl_group::width;
+
+        // 对哈希值再做一次混合，std::hash<int>之类的恒等哈希也能均匀分布到各个槽
+        static size_t mix(size_t h) {
+            __extension__ typedef unsigned __int128 u128; // GCC扩展类型，__extension__避免-Wpedantic警告
+            u128 m = u128(h) * 0x9e3779b97f4a7c15ULL;
+            return size_t(m) ^ size_t(m >> 64);
+        }
+        // 高位决定起始槽位（h1），低7位存入控制字节（h2）
+        size_t homeOf(size_t h) const { return (h >> 7) & (_capacity - 1); }
+        static int8_t h2Of(size_t h) { return int8_t(h & 0x7f); }
+
+        template <class K>
+        size_t hashOf(const K& key) const { return mix(_hash(key)); }
+
+        // 查找键所在的槽，找不到返回_capacity
+        template <class K>
+        size_t findIndex(const K& key) const {
+            if (_size == 0) {
+                return _capacity;
+            }
+            size_t h = hashOf(key);
+            size_t mask = _capacity - 1;
+            size_t pos = homeOf(h);
+            while (true) {
+                _ctrl_group g(_ctrl + pos);
+                for (uint32_t m = g.match(h2Of(h)); m != 0; m &= m - 1) {
+                    size_t i = (pos + __builtin_ctz(m)) & mask;
+                    if (_eq(KeyOf()(_slots[i]), key)) {
+                        return i;
+                    }
+                }
+                // 线性探测保证从起始槽到元素之间没有空槽，这一组出现空槽说明键不存在
+                if (g.matchEmpty() != 0) {
+                    return _capacity;
+                }
+                pos = (pos + _group_width) & mask;
+            }
+        }
+
+        // 为哈希值为h的新元素找一个空槽并写好控制字节，必要时先扩容
+        size_t prepareInsert(size_t h) {
+            if (_size + 1 > _capacity - _capacity / 8 || _capacity == 0) {
+                rehash(_capacity == 0 ? _group_width : _capacity * 2);
+            }
+            size_t mask = _capacity - 1;
+            size_t pos = homeOf(h);
+            while (true) {
+                uint32_t m = _ctrl_group(_ctrl + pos).matchEmpty();
+                if (m != 0) {
+                    size_t i = (pos + __builtin_ctz(m)) & mask;
+                    setCtrl(i, h2Of(h));
+                    ++_size;
+                    return i;
+                }
+                pos = (pos + _group_width) & mask;
+            }
+        }
+
+        // 插入已知不存在的元素
+        template <class... Args>
+        size_t insertUnique(Args&&... args) {
+            Slot tmp(std::forward<Args>(args)...);
+            size_t i = prepareInsert(hashOf(KeyOf()(tmp)));
+            new (_slots + i) Slot(std::move(tmp));
+            return i;
+        }
+
+        // 键不存在时插入由args构造的元素，返回元素位置和是否插入
+        template <class K, class... Args>
+        std::pair<iterator, bool> emplaceKey(const K& key, Args&&... args) {
+            size_t i = findIndex(key);
+            if (i != _capacity) {
+                return std::make_pair(iteratorAt(i), false);
+            }
+            i = prepareInsert(hashOf(key));
+            try {
+                new (_slots + i) Slot(std::forward<Args>(args)...);
+            }
+            catch (...) {
+                setCtrl(i, _ctrl_group::empty);
+                --_size;
+                throw;
+            }
+            return std::make_pair(iteratorAt(i), true);
+        }
+
+        template <class K>
+        size_t eraseKey(const K& key) {
+            size_t i = findIndex(key);
+            if (i == _capacity) {
+                return 0;
+            }
+            eraseAt(i);
+            return 1;
+        }
+
+        /**
+         * 删除槽i上的元素，并把后面的元素前移（backward shift）
+         * 从空位往后看，若某元素的起始槽不在(空位, 当前位置]之间，说明它可以放到空位上而不破坏
+         * “起始槽到元素之间没有空槽”的性质，就把它移过去，它原来的位置成为新的空位，直到遇到空槽为止
+         */
+        void eraseAt(size_t i) {
+            size_t mask = _capacity - 1;
+            _slots[i].~Slot();
+            size_t j = (i + 1) & mask;
+            while (_ctrl[j] != _ctrl_group::empty) {
+                size_t home = homeOf(hashOf(KeyOf()(_slots[j])));
+                if (((j - home) & mask) >= ((j - i) & mask)) {
+                    new (_slots + i) Slot(std::move(_slots[j]));
+                    _slots[j].~Slot();
+                    setCtrl(i, _ctrl[j]);
+                    i = j;
+                }
+                j = (j + 1) & mask;
+            }
+            setCtrl(i, _ctrl_group::empty);
+            --_size;
+        }
+
+        // 写控制字节，前16个控制字节在数组末尾有一份拷贝，这样从任何位置开始都能连续读出16个字节
+        void setCtrl(size_t i, int8_t c) {
+            _ctrl[i] = c;
+            if (i < _group_width) {
+                _ctrl[_capacity + i] = c;
+            }
+        }
+
+        // 扩容到cap个槽，所有元素重新插入
+        void rehash(size_t cap) {
+            int8_t* oldCtrl = _ctrl;
+            Slot* oldSlots = _slots;
+            size_t oldCap = _capacity;
+
+            _slots = static_cast<Slot*>(::operator new(cap * sizeof(Slot), std::align_val_t(alignof(Slot))));
+            _ctrl = static_cast<int8_t*>(::operator new(cap + _group_width));
+            memset(_ctrl, _ctrl_group::empty, cap + _group_width);
+            _capacity = cap;
+            _size = 0;
+
+            for (size_t i = 0; i < oldCap; ++i) {
+                if (oldCtrl[i] != _ctrl_group::empty) {
+                    size_t j = prepareInsert(hashOf(KeyOf()(oldSlots[i])));
+                    new (_slots + j) Slot(std::move(oldSlots[i]));
+                    oldSlots[i].~Slot();
+                }
+            }
+            release(oldCtrl, oldSlots);
+        }
+
+        void destroy() {
+            clear();
+            release(_ctrl, _slots);
+            _ctrl = nullptr;
+            _slots = nullptr;
+            _capacity = 0;
+        }
+        static void release(int8_t* ctrl, Slot* slots) {
+            if (slots) {
+                ::operator delete(slots, std::align_val_t(alignof(Slot)));
+                ::operator delete(ctrl);
+            }
+        }
+
+        iterator iteratorAt(size_t i) { return iterator(_ctrl + i, _slots + i, _ctrl + _capacity); }
+        const_iterator iteratorAt(size_t i) const { return const_iterator(_ctrl + i, _slots + i, _ctrl + _capacity); }
+
+        int8_t* _ctrl; // 控制字节，共_capacity + 16个
+        Slot* _slots; // 槽数组
+        size_t _size; // 元素个数
+        size_t _capacity; // 槽的个数，为2的幂且至少为16
+        [[no_unique_address]] Hash _hash;
+        [[no_unique_address]] Eq _eq;
+    };
+
+    // 从map的槽中取出键
+    struct _flat_map_key_of {
+        template <class Pair>
+        const auto& operator()(const Pair& p) const { return p.first; }
+    };
+    // set的槽就是键本身
+    struct _flat_set_key_of {
+        template <class K>
+        const K& operator()(const K& k) const { return k; }
+    };
+
+    /**
+     * 开放寻址哈希映射，元素类型为std::pair<Key, V>
+     * 为了能在扩容和删除时移动元素，键没有声明为const，但不要通过迭代器修改键
+     * 插入、删除、扩容都会使迭代器和元素的引用失效
+     */
+    template <class Key, class V, class Hash = my::hash<Key>, class Eq = my::equal_to<Key>>
+    class flat_hash_map : public _flat_hash_table<Key, std::pair<Key, V>, _flat_map_key_of, Hash, Eq> {
+        typedef _flat_hash_table<Key, std::pair<Key, V>, _flat_map_key_of, Hash, Eq> Base;
+    public:
+        typedef V mapped_type;
+        typedef typename Base::iterator iterator;
+        typedef typename Base::const_iterator const_iterator;
+        typedef typename Base::value_type value_type;
+
+        flat_hash_map() {}
+        explicit flat_hash_map(size_t n, const Hash& hash = Hash(), const Eq& eq = Eq()) : Base(n, hash, eq) {}
+        flat_hash_map(std::initializer_list<value_type> il) {
+            this->reserve(il.size());
+            for (const value_type& kv : il) {
+                insert(kv);
+            }
+        }
+
+        // 插入，键已存在时不修改原有的值
+        std::pair<iterator, bool> insert(const value_type& kv) {
+            return this->emplaceKey(kv.first, kv);
+        }
+        std::pair<iterator, bool> insert(value_type&& kv) {
+            return this->emplaceKey(kv.first, std::move(kv));
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+
+        // 键不存在时才用args构造值
+        template <class... Args>
+        std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+            return this->emplaceKey(key, std::piecewise_construct,
+                std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        template <class K, class... Args> requires (Base::transparent && !std::is_same_v<std::decay_t<K>, Key>)
+        std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+            return this->emplaceKey(key, std::piecewise_construct,
+                std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        template <class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args) {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        // 键不存在时插入默认值
+        V& operator[](const Key& key) {
+            return try_emplace(key).first->second;
+        }
+        template <class K> requires (Base::transparent && !std::is_same_v<std::decay_t<K>, Key>)
+        V& operator[](const K& key) {
+            return try_emplace(key).first->second;
+        }
+
+        V& at(const Key& key) {
+            iterator it = this->find(key);
+            MY_CHECK_CHEAP(it != this->end());
+            return it->second;
+        }
+        const V& at(const Key& key) const {
+            const_iterator it = this->find(key);
+            MY_CHECK_CHEAP(it != this->end());
+            return it->second;
+        }
+    };
+
+    // 开放寻址哈希集合，不要通过迭代器修改元素
+    template <class Key, class Hash = my::hash<Key>, class Eq = my::equal_to<Key>>
+    class flat_hash_set : public _flat_hash_table<Key, Key, _flat_set_key_of, Hash, Eq> {
+        typedef _flat_hash_table<Key, Key, _flat_set_key_of, Hash, Eq> Base;
+    public:
+        typedef typename Base::iterator iterator;
+        typedef typename Base::const_iterator const_iterator;
+
+        flat_hash_set() {}
+        explicit flat_hash_set(size_t n, const Hash& hash = Hash(), const Eq& eq = Eq()) : Base(n, hash, eq) {}
+        flat_hash_set(std::initializer_list<Key> il) {
+            this->reserve(il.size());
+            for (const Key& k : il) {
+                insert(k);
+            }
+        }
+
+        std::pair<iterator, bool> insert(const Key& key) {
+            return this->emplaceKey(key, key);
+        }
+        std::pair<iterator, bool> insert(Key&& key) {
+            return this->emplaceKey(key, std::move(key));
+        }
+        template <class K> requires (Base::transparent && !std::is_same_v<std::decay_t<K>, Key>)
+        std::pair<iterator, bool> insert(const K& key) {
+            return this->emplaceKey(key, key);
+        }
+        template <class InputIterator>
+        void insert(InputIterator first, InputIterator last) {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
+        }
+    };
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include "../string/string_view.h"
+
+namespace my {
+    // 对任意长度的字节序列求64位哈希值，每次处理8个字节，乘法加异或移位充分打散
+    inline uint64_t hash_bytes(const char* p, size_t n) {
+        const uint64_t m = 0x9e3779b97f4a7c15ULL;
+        uint64_t h = n * m;
+        while (n >= 8) {
+            uint64_t k;
+            memcpy(&k, p, 8);
+            h = (h ^ (k * m)) * m;
+            h ^= h >> 29;
+            p += 8;
+            n -= 8;
+        }
+        uint64_t k = 0;
+        memcpy(&k, p, n); // 剩余不足8个字节
+        h = (h ^ (k * m)) * m;
+        h ^= h >> 32;
+        return h;
+    }
+
+    // 哈希函数，默认使用std::hash
+    template <class T>
+    struct hash : std::hash<T> {};
+
+    // my::string的哈希函数
+    // is_transparent表示支持异构查找：可以直接用const char*或string_view查找，无需构造临时的my::string
+    template <>
+    struct hash<string> {
+        typedef void is_transparent;
+        size_t operator()(string_view s) const {
+            return hash_bytes(s.data(), s.size());
+        }
+    };
+
+    // 判等函数，默认使用==
+    template <class T>
+    struct equal_to {
+        bool operator()(const T& x, const T& y) const {
+            return x == y;
+        }
+    };
+
+    // my::string的判等函数，同样支持异构查找
+    template <>
+    struct equal_to<string> {
+        typedef void is_transparent;
+        bool operator()(string_view x, string_view y) const {
+            return x == y;
+        }
+    };
+}
@@ -0,0 +1,887 @@
+#pragma once
+#include <algorithm>
+#include <initializer_list>
+#include <span>
+#include <utility>
+#include "../vector/vector.h"
+#include "../priority_queue/priority_queue.h"
+#include "../hardening/hardening.h"
+
+namespace my {
+    /**
+     * 无分支二分查找，返回[first, first + n)中第一个不小于key的元素的下标，没有则返回n
+     * 每轮只用比较结果选择下一段区间的起点（编译为条件传送cmov），循环次数只取决于n，
+     * 没有难以预测的分支，查找表小到能放进缓存时比std::lower_bound更快
+     */
+    template <class T, class Compare>
+    size_t _branchless_lower_bound(const T* first, size_t n, const T& key, const Compare& comp) {
+        if (n == 0) {
+            return 0;
+        }
+        const T* base = first;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = comp(base[half], key) ? base + half : base;
+            n -= half;
+        }
+        return (base - first) + comp(*base, key);
+    }
+
+    // 无分支二分查找，返回第一个大于key的元素的下标，没有则返回n
+    template <class T, class Compare>
+    size_t _branchless_upper_bound(const T* first, size_t n, const T& key, const Compare& comp) {
+        if (n == 0) {
+            return 0;
+        }
+        const T* base = first;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = comp(key, base[half]) ? base : base + half;
+            n -= half;
+        }
+        return (base - first) + !comp(key, *base);
+    }
+
+    /**
+     * Eytzinger布局的查找索引
+     * 把有序数组按完全二叉树的层序重新排列：结点k的左右孩子是2k和2k+1（下标从1开始），
+     * 二分查找的前几层总是落在数组开头的同几条缓存行上，往下走时还可以提前预取四层之后的孙子结点，
+     * 数组远大于缓存时比在有序数组上二分查找少很多缓存未命中
+     * 索引是有序数组的一份拷贝，只适合建好之后很少修改的查找表
+     */
+    template <class K, class Compare>
+    class _eytzinger_index {
+    public:
+        void build(const K* sorted, size_t n); // 由有序数组建立索引
+        void clear(); // 丢弃索引
+        bool built()const; // 索引是否可用
+        void swap(_eytzinger_index<K, Compare>& index); // 交换两个索引
+        size_t lower_bound(const K& key, const Compare& comp)const; // 返回第一个不小于key的元素在有序数组中的下标
+
+    private:
+        size_t fill(const K* sorted, size_t i, size_t k); // 中序遍历以k为根的子树，依次填入sorted[i]开始的元素
+
+        vector<K> _keys; // 按层序存放的键，_keys[k - 1]是结点k
+        vector<size_t> _rank; // _rank[k - 1]是结点k在有序数组中的下标
+        bool _built = false;
+    };
+
+    // 由有序数组建立索引
+    template <class K, class Compare>
+    void _eytzinger_index<K, Compare>::build(const K* sorted, size_t n) {
+        clear();
+        if (n != 0) {
+            _keys.assign(n, sorted[0]);
+            _rank.assign(n, 0);
+            fill(sorted, 0, 1);
+        }
+        _built = true;
+    }
+
+    // 中序遍历完全二叉树，中序遍历的顺序就是有序数组的顺序
+    template <class K, class Compare>
+    size_t _eytzinger_index<K, Compare>::fill(const K* sorted, size_t i, size_t k) {
+        if (k <= _keys.size()) {
+            i = fill(sorted, i, 2 * k);
+            _keys[k - 1] = sorted[i];
+            _rank[k - 1] = i++;
+            i = fill(sorted, i, 2 * k + 1);
+        }
+        return i;
+    }
+
+    // 丢弃索引
+    template <class K, class Compare>
+    void _eytzinger_index<K, Compare>::clear() {
+        _keys.clear();
+        _rank.clear();
+        _built = false;
+    }
+
+    // 索引是否可用
+    template <class K, class Compare>
+    bool _eytzinger_index<K, Compare>::built()const {
+        return _built;
+    }
+
+    // 交换两个索引
+    template <class K, class Compare>
+    void _eytzinger_index<K, Compare>::swap(_eytzinger_index<K, Compare>& index) {
+        _keys.swap(index._keys);
+        _rank.swap(index._rank);
+        std::swap(_built, index._built);
+    }
+
+    /**
+     * 在索引上查找，同样没有分支：每层根据比较结果走向左孩子(2k)或右孩子(2k+1)
+     * 走到叶子之后，k的二进制表示记录了一路的走向，最后一次向左拐的结点就是答案，
+     * 去掉k末尾连续的1（右拐）和其上的一个0即可回到该结点
+     */
+    template <class K, class Compare>
+    size_t _eytzinger_index<K, Compare>::lower_bound(const K& key, const Compare& comp)const {
+        const K* keys = _keys.data();
+        size_t n = _keys.size();
+        size_t k = 1;
+        while (k <= n) {
+            __builtin_prefetch(keys + std::min(16 * k, n) - 1); // 预取四层之后的结点
+            k = 2 * k + comp(keys[k - 1], key);
+        }
+        k >>= __builtin_ffsll(~k);
+        return k == 0 ? n : _rank.data()[k - 1];
+    }
+
+    // flat_map的迭代器，键和值分别存放，解引用返回由两者引用组成的pair（代理引用）
+    template <class Owner, class KeyRef, class ValRef>
+    struct _flat_map_iterator {
+        typedef _flat_map_iterator<Owner, KeyRef, ValRef> self;
+        typedef std::pair<KeyRef, ValRef> reference;
+
+        // operator->需要返回指针，代理引用是临时对象，只能包一层
+        struct arrow {
+            reference _ref;
+            reference* operator->() { return &_ref; }
+        };
+
+        _flat_map_iterator(Owner* owner, size_t index); // 构造函数
+
+        // 运算符重载函数
+        self& operator++(); // 前置自增操作符
+        self& operator--(); // 前置自减操作符
+        self operator++(int); // 后置自增操作符
+        self operator--(int); // 后置自减操作符
+        self operator+(ptrdiff_t n) const; // 向后移动n个位置
+        ptrdiff_t operator-(const self& rhs) const; // 两个迭代器之间的距离
+        bool operator==(const self& rhs) const; // 相等比较操作符
+        bool operator!=(const self& rhs) const; // 不相等比较操作符
+        reference operator*() const; // 解引用操作符，返回代理引用
+        arrow operator->() const; // 成员访问操作符，it->first为键，it->second为值
+
+        // 成员变量
+        Owner* _owner; // 所属的容器
+        size_t _index; // 当前下标
+    };
+
+    /**
+     * 有序数组实现的映射表
+     * 键和值分别存放在两个有序的my::vector中，查找时只扫描紧凑的键数组，
+     * 比红黑树节省每个结点的三个指针和颜色，也没有指针跳转造成的缓存未命中
+     * 单个插入删除需要搬移元素，是O(n)的，适合先批量加载、之后以查找为主的场景：
+     * 用区间构造函数一次加载并排序，或用insert_range一次合并一批新元素
+     * 插入删除会使迭代器失效
+     */
+    template <class K, class V, class Compare = less<K>>
+    class flat_map {
+    public:
+        typedef K key_type;
+        typedef V mapped_type;
+        typedef std::pair<K, V> value_type;
+        typedef Compare key_compare;
+        typedef _flat_map_iterator<flat_map<K, V, Compare>, const K&, V&> iterator;
+        typedef _flat_map_iterator<const flat_map<K, V, Compare>, const K&, const V&> const_iterator;
+
+        // 默认成员函数
+        flat_map(); // 构造函数
+        explicit flat_map(const Compare& comp); // 指定比较器的构造函数
+        template <class InputIterator>
+        flat_map(InputIterator first, InputIterator last, const Compare& comp = Compare()); // 批量加载，一次排序
+        flat_map(std::initializer_list<value_type> il, const Compare& comp = Compare());
+
+        // 迭代器相关函数
+        iterator begin();
+        iterator end();
+        const_iterator begin()const;
+        const_iterator end()const;
+
+        // 容量和大小
+        size_t size()const;
+        bool empty()const;
+        void reserve(size_t n);
+
+        // 修改容器内容相关函数，键已存在时不修改原有的值
+        std::pair<iterator, bool> insert(const value_type& kv);
+        template <class InputIterator>
+        void insert_range(InputIterator first, InputIterator last); // 批量插入，排序后与原数组归并一次
+        V& operator[](const K& key); // 键不存在时插入默认值
+        size_t erase(const K& key); // 返回删除的元素个数
+        iterator erase(iterator pos);
+        void clear();
+        void swap(flat_map<K, V, Compare>& m);
+
+        // 查找
+        iterator find(const K& key);
+        const_iterator find(const K& key)const;
+        bool contains(const K& key)const;
+        size_t count(const K& key)const;
+        iterator lower_bound(const K& key);
+        const_iterator lower_bound(const K& key)const;
+        iterator upper_bound(const K& key);
+        const_iterator upper_bound(const K& key)const;
+        V& at(const K& key);
+        const V& at(const K& key)const;
+
+        /**
+         * 为查找建立Eytzinger布局的索引，之后find/contains/lower_bound都走索引
+         * 索引是键数组的一份拷贝，任何插入删除都会丢弃它，需要时重新建立
+         */
+        void build_eytzinger();
+
+        // 访问底层数组
+        std::span<const K> keys()const; // 有序的键
+        std::span<V> values(); // 与键一一对应的值
+        std::span<const V> values()const;
+
+    private:
+        template <class InputIterator>
+        static vector<value_type> sortedUnique(InputIterator first, InputIterator last, const Compare& comp); // 排序并去重，相同的键保留最先出现的
+        size_t lowerIndex(const K& key)const; // 第一个不小于key的下标
+        size_t findIndex(const K& key)const; // key所在的下标，找不到返回size()
+        void insertAt(size_t i, const K& key, const V& value); // 在下标i处插入
+
+        template <class, class, class>
+        friend struct _flat_map_iterator;
+
+        vector<K> _keys; // 有序的键
+        vector<V> _values; // 与键一一对应的值
+        _eytzinger_index<K, Compare> _index; // 可选的查找索引
+        [[no_unique_address]] Compare _comp; // 比较器
+    };
+
+    /**
+     * 有序数组实现的集合
+     * 与flat_map一样适合先批量加载、之后以查找为主的场景，迭代器就是指向有序数组的常量指针
+     */
+    template <class K, class Compare = less<K>>
+    class flat_set {
+    public:
+        typedef K key_type;
+        typedef K value_type;
+        typedef Compare key_compare;
+        typedef const K* iterator;
+        typedef const K* const_iterator;
+
+        // 默认成员函数
+        flat_set(); // 构造函数
+        explicit flat_set(const Compare& comp); // 指定比较器的构造函数
+        template <class InputIterator>
+        flat_set(InputIterator first, InputIterator last, const Compare& comp = Compare()); // 批量加载，一次排序
+        flat_set(std::initializer_list<K> il, const Compare& comp = Compare());
+
+        // 迭代器相关函数
+        const_iterator begin()const;
+        const_iterator end()const;
+
+        // 容量和大小
+        size_t size()const;
+        bool empty()const;
+        void reserve(size_t n);
+
+        // 修改容器内容相关函数
+        std::pair<const_iterator, bool> insert(const K& key);
+        template <class InputIterator>
+        void insert_range(InputIterator first, InputIterator last); // 批量插入，排序后与原数组归并一次
+        size_t erase(const K& key); // 返回删除的元素个数
+        const_iterator erase(const_iterator pos);
+        void clear();
+        void swap(flat_set<K, Compare>& s);
+
+        // 查找
+        const_iterator find(const K& key)const;
+        bool contains(const K& key)const;
+        size_t count(const K& key)const;
+        const_iterator lower_bound(const K& key)const;
+        const_iterator upper_bound(const K& key)const;
+
+        // 为查找建立Eytzinger布局的索引，任何插入删除都会丢弃它
+        void build_eytzinger();
+
+        // 访问底层有序数组
+        std::span<const K> keys()const;
+
+    private:
+        template <class InputIterator>
+        static vector<K> sortedUnique(InputIterator first, InputIterator last, const Compare& comp); // 排序并去重
+        size_t lowerIndex(const K& key)const; // 第一个不小于key的下标
+        size_t findIndex(const K& key)const; // key所在的下标，找不到返回size()
+
+        vector<K> _keys; // 有序的键
+        _eytzinger_index<K, Compare> _index; // 可选的查找索引
+        [[no_unique_address]] Compare _comp; // 比较器
+    };
+
+    // 迭代器类具体实现
+
+    // 构造函数
+    template <class Owner, class KeyRef, class ValRef>
+    _flat_map_iterator<Owner, KeyRef, ValRef>::_flat_map_iterator(Owner* owner, size_t index)
+        : _owner(owner)
+        , _index(index)
+    {}
+
+    // 前置自增操作符
+    template <class Owner, class KeyRef, class ValRef>
+    _flat_map_iterator<Owner, KeyRef, ValRef>::self& _flat_map_iterator<Owner, KeyRef, ValRef>::operator++() {
+        _index++;
+        return *this;
+    }
+
+    // 前置自减操作符
+    template <class Owner, class KeyRef, class ValRef>
+    _flat_map_iterator<Owner, KeyRef, ValRef>::self& _flat_map_iterator<Owner, KeyRef, ValRef>::operator--() {
+        _index--;
+        return *this;
+    }
+
+    // 后置自增操作符
+    template <class Owner, class KeyRef, class ValRef>
+    _flat_map_iterator<Owner, KeyRef, ValRef>::self _flat_map_iterator<Owner, KeyRef, ValRef>::operator++(int) {
+        self tmp(*this);
+        _index++;
+        return tmp;
+    }
+
+    // 后置自减操作符
+    template <class Owner, class KeyRef, class ValRef>
+    _flat_map_iterator<Owner, KeyRef, ValRef>::self _flat_map_iterator<Owner, KeyRef, ValRef>::operator--(int) {
+        self tmp(*this);
+        _index--;
+        return tmp;
+    }
+
+    // 向后移动n个位置
+    template <class Owner, class KeyRef, class ValRef>
+    _flat_map_iterator<Owner, KeyRef, ValRef>::self _flat_map_iterator<Owner, KeyRef, ValRef>::operator+(ptrdiff_t n) const {
+        return self(_owner, _index + n);
+    }
+
+    // 两个迭代器之间的距离
+    template <class Owner, class KeyRef, class ValRef>
+    ptrdiff_t _flat_map_iterator<Owner, KeyRef, ValRef>::operator-(const self& rhs) const {
+        return ptrdiff_t(_index) - ptrdiff_t(rhs._index);
+    }
+
+    // 相等比较操作符
+    template <class Owner, class KeyRef, class ValRef>
+    bool _flat_map_iterator<Owner, KeyRef, ValRef>::operator==(const self& rhs) const {
+        return _index == rhs._index;
+    }
+
+    // 不相等比较操作符
+    template <class Owner, class KeyRef, class ValRef>
+    bool _flat_map_iterator<Owner, KeyRef, ValRef>::operator!=(const self& rhs) const {
+        return _index != rhs._index;
+    }
+
+    // 解引用操作符
+    template <class Owner, class KeyRef, class ValRef>
+    _flat_map_iterator<Owner, KeyRef, ValRef>::reference _flat_map_iterator<Owner, KeyRef, ValRef>::operator*() const {
+        return reference(_owner->_keys[_index], _owner->_values[_index]);
+    }
+
+    // 成员访问操作符
+    template <class Owner, class KeyRef, class ValRef>
+    _flat_map_iterator<Owner, KeyRef, ValRef>::arrow _flat_map_iterator<Owner, KeyRef, ValRef>::operator->() const {
+        return arrow{**this};
+    }
+
+    // flat_map具体实现
+    // 默认成员函数
+
+    // 构造函数
+    template <class K, class V, class Compare>
+    flat_map<K, V, Compare>::flat_map()
+        : _comp()
+    {}
+
+    // 指定比较器的构造函数
+    template <class K, class V, class Compare>
+    flat_map<K, V, Compare>::flat_map(const Compare& comp)
+        : _comp(comp)
+    {}
+
+    // 批量加载：先把所有元素放进数组，一次稳定排序并去重，再拆成键和值两个数组
+    template <class K, class V, class Compare>
+    template <class InputIterator>
+    flat_map<K, V, Compare>::flat_map(InputIterator first, InputIterator last, const Compare& comp)
+        : _comp(comp)
+    {
+        insert_range(first, last);
+    }
+
+    template <class K, class V, class Compare>
+    flat_map<K, V, Compare>::flat_map(std::initializer_list<value_type> il, const Compare& comp)
+        : _comp(comp)
+    {
+        insert_range(il.begin(), il.end());
+    }
+
+    // 迭代器相关函数
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::iterator flat_map<K, V, Compare>::begin() {
+        return iterator(this, 0);
+    }
+
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::iterator flat_map<K, V, Compare>::end() {
+        return iterator(this, size());
+    }
+
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::const_iterator flat_map<K, V, Compare>::begin()const {
+        return const_iterator(this, 0);
+    }
+
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::const_iterator flat_map<K, V, Compare>::end()const {
+        return const_iterator(this, size());
+    }
+
+    // 容量和大小
+    template <class K, class V, class Compare>
+    size_t flat_map<K, V, Compare>::size()const {
+        return _keys.size();
+    }
+
+    template <class K, class V, class Compare>
+    bool flat_map<K, V, Compare>::empty()const {
+        return _keys.empty();
+    }
+
+    template <class K, class V, class Compare>
+    void flat_map<K, V, Compare>::reserve(size_t n) {
+        _keys.reserve(n);
+        _values.reserve(n);
+    }
+
+    // 修改容器内容相关函数
+
+    // 插入单个元素，需要搬移插入位置之后的所有元素
+    template <class K, class V, class Compare>
+    std::pair<typename flat_map<K, V, Compare>::iterator, bool> flat_map<K, V, Compare>::insert(const value_type& kv) {
+        size_t i = lowerIndex(kv.first);
+        if (i != size() && !_comp(kv.first, _keys[i])) {
+            return std::make_pair(iterator(this, i), false);
+        }
+        insertAt(i, kv.first, kv.second);
+        return std::make_pair(iterator(this, i), true);
+    }
+
+    /**
+     * 批量插入：新元素先排序去重，再与原有的有序数组从头到尾归并一次，
+     * 总代价O(n + m log m)，而逐个插入每次都要搬移元素，是O(n * m)
+     * 键已存在时保留原有的值
+     * batch是局部的副本，直接移动；原有元素只在移动构造不抛异常时才移动，否则拷贝，
+     * 这样归并中途抛出异常时原数组不受影响（新数组已预留空间，push_back本身不会扩容）
+     */
+    template <class K, class V, class Compare>
+    template <class InputIterator>
+    void flat_map<K, V, Compare>::insert_range(InputIterator first, InputIterator last) {
+        vector<value_type> batch = sortedUnique(first, last, _comp);
+        if (batch.empty()) {
+            return;
+        }
+        vector<K> keys;
+        vector<V> values;
+        keys.reserve(size() + batch.size());
+        values.reserve(size() + batch.size());
+        size_t i = 0, j = 0;
+        while (i < size() || j < batch.size()) {
+            if (j == batch.size() || (i < size() && !_comp(batch[j].first, _keys[i]))) {
+                if (j < batch.size() && !_comp(_keys[i], batch[j].first)) {
+                    j++; // 键已存在，丢弃新元素
+                }
+                keys.push_back(std::move_if_noexcept(_keys[i]));
+                values.push_back(std::move_if_noexcept(_values[i]));
+                i++;
+            } else {
+                keys.push_back(std::move(batch[j].first));
+                values.push_back(std::move(batch[j].second));
+                j++;
+            }
+        }
+        _keys.swap(keys);
+        _values.swap(values);
+        _index.clear();
+    }
+
+    // 键不存在时插入默认值
+    template <class K, class V, class Compare>
+    V& flat_map<K, V, Compare>::operator[](const K& key) {
+        size_t i = lowerIndex(key);
+        if (i == size() || _comp(key, _keys[i])) {
+            insertAt(i, key, V());
+        }
+        return _values[i];
+    }
+
+    // 删除键为key的元素
+    template <class K, class V, class Compare>
+    size_t flat_map<K, V, Compare>::erase(const K& key) {
+        size_t i = findIndex(key);
+        if (i == size()) {
+            return 0;
+        }
+        erase(iterator(this, i));
+        return 1;
+    }
+
+    // 删除迭代器指向的元素，返回下一个元素的迭代器
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::iterator flat_map<K, V, Compare>::erase(iterator pos) {
+        MY_CHECK_CHEAP(pos._index < size());
+        _keys.erase(_keys.begin() + pos._index);
+        _values.erase(_values.begin() + pos._index);
+        _index.clear();
+        return pos;
+    }
+
+    template <class K, class V, class Compare>
+    void flat_map<K, V, Compare>::clear() {
+        _keys.clear();
+        _values.clear();
+        _index.clear();
+    }
+
+    template <class K, class V, class Compare>
+    void flat_map<K, V, Compare>::swap(flat_map<K, V, Compare>& m) {
+        _keys.swap(m._keys);
+        _values.swap(m._values);
+        _index.swap(m._index);
+        std::swap(_comp, m._comp);
+    }
+
+    // 查找
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::iterator flat_map<K, V, Compare>::find(const K& key) {
+        return iterator(this, findIndex(key));
+    }
+
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::const_iterator flat_map<K, V, Compare>::find(const K& key)const {
+        return const_iterator(this, findIndex(key));
+    }
+
+    template <class K, class V, class Compare>
+    bool flat_map<K, V, Compare>::contains(const K& key)const {
+        return findIndex(key) != size();
+    }
+
+    template <class K, class V, class Compare>
+    size_t flat_map<K, V, Compare>::count(const K& key)const {
+        return contains(key);
+    }
+
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::iterator flat_map<K, V, Compare>::lower_bound(const K& key) {
+        return iterator(this, lowerIndex(key));
+    }
+
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::const_iterator flat_map<K, V, Compare>::lower_bound(const K& key)const {
+        return const_iterator(this, lowerIndex(key));
+    }
+
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::iterator flat_map<K, V, Compare>::upper_bound(const K& key) {
+        return iterator(this, _branchless_upper_bound(_keys.data(), size(), key, _comp));
+    }
+
+    template <class K, class V, class Compare>
+    typename flat_map<K, V, Compare>::const_iterator flat_map<K, V, Compare>::upper_bound(const K& key)const {
+        return const_iterator(this, _branchless_upper_bound(_keys.data(), size(), key, _comp));
+    }
+
+    template <class K, class V, class Compare>
+    V& flat_map<K, V, Compare>::at(const K& key) {
+        size_t i = findIndex(key);
+        MY_CHECK_CHEAP(i != size());
+        return _values[i];
+    }
+
+    template <class K, class V, class Compare>
+    const V& flat_map<K, V, Compare>::at(const K& key)const {
+        size_t i = findIndex(key);
+        MY_CHECK_CHEAP(i != size());
+        return _values[i];
+    }
+
+    // 建立Eytzinger索引
+    template <class K, class V, class Compare>
+    void flat_map<K, V, Compare>::build_eytzinger() {
+        _index.build(_keys.data(), size());
+    }
+
+    // 访问底层数组
+    template <class K, class V, class Compare>
+    std::span<const K> flat_map<K, V, Compare>::keys()const {
+        return _keys.span();
+    }
+
+    template <class K, class V, class Compare>
+    std::span<V> flat_map<K, V, Compare>::values() {
+        return _values.span();
+    }
+
+    template <class K, class V, class Compare>
+    std::span<const V> flat_map<K, V, Compare>::values()const {
+        return _values.span();
+    }
+
+    // 排序并去重，稳定排序保证相同的键中最先出现的排在最前面
+    template <class K, class V, class Compare>
+    template <class InputIterator>
+    vector<typename flat_map<K, V, Compare>::value_type> flat_map<K, V, Compare>::sortedUnique(InputIterator first, InputIterator last, const Compare& comp) {
+        vector<value_type> v;
+        for (; first != last; ++first) {
+            v.push_back(value_type(*first));
+        }
+        if (v.empty()) {
+            return v;
+        }
+        value_type* b = v.data();
+        value_type* e = b + v.size();
+        std::stable_sort(b, e, [&comp](const value_type& x, const value_type& y) {
+            return comp(x.first, y.first);
+        });
+        e = std::unique(b, e, [&comp](const value_type& x, const value_type& y) {
+            return !comp(x.first, y.first);
+        });
+        v.resize(e - b, *b);
+        return v;
+    }
+
+    // 第一个不小于key的下标，建立了索引时走索引
+    template <class K, class V, class Compare>
+    size_t flat_map<K, V, Compare>::lowerIndex(const K& key)const {
+        if (_index.built()) {
+            return _index.lower_bound(key, _comp);
+        }
+        return _branchless_lower_bound(_keys.data(), size(), key, _comp);
+    }
+
+    // key所在的下标，找不到返回size()
+    template <class K, class V, class Compare>
+    size_t flat_map<K, V, Compare>::findIndex(const K& key)const {
+        size_t i = lowerIndex(key);
+        if (i != size() && _comp(key, _keys[i])) {
+            return size();
+        }
+        return i;
+    }
+
+    // 在下标i处插入，会丢弃索引
+    template <class K, class V, class Compare>
+    void flat_map<K, V, Compare>::insertAt(size_t i, const K& key, const V& value) {
+        _keys.insert(_keys.begin() + i, key);
+        _values.insert(_values.begin() + i, value);
+        _index.clear();
+    }
+
+    // flat_set具体实现
+    // 默认成员函数
+
+    // 构造函数
+    template <class K, class Compare>
+    flat_set<K, Compare>::flat_set()
+        : _comp()
+    {}
+
+    // 指定比较器的构造函数
+    template <class K, class Compare>
+    flat_set<K, Compare>::flat_set(const Compare& comp)
+        : _comp(comp)
+    {}
+
+    // 批量加载，一次排序
+    template <class K, class Compare>
+    template <class InputIterator>
+    flat_set<K, Compare>::flat_set(InputIterator first, InputIterator last, const Compare& comp)
+        : _comp(comp)
+    {
+        insert_range(first, last);
+    }
+
+    template <class K, class Compare>
+    flat_set<K, Compare>::flat_set(std::initializer_list<K> il, const Compare& comp)
+        : _comp(comp)
+    {
+        insert_range(il.begin(), il.end());
+    }
+
+    // 迭代器相关函数
+    template <class K, class Compare>
+    typename flat_set<K, Compare>::const_iterator flat_set<K, Compare>::begin()const {
+        return _keys.data();
+    }
+
+    template <class K, class Compare>
+    typename flat_set<K, Compare>::const_iterator flat_set<K, Compare>::end()const {
+        return _keys.data() + _keys.size();
+    }
+
+    // 容量和大小
+    template <class K, class Compare>
+    size_t flat_set<K, Compare>::size()const {
+        return _keys.size();
+    }
+
+    template <class K, class Compare>
+    bool flat_set<K, Compare>::empty()const {
+        return _keys.empty();
+    }
+
+    template <class K, class Compare>
+    void flat_set<K, Compare>::reserve(size_t n) {
+        _keys.reserve(n);
+    }
+
+    // 修改容器内容相关函数
+
+    // 插入单个元素
+    template <class K, class Compare>
+    std::pair<typename flat_set<K, Compare>::const_iterator, bool> flat_set<K, Compare>::insert(const K& key) {
+        size_t i = lowerIndex(key);
+        if (i != size() && !_comp(key, _keys[i])) {
+            return std::make_pair(begin() + i, false);
+        }
+        _keys.insert(_keys.begin() + i, key);
+        _index.clear();
+        return std::make_pair(begin() + i, true);
+    }
+
+    // 批量插入，新元素排序去重后与原有的有序数组归并一次
+    template <class K, class Compare>
+    template <class InputIterator>
+    void flat_set<K, Compare>::insert_range(InputIterator first, InputIterator last) {
+        vector<K> batch = sortedUnique(first, last, _comp);
+        if (batch.empty()) {
+            return;
+        }
+        vector<K> keys;
+        keys.reserve(size() + batch.size());
+        size_t i = 0, j = 0;
+        while (i < size() || j < batch.size()) {
+            if (j == batch.size() || (i < size() && !_comp(batch[j], _keys[i]))) {
+                if (j < batch.size() && !_comp(_keys[i], batch[j])) {
+                    j++; // 已存在
+                }
+                keys.push_back(std::move_if_noexcept(_keys[i++]));
+            } else {
+                keys.push_back(std::move(batch[j++]));
+            }
+        }
+        _keys.swap(keys);
+        _index.clear();
+    }
+
+    // 删除key
+    template <class K, class Compare>
+    size_t flat_set<K, Compare>::erase(const K& key) {
+        size_t i = findIndex(key);
+        if (i == size()) {
+            return 0;
+        }
+        erase(begin() + i);
+        return 1;
+    }
+
+    // 删除迭代器指向的元素，返回下一个元素的迭代器
+    template <class K, class Compare>
+    typename flat_set<K, Compare>::const_iterator flat_set<K, Compare>::erase(const_iterator pos) {
+        size_t i = pos - begin();
+        MY_CHECK_CHEAP(i < size());
+        _keys.erase(_keys.begin() + i);
+        _index.clear();
+        return begin() + i;
+    }
+
+    template <class K, class Compare>
+    void flat_set<K, Compare>::clear() {
+        _keys.clear();
+        _index.clear();
+    }
+
+    template <class K, class Compare>
+    void flat_set<K, Compare>::swap(flat_set<K, Compare>& s) {
+        _keys.swap(s._keys);
+        _index.swap(s._index);
+        std::swap(_comp, s._comp);
+    }
+
+    // 查找
+    template <class K, class Compare>
+    typename flat_set<K, Compare>::const_iterator flat_set<K, Compare>::find(const K& key)const {
+        return begin() + findIndex(key);
+    }
+
+    template <class K, class Compare>
+    bool flat_set<K, Compare>::contains(const K& key)const {
+        return findIndex(key) != size();
+    }
+
+    template <class K, class Compare>
+    size_t flat_set<K, Compare>::count(const K& key)const {
+        return contains(key);
+    }
+
+    template <class K, class Compare>
+    typename flat_set<K, Compare>::const_iterator flat_set<K, Compare>::lower_bound(const K& key)const {
+        return begin() + lowerIndex(key);
+    }
+
+    template <class K, class Compare>
+    typename flat_set<K, Compare>::const_iterator flat_set<K, Compare>::upper_bound(const K& key)const {
+        return begin() + _branchless_upper_bound(_keys.data(), size(), key, _comp);
+    }
+
+    // 建立Eytzinger索引
+    template <class K, class Compare>
+    void flat_set<K, Compare>::build_eytzinger() {
+        _index.build(_keys.data(), size());
+    }
+
+    // 访问底层有序数组
+    template <class K, class Compare>
+    std::span<const K> flat_set<K, Compare>::keys()const {
+        return _keys.span();
+    }
+
+    // 排序并去重
+    template <class K, class Compare>
+    template <class InputIterator>
+    vector<K> flat_set<K, Compare>::sortedUnique(InputIterator first, InputIterator last, const Compare& comp) {
+        vector<K> v;
+        for (; first != last; ++first) {
+            v.push_back(*first);
+        }
+        if (v.empty()) {
+            return v;
+        }
+        K* b = v.data();
+        K* e = b + v.size();
+        std::sort(b, e, comp);
+        e = std::unique(b, e, [&comp](const K& x, const K& y) {
+            return !comp(x, y);
+        });
+        v.resize(e - b, *b);
+        return v;
+    }
+
+    // 第一个不小于key的下标，建立了索引时走索引
+    template <class K, class Compare>
+    size_t flat_set<K, Compare>::lowerIndex(const K& key)const {
+        if (_index.built()) {
+            return _index.lower_bound(key, _comp);
+        }
+        return _branchless_lower_bound(_keys.data(), size(), key, _comp);
+    }
+
+    // key所在的下标，找不到返回size()
+    template <class K, class Compare>
+    size_t flat_set<K, Compare>::findIndex(const K& key)const {
+        size_t i = lowerIndex(key);
+        if (i != size() && _comp(key, _keys[i])) {
+            return size();
+        }
+        return i;
+    }
+}
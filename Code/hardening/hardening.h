@@ -0,0 +1,159 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <type_traits>
+
+/**
+ * 容器的安全检查等级，编译时通过 -DMY_HARDENING_LEVEL=n 选择
+ * 0（off）  ：不做任何检查，与直接操作裸指针一样快。
+ * 1（cheap）：只做O(1)的检查，如operator[]越界、对空容器pop_back，不改变任何类型的布局。
+ * 2（full） ：在cheap的基础上，vector的迭代器记录容器的“版本号”，
+ *             容器扩容、插入、删除后版本号改变，再使用旧迭代器会立即报错。
+ *             vector的布局和迭代器类型都会改变（迭代器不再是T*），与_GLIBCXX_DEBUG一样需要显式开启。
+ * 未指定时为cheap，与NDEBUG无关：Debug与Release编译的目标文件链接在一起时，vector的布局仍然一致。
+ * 整个程序应使用同一等级；vector按等级放在不同的内联命名空间中（见MY_HARDENING_NAMESPACE），
+ * 不同等级的目标文件之间传递vector时会链接失败，而不是在运行时读错内存。
+ * 检查失败时打印出错位置并调用abort。
+ */
+#define MY_HARDENING_OFF 0
+#define MY_HARDENING_CHEAP 1
+#define MY_HARDENING_FULL 2
+
+#ifndef MY_HARDENING_LEVEL
+#define MY_HARDENING_LEVEL MY_HARDENING_CHEAP
+#endif
+
+// 随等级变化的类型所在的内联命名空间，名字会出现在符号中，用来区分不同等级编译出的实例
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+#define MY_HARDENING_NAMESPACE _hardening_full
+#elif MY_HARDENING_LEVEL >= MY_HARDENING_CHEAP
+#define MY_HARDENING_NAMESPACE _hardening_cheap
+#else
+#define MY_HARDENING_NAMESPACE _hardening_off
+#endif
+
+namespace my {
+    // 检查失败，打印出错位置后终止程序
+    [[noreturn]] inline void _hardening_fail(const char* expr, const char* file, int line) {
+        std::fprintf(stderr, "%s:%d: my:: hardening check failed: %s\n", file, line, expr);
+        std::abort();
+    }
+}
+
+#if defined(__GNUC__)
+#define MY_UNLIKELY(cond) __builtin_expect(!!(cond), 0)
+#else
+#define MY_UNLIKELY(cond) (cond)
+#endif
+
+// cheap及以上等级的检查
+#if MY_HARDENING_LEVEL >= MY_HARDENING_CHEAP
+#define MY_CHECK_CHEAP(cond) (MY_UNLIKELY(!(cond)) ? ::my::_hardening_fail(#cond, __FILE__, __LINE__) : (void)0)
+#else
+#define MY_CHECK_CHEAP(cond) ((void)0)
+#endif
+
+// full等级的检查
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+#define MY_CHECK_FULL(cond) (MY_UNLIKELY(!(cond)) ? ::my::_hardening_fail(#cond, __FILE__, __LINE__) : (void)0)
+#else
+#define MY_CHECK_FULL(cond) ((void)0)
+#endif
+
+namespace my {
+    /**
+     * full等级下容器与其迭代器之间的锚
+     * 迭代器不直接记录容器的地址，而是记录锚的地址。swap时两个容器交换各自的锚，并把锚指回新的容器，
+     * 交换前得到的迭代器随元素一起转到另一个容器，仍然有效（与std::vector的swap语义一致）。
+     * 版本号也保存在锚中，随锚一起交换。
+     */
+    template <class Owner>
+    struct _iterator_anchor {
+        const Owner* _owner; // 当前拥有这些元素的容器
+        size_t _generation; // 版本号，每次可能使迭代器失效的修改都加一
+    };
+
+    // 运行时取得slot中的锚，slot为空时用CAS放入新锚；atomic_ref不能出现在constexpr函数中，所以单独成函数
+    template <class Owner>
+    _iterator_anchor<Owner>* _install_anchor(_iterator_anchor<Owner>*& slot, const Owner* owner) {
+        std::atomic_ref<_iterator_anchor<Owner>*> ref(slot);
+        _iterator_anchor<Owner>* a = ref.load(std::memory_order_acquire);
+        if (!a) {
+            _iterator_anchor<Owner>* fresh = new _iterator_anchor<Owner>{owner, 0};
+            if (ref.compare_exchange_strong(a, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                a = fresh;
+            } else {
+                delete fresh; // 其它线程先放入了锚
+            }
+        }
+        return a;
+    }
+
+    /**
+     * full等级下vector使用的检查迭代器
+     * 除了指针本身，还记录所属容器的锚和创建时的版本号（_generation）。
+     * 解引用时检查版本号是否一致、是否越界，从而发现“扩容/插入/删除后继续使用旧迭代器”的错误。
+     * Owner需要提供_start、_finish两个成员，并把本类声明为友元。
+     */
+    template <class T, class Owner>
+    struct _checked_iterator {
+        typedef _checked_iterator<T, Owner> self;
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::remove_const_t<T> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        constexpr _checked_iterator() : _ptr(nullptr), _anchor(nullptr), _generation(0) {}
+        constexpr _checked_iterator(T* ptr, _iterator_anchor<Owner>* anchor) : _ptr(ptr), _anchor(anchor), _generation(anchor ? anchor->_generation : 0) {}
+        // 普通迭代器可以转换为常量迭代器
+        template <class U>
+            requires std::is_same_v<const U, T>
+        constexpr _checked_iterator(const _checked_iterator<U, Owner>& it) : _ptr(it._ptr), _anchor(it._anchor), _generation(it._generation) {}
+
+        // 检查迭代器是否仍然有效；常量求值中没有锚，由编译器报告非法访问
+        constexpr void check() const {
+            if (!std::is_constant_evaluated()) {
+                MY_CHECK_FULL(_anchor != nullptr && _generation == _anchor->_generation);
+            }
+        }
+
+        // 解引用前额外检查是否指向有效元素
+        constexpr T* checkedPtr() const {
+            if (!std::is_constant_evaluated()) {
+                check();
+                MY_CHECK_FULL(_ptr >= _anchor->_owner->_start && _ptr < _anchor->_owner->_finish);
+            }
+            return _ptr;
+        }
+
+        // 运算符重载函数
+        constexpr reference operator*() const { return *checkedPtr(); }
+        constexpr pointer operator->() const { return checkedPtr(); }
+        constexpr reference operator[](difference_type n) const { return *(*this + n); }
+        constexpr self& operator++() { ++_ptr; return *this; }
+        constexpr self& operator--() { --_ptr; return *this; }
+        constexpr self operator++(int) { self tmp(*this); ++_ptr; return tmp; }
+        constexpr self operator--(int) { self tmp(*this); --_ptr; return tmp; }
+        constexpr self& operator+=(difference_type n) { _ptr += n; return *this; }
+        constexpr self& operator-=(difference_type n) { _ptr -= n; return *this; }
+        constexpr self operator+(difference_type n) const { self tmp(*this); tmp._ptr += n; return tmp; }
+        constexpr self operator-(difference_type n) const { self tmp(*this); tmp._ptr -= n; return tmp; }
+        friend constexpr self operator+(difference_type n, const self& it) { return it + n; }
+        constexpr difference_type operator-(const self& rhs) const { return _ptr - rhs._ptr; }
+        constexpr bool operator==(const self& rhs) const { return _ptr == rhs._ptr; }
+        constexpr bool operator!=(const self& rhs) const { return _ptr != rhs._ptr; }
+        constexpr bool operator<(const self& rhs) const { return _ptr < rhs._ptr; }
+        constexpr bool operator>(const self& rhs) const { return _ptr > rhs._ptr; }
+        constexpr bool operator<=(const self& rhs) const { return _ptr <= rhs._ptr; }
+        constexpr bool operator>=(const self& rhs) const { return _ptr >= rhs._ptr; }
+
+        // 成员变量
+        T* _ptr; // 指向的元素
+        _iterator_anchor<Owner>* _anchor; // 所属容器的锚
+        size_t _generation; // 创建时的版本号
+    };
+}
@@ -0,0 +1,238 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace my {
+    /**
+     * 风险指针（hazard pointer），无锁数据结构的内存回收
+     * 无锁结构中，一个线程把节点摘下后不能立即delete：其他线程可能刚读到这个节点的地址，正准备访问它。
+     * 1、读线程访问节点前，先把地址写进自己的风险指针（protect），表示“我正在用它”。
+     * 2、摘下节点的线程不直接释放，而是放入本线程的待回收列表（hazard_retire）。
+     * 3、待回收的节点攒到一定数量后扫描所有风险指针，没有被任何线程保护的节点才真正释放。
+     * 被保护的节点不会被释放，也就不会被重新分配到同一个地址，CAS因此不会遇到ABA问题。
+     * 与具体容器无关，任何无锁容器都可以复用；每个线程最多同时持有的风险指针个数不限，记录用完后回收复用。
+     */
+
+    // 一个风险指针的记录，所有记录串成一个只增不减的全局链表
+    struct alignas(64) _hazard_record {
+        std::atomic<const void*> _ptr{nullptr}; // 被保护的地址
+        std::atomic<bool> _active{false}; // 是否已被某个线程占用
+        _hazard_record* _next = nullptr;
+    };
+
+    // 一个待回收的节点
+    struct _hazard_retired {
+        void* _p;
+        void (*_deleter)(void*);
+    };
+
+    // 全局的记录链表，以及退出的线程留下的、暂时还不能释放的节点
+    class _hazard_domain {
+    public:
+        ~_hazard_domain(); // 程序退出时不再有其他线程，剩下的全部释放
+
+        _hazard_record* acquire(); // 占用一个空闲记录，没有就新建一个
+        void release(_hazard_record* r); // 清空并归还记录
+        void collect(std::vector<const void*>& out) const; // 收集所有正在被保护的地址
+        size_t record_count() const { return _count.load(std::memory_order_relaxed); }
+
+        void orphan(std::vector<_hazard_retired>& list); // 线程退出时转交剩下的节点
+        void adopt(std::vector<_hazard_retired>& list); // 把别的线程留下的节点接过来
+
+    private:
+        std::atomic<_hazard_record*> _head{nullptr};
+        std::atomic<size_t> _count{0};
+        std::mutex _orphanMtx;
+        std::vector<_hazard_retired> _orphans;
+        std::atomic<bool> _hasOrphans{false};
+    };
+
+    inline _hazard_domain& _hazard_global() {
+        static _hazard_domain domain;
+        return domain;
+    }
+
+    // 每个线程的空闲记录缓存和待回收列表
+    class _hazard_thread {
+    public:
+        ~_hazard_thread(); // 线程退出：归还记录，尽量释放节点，剩下的转交给全局
+
+        _hazard_record* acquire();
+        void release(_hazard_record* r);
+        void retire(void* p, void (*deleter)(void*));
+        void scan(); // 释放所有不再被保护的节点
+
+    private:
+        std::vector<_hazard_record*> _free; // 本线程用过的空闲记录，下次直接复用，不用遍历全局链表
+        std::vector<_hazard_retired> _retired;
+        std::vector<const void*> _hazards; // scan时使用，避免每次重新申请
+    };
+
+    inline thread_local _hazard_thread _hazard_local;
+
+    /**
+     * 一个风险指针，RAII：构造时占用一条记录，析构时清空并归还
+     *
+     *     hazard_pointer hp;
+     *     node* h = hp.protect(_head); // 返回后h在hp被reset或析构之前不会被释放
+     */
+    class hazard_pointer {
+    public:
+        hazard_pointer() : _record(_hazard_local.acquire()) {}
+        ~hazard_pointer() { _hazard_local.release(_record); }
+        hazard_pointer(const hazard_pointer&) = delete;
+        hazard_pointer& operator=(const hazard_pointer&) = delete;
+
+        /**
+         * 读出src并保护读到的地址
+         * 写入风险指针后要再读一次src：两次相同，说明写入时节点还没被摘下，
+         * 之后摘下它的线程扫描时一定能看到这个风险指针
+         */
+        template <class T>
+        T* protect(const std::atomic<T*>& src) {
+            T* p = src.load(std::memory_order_relaxed);
+            while (true) {
+                _record->_ptr.store(p, std::memory_order_seq_cst);
+                T* q = src.load(std::memory_order_seq_cst);
+                if (q == p) {
+                    return p;
+                }
+                p = q;
+            }
+        }
+
+        void reset() { _record->_ptr.store(nullptr, std::memory_order_release); } // 不再保护
+
+    private:
+        _hazard_record* _record;
+    };
+
+    // 节点已经从数据结构中摘下，等到没有风险指针保护它时用deleter释放（默认delete）
+    template <class T>
+    void hazard_retire(T* p) {
+        _hazard_local.retire(p, [](void* q) { delete static_cast<T*>(q); });
+    }
+
+    inline void hazard_retire(void* p, void (*deleter)(void*)) {
+        _hazard_local.retire(p, deleter);
+    }
+
+    // _hazard_domain具体实现
+
+    inline _hazard_domain::~_hazard_domain() {
+        for (_hazard_retired& r : _orphans) {
+            r._deleter(r._p);
+        }
+        _hazard_record* r = _head.load(std::memory_order_acquire);
+        while (r) {
+            _hazard_record* next = r->_next;
+            delete r;
+            r = next;
+        }
+    }
+
+    inline _hazard_record* _hazard_domain::acquire() {
+        for (_hazard_record* r = _head.load(std::memory_order_acquire); r; r = r->_next) {
+            bool expected = false;
+            if (!r->_active.load(std::memory_order_relaxed) && r->_active.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                return r;
+            }
+        }
+        _hazard_record* r = new _hazard_record;
+        r->_active.store(true, std::memory_order_relaxed);
+        r->_next = _head.load(std::memory_order_relaxed);
+        while (!_head.compare_exchange_weak(r->_next, r, std::memory_order_release, std::memory_order_relaxed)) {}
+        _count.fetch_add(1, std::memory_order_relaxed);
+        return r;
+    }
+
+    inline void _hazard_domain::release(_hazard_record* r) {
+        r->_ptr.store(nullptr, std::memory_order_release);
+        r->_active.store(false, std::memory_order_release);
+    }
+
+    inline void _hazard_domain::collect(std::vector<const void*>& out) const {
+        for (_hazard_record* r = _head.load(std::memory_order_acquire); r; r = r->_next) {
+            const void* p = r->_ptr.load(std::memory_order_acquire);
+            if (p) {
+                out.push_back(p);
+            }
+        }
+    }
+
+    inline void _hazard_domain::orphan(std::vector<_hazard_retired>& list) {
+        std::lock_guard<std::mutex> lock(_orphanMtx);
+        _orphans.insert(_orphans.end(), list.begin(), list.end());
+        _hasOrphans.store(true, std::memory_order_release);
+        list.clear();
+    }
+
+    // 没有遗留节点时不加锁；锁被占用说明别的线程正在接收，直接跳过
+    inline void _hazard_domain::adopt(std::vector<_hazard_retired>& list) {
+        if (!_hasOrphans.load(std::memory_order_acquire) || !_orphanMtx.try_lock()) {
+            return;
+        }
+        list.insert(list.end(), _orphans.begin(), _orphans.end());
+        _orphans.clear();
+        _hasOrphans.store(false, std::memory_order_relaxed);
+        _orphanMtx.unlock();
+    }
+
+    // _hazard_thread具体实现
+
+    inline _hazard_thread::~_hazard_thread() {
+        _hazard_domain& d = _hazard_global();
+        for (_hazard_record* r : _free) {
+            d.release(r);
+        }
+        _free.clear();
+        scan();
+        if (!_retired.empty()) {
+            d.orphan(_retired);
+        }
+    }
+
+    inline _hazard_record* _hazard_thread::acquire() {
+        if (!_free.empty()) {
+            _hazard_record* r = _free.back();
+            _free.pop_back();
+            return r;
+        }
+        return _hazard_global().acquire();
+    }
+
+    // 记录仍然归本线程占用，只清空地址，放回缓存
+    inline void _hazard_thread::release(_hazard_record* r) {
+        r->_ptr.store(nullptr, std::memory_order_release);
+        _free.push_back(r);
+    }
+
+    // 待回收节点超过记录数的两倍才扫描，每次扫描至少能释放一半，均摊到每个节点是O(1)
+    inline void _hazard_thread::retire(void* p, void (*deleter)(void*)) {
+        _retired.push_back({p, deleter});
+        if (_retired.size() >= std::max<size_t>(64, 2 * _hazard_global().record_count())) {
+            scan();
+        }
+    }
+
+    inline void _hazard_thread::scan() {
+        _hazard_domain& d = _hazard_global();
+        d.adopt(_retired);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // 与protect中的seq_cst配对：节点摘下在前，读风险指针在后
+        _hazards.clear();
+        d.collect(_hazards);
+        std::sort(_hazards.begin(), _hazards.end());
+        size_t kept = 0;
+        for (size_t i = 0; i < _retired.size(); i++) {
+            if (std::binary_search(_hazards.begin(), _hazards.end(), static_cast<const void*>(_retired[i]._p))) {
+                _retired[kept++] = _retired[i];
+            } else {
+                _retired[i]._deleter(_retired[i]._p);
+            }
+        }
+        _retired.resize(kept);
+    }
+}
@@ -0,0 +1,545 @@
+#pragma once
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "../list/list.h"
+#include "../string/string.h"
+#include "../hardening/hardening.h"
+
+namespace my {
+    /**
+     * 引用计数的内存块，多个iobuf（或同一个iobuf的多个片段）可以共享同一块内存
+     * [0, _used)中的数据写入后不再修改；只有引用计数为1时，持有者才能继续向[_used, _capacity)追加数据
+     */
+    struct _iobuf_block {
+        std::atomic<size_t> _refs{1};
+        char* _data;
+        size_t _capacity;
+        size_t _used = 0; // 已写入的字节数
+        void (*_destroy)(_iobuf_block*); // 引用计数归零时释放自身
+
+        _iobuf_block(char* data, size_t capacity, void (*destroy)(_iobuf_block*))
+            : _data(data)
+            , _capacity(capacity)
+            , _destroy(destroy)
+        {}
+
+        void addRef() { _refs.fetch_add(1, std::memory_order_relaxed); }
+        void release() {
+            if (_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                _destroy(this);
+            }
+        }
+        bool unique() const { return _refs.load(std::memory_order_acquire) == 1; }
+
+        // 块头和数据一次申请，数据紧跟在块头后面
+        static _iobuf_block* create(size_t capacity) {
+            void* p = ::operator new(sizeof(_iobuf_block) + capacity);
+            char* data = static_cast<char*>(p) + sizeof(_iobuf_block);
+            return ::new (p) _iobuf_block(data, capacity, [](_iobuf_block* b) {
+                b->~_iobuf_block();
+                ::operator delete(b);
+            });
+        }
+    };
+
+    // 接管my::string的存储：把字符串swap进块里，数据不拷贝
+    struct _iobuf_string_block : _iobuf_block {
+        string _str;
+
+        explicit _iobuf_string_block(string& s)
+            : _iobuf_block(nullptr, 0, [](_iobuf_block* b) { delete static_cast<_iobuf_string_block*>(b); })
+        {
+            _str.swap(s);
+            _data = _str.begin();
+            _capacity = _str.capacity();
+            _used = _str.size();
+        }
+    };
+
+    // 块中的一段数据
+    struct _iobuf_slice {
+        _iobuf_block* _block = nullptr;
+        size_t _offset = 0;
+        size_t _length = 0;
+
+        const char* data() const { return _block->_data + _offset; }
+        size_t end() const { return _offset + _length; }
+    };
+
+    /**
+     * 分散/聚集缓冲区：由引用计数内存块中的片段组成的链表，逻辑上是一段连续的字节序列
+     * 在头部或尾部追加另一个iobuf、拆分、拷贝都只复制片段描述并增加引用计数，不复制数据
+     * 通过to_iovec导出为struct iovec数组，直接交给readv/writev/sendmsg，数据不需要先拼成一个大字符串
+     * 引用计数是原子的，共享同一内存块的iobuf可以分属不同线程，但单个iobuf对象不是线程安全的
+     */
+    class iobuf {
+    public:
+        static constexpr size_t block_size = 8192 - sizeof(_iobuf_block); // 新申请的块的默认容量
+
+        // 默认成员函数
+        iobuf();
+        iobuf(const iobuf& buf); // 共享所有内存块
+        iobuf(iobuf&& buf);
+        iobuf& operator=(const iobuf& buf);
+        iobuf& operator=(iobuf&& buf);
+        ~iobuf();
+
+        // 容量和大小
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        size_t segment_count() const { return _slices.size(); }
+
+        // 在尾部添加
+        void append(const char* data, size_t len); // 拷贝，优先写入尾部块的剩余空间
+        void append(const string& s) { append(s.c_str(), s.size()); }
+        void append(string&& s); // 接管s的存储，不拷贝，s变为空串
+        void append(const iobuf& buf); // 共享buf的内存块
+        void append(iobuf&& buf);
+
+        // 在头部添加
+        void prepend(const char* data, size_t len);
+        void prepend(string&& s);
+        void prepend(const iobuf& buf);
+
+        // 拆分与删除
+        iobuf split(size_t n); // 取出前n个字节作为一个新的iobuf返回
+        void consume(size_t n); // 丢弃前n个字节
+        void trim_back(size_t n); // 丢弃后n个字节
+        void clear();
+        void swap(iobuf& buf);
+
+        // 合并首尾相接（属于同一块且地址连续）的相邻片段，不拷贝数据
+        void coalesce();
+
+        // 导出与拷贝
+        size_t to_iovec(iovec* iov, size_t max) const; // 导出至多max个片段，返回导出的个数
+        size_t copy_to(char* dest, size_t pos, size_t n) const; // 从pos开始拷贝至多n个字节，返回拷贝的字节数
+        string to_string() const;
+
+        // 文件描述符读写，返回值与readv/writev相同
+        ssize_t write_to(int fd); // 用writev写出尽量多的数据，并丢弃已写出的部分
+        ssize_t send_to(int fd, int flags = MSG_NOSIGNAL); // 同write_to，用于socket，默认对端关闭时不产生SIGPIPE
+        ssize_t read_from(int fd, size_t max = 65536); // 用readv读取至多max个字节追加在尾部
+
+        bool operator==(const iobuf& buf) const;
+        bool operator!=(const iobuf& buf) const { return !(*this == buf); }
+
+    private:
+        void pushBack(const _iobuf_slice& s); // 与尾部片段首尾相接时直接合并
+        void pushFront(const _iobuf_slice& s);
+        char* tailRoom(size_t& room); // 尾部块可以继续写入的空间，没有时返回nullptr
+
+        list<_iobuf_slice> _slices;
+        size_t _size = 0;
+    };
+
+    // 具体实现
+
+    inline iobuf::iobuf() {}
+
+    inline iobuf::iobuf(const iobuf& buf)
+        : _slices(buf._slices)
+        , _size(buf._size)
+    {
+        for (const _iobuf_slice& s : _slices) {
+            s._block->addRef();
+        }
+    }
+
+    inline iobuf::iobuf(iobuf&& buf) {
+        swap(buf);
+    }
+
+    inline iobuf& iobuf::operator=(const iobuf& buf) {
+        if (this != &buf) {
+            iobuf tmp(buf);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    inline iobuf& iobuf::operator=(iobuf&& buf) {
+        if (this != &buf) {
+            clear();
+            swap(buf);
+        }
+        return *this;
+    }
+
+    inline iobuf::~iobuf() {
+        clear();
+    }
+
+    inline void iobuf::pushBack(const _iobuf_slice& s) {
+        if (s._length == 0) {
+            s._block->release();
+            return;
+        }
+        if (!_slices.empty()) {
+            _iobuf_slice& back = _slices.back();
+            if (back._block == s._block && back.end() == s._offset) {
+                back._length += s._length;
+                _size += s._length;
+                s._block->release(); // 合并后两个片段只需要一个引用
+                return;
+            }
+        }
+        _slices.push_back(s);
+        _size += s._length;
+    }
+
+    inline void iobuf::pushFront(const _iobuf_slice& s) {
+        if (s._length == 0) {
+            s._block->release();
+            return;
+        }
+        if (!_slices.empty()) {
+            _iobuf_slice& front = _slices.front();
+            if (front._block == s._block && s.end() == front._offset) {
+                front._offset = s._offset;
+                front._length += s._length;
+                _size += s._length;
+                s._block->release();
+                return;
+            }
+        }
+        _slices.push_front(s);
+        _size += s._length;
+    }
+
+    // 只有尾部片段正好结束在块的已写入位置，且块没有被共享时才能继续写
+    inline char* iobuf::tailRoom(size_t& room) {
+        room = 0;
+        if (_slices.empty()) {
+            return nullptr;
+        }
+        _iobuf_slice& back = _slices.back();
+        _iobuf_block* b = back._block;
+        if (back.end() != b->_used || b->_used == b->_capacity || !b->unique()) {
+            return nullptr;
+        }
+        room = b->_capacity - b->_used;
+        return b->_data + b->_used;
+    }
+
+    inline void iobuf::append(const char* data, size_t len) {
+        size_t room;
+        char* p = tailRoom(room);
+        if (p) {
+            size_t n = len < room ? len : room;
+            memcpy(p, data, n);
+            _slices.back()._block->_used += n;
+            _slices.back()._length += n;
+            _size += n;
+            data += n;
+            len -= n;
+        }
+        if (len > 0) {
+            _iobuf_block* b = _iobuf_block::create(len > block_size ? len : block_size);
+            memcpy(b->_data, data, len);
+            b->_used = len;
+            pushBack(_iobuf_slice{b, 0, len});
+        }
+    }
+
+    inline void iobuf::append(string&& s) {
+        if (s.empty()) {
+            return;
+        }
+        _iobuf_block* b = new _iobuf_string_block(s);
+        pushBack(_iobuf_slice{b, 0, b->_used});
+    }
+
+    inline void iobuf::append(const iobuf& buf) {
+        if (&buf == this) {
+            iobuf tmp(buf);
+            append(std::move(tmp));
+            return;
+        }
+        for (const _iobuf_slice& s : buf._slices) {
+            s._block->addRef();
+            pushBack(s);
+        }
+    }
+
+    // 引用直接转移过来，不需要增减引用计数
+    inline void iobuf::append(iobuf&& buf) {
+        if (&buf == this) {
+            append(static_cast<const iobuf&>(buf));
+            return;
+        }
+        if (empty()) {
+            swap(buf);
+            return;
+        }
+        while (!buf._slices.empty()) {
+            pushBack(buf._slices.front());
+            buf._slices.pop_front();
+        }
+        buf._size = 0;
+    }
+
+    inline void iobuf::prepend(const char* data, size_t len) {
+        if (len == 0) {
+            return;
+        }
+        _iobuf_block* b = _iobuf_block::create(len);
+        memcpy(b->_data, data, len);
+        b->_used = len;
+        pushFront(_iobuf_slice{b, 0, len});
+    }
+
+    inline void iobuf::prepend(string&& s) {
+        if (s.empty()) {
+            return;
+        }
+        _iobuf_block* b = new _iobuf_string_block(s);
+        pushFront(_iobuf_slice{b, 0, b->_used});
+    }
+
+    inline void iobuf::prepend(const iobuf& buf) {
+        iobuf tmp(buf);
+        tmp.append(std::move(*this));
+        swap(tmp);
+    }
+
+    // 整片段直接移过去，跨越边界的片段拆成两段，各持有一个引用
+    inline iobuf iobuf::split(size_t n) {
+        MY_CHECK_CHEAP(n <= _size);
+        iobuf front;
+        while (n > 0) {
+            _iobuf_slice& s = _slices.front();
+            if (s._length <= n) {
+                n -= s._length;
+                _size -= s._length;
+                front.pushBack(s);
+                _slices.pop_front();
+            } else {
+                s._block->addRef();
+                front.pushBack(_iobuf_slice{s._block, s._offset, n});
+                s._offset += n;
+                s._length -= n;
+                _size -= n;
+                n = 0;
+            }
+        }
+        return front;
+    }
+
+    inline void iobuf::consume(size_t n) {
+        MY_CHECK_CHEAP(n <= _size);
+        while (n > 0) {
+            _iobuf_slice& s = _slices.front();
+            if (s._length <= n) {
+                n -= s._length;
+                _size -= s._length;
+                s._block->release();
+                _slices.pop_front();
+            } else {
+                s._offset += n;
+                s._length -= n;
+                _size -= n;
+                n = 0;
+            }
+        }
+    }
+
+    inline void iobuf::trim_back(size_t n) {
+        MY_CHECK_CHEAP(n <= _size);
+        while (n > 0) {
+            _iobuf_slice& s = _slices.back();
+            if (s._length <= n) {
+                n -= s._length;
+                _size -= s._length;
+                s._block->release();
+                _slices.pop_back();
+            } else {
+                s._length -= n;
+                _size -= n;
+                n = 0;
+            }
+        }
+    }
+
+    inline void iobuf::clear() {
+        while (!_slices.empty()) {
+            _slices.front()._block->release();
+            _slices.pop_front();
+        }
+        _size = 0;
+    }
+
+    inline void iobuf::swap(iobuf& buf) {
+        _slices.swap(buf._slices);
+        std::swap(_size, buf._size);
+    }
+
+    inline void iobuf::coalesce() {
+        list<_iobuf_slice> slices;
+        slices.swap(_slices);
+        _size = 0;
+        while (!slices.empty()) {
+            pushBack(slices.front());
+            slices.pop_front();
+        }
+    }
+
+    inline size_t iobuf::to_iovec(iovec* iov, size_t max) const {
+        size_t n = 0;
+        for (const _iobuf_slice& s : _slices) {
+            if (n == max) {
+                break;
+            }
+            iov[n].iov_base = const_cast<char*>(s.data());
+            iov[n].iov_len = s._length;
+            ++n;
+        }
+        return n;
+    }
+
+    inline size_t iobuf::copy_to(char* dest, size_t pos, size_t n) const {
+        size_t copied = 0;
+        for (const _iobuf_slice& s : _slices) {
+            if (copied == n) {
+                break;
+            }
+            if (pos >= s._length) {
+                pos -= s._length;
+                continue;
+            }
+            size_t k = s._length - pos;
+            if (k > n - copied) {
+                k = n - copied;
+            }
+            memcpy(dest + copied, s.data() + pos, k);
+            copied += k;
+            pos = 0;
+        }
+        return copied;
+    }
+
+    inline string iobuf::to_string() const {
+        string s;
+        s.reserve(_size);
+        for (const _iobuf_slice& sl : _slices) {
+            s.append(sl.data(), sl._length);
+        }
+        return s;
+    }
+
+    inline ssize_t iobuf::write_to(int fd) {
+        iovec iov[IOV_MAX < 64 ? IOV_MAX : 64];
+        size_t n = to_iovec(iov, sizeof(iov) / sizeof(iov[0]));
+        if (n == 0) {
+            return 0;
+        }
+        ssize_t written;
+        do {
+            written = ::writev(fd, iov, int(n));
+        } while (written < 0 && errno == EINTR);
+        if (written > 0) {
+            consume(size_t(written));
+        }
+        return written;
+    }
+
+    inline ssize_t iobuf::send_to(int fd, int flags) {
+        iovec iov[IOV_MAX < 64 ? IOV_MAX : 64];
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = to_iovec(iov, sizeof(iov) / sizeof(iov[0]));
+        if (msg.msg_iovlen == 0) {
+            return 0;
+        }
+        ssize_t sent;
+        do {
+            sent = ::sendmsg(fd, &msg, flags);
+        } while (sent < 0 && errno == EINTR);
+        if (sent > 0) {
+            consume(size_t(sent));
+        }
+        return sent;
+    }
+
+    // 先填尾部块的剩余空间，不够时再读入一个新块，一次readv完成
+    inline ssize_t iobuf::read_from(int fd, size_t max) {
+        iovec iov[2];
+        int cnt = 0;
+        size_t room;
+        char* p = tailRoom(room);
+        if (p) {
+            if (room > max) {
+                room = max;
+            }
+            iov[cnt].iov_base = p;
+            iov[cnt].iov_len = room;
+            ++cnt;
+        }
+        _iobuf_block* b = nullptr;
+        if (room < max) {
+            size_t need = max - room;
+            b = _iobuf_block::create(need > block_size ? need : block_size);
+            iov[cnt].iov_base = b->_data;
+            iov[cnt].iov_len = need;
+            ++cnt;
+        }
+        ssize_t r;
+        do {
+            r = ::readv(fd, iov, cnt);
+        } while (r < 0 && errno == EINTR);
+        size_t got = r > 0 ? size_t(r) : 0;
+        size_t inTail = got < room ? got : room;
+        if (inTail > 0) {
+            _slices.back()._block->_used += inTail;
+            _slices.back()._length += inTail;
+            _size += inTail;
+        }
+        if (b) {
+            if (got > inTail) {
+                b->_used = got - inTail;
+                pushBack(_iobuf_slice{b, 0, b->_used});
+            } else {
+                b->release();
+            }
+        }
+        return r;
+    }
+
+    // 逐字节比较内容，与片段如何划分无关
+    inline bool iobuf::operator==(const iobuf& buf) const {
+        if (_size != buf._size) {
+            return false;
+        }
+        auto a = _slices.begin(), b = buf._slices.begin();
+        size_t ai = 0, bi = 0, left = _size;
+        while (left > 0) {
+            const _iobuf_slice& sa = *a;
+            const _iobuf_slice& sb = *b;
+            size_t k = sa._length - ai < sb._length - bi ? sa._length - ai : sb._length - bi;
+            if (memcmp(sa.data() + ai, sb.data() + bi, k) != 0) {
+                return false;
+            }
+            ai += k;
+            bi += k;
+            left -= k;
+            if (ai == sa._length) {
+                ++a;
+                ai = 0;
+            }
+            if (bi == sb._length) {
+                ++b;
+                bi = 0;
+            }
+        }
+        return true;
+    }
+}
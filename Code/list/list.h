@@ -1,4 +1,7 @@
 #pragma once
+#include <cstddef>
+#include "../hardening/hardening.h"
+#include "../telemetry/telemetry.h"
 
 namespace my {
     // 双向链表节点结构体，list当中的结点类
@@ -82,7 +85,7 @@ namespace my {
 
     // 结点类构造函数
     template <class T>
-    _list_node<T>::_list_node(const T& val = T())
+    _list_node<T>::_list_node(const T& val /* = T() */)
         : _val(val)
         , _next(nullptr)
         , _prev(nullptr)
@@ -158,6 +161,7 @@ namespace my {
     template <class T>
     list<T>::list() {
         _head = new node(); // 创建一个头结点
+        MY_TELEMETRY_ALLOCATE(list_kind, sizeof(node));
         _head->_next = _head; // 头结点的下一个指向自己
         _head->_prev = _head; // 头结点的前一个指向自己
     }
@@ -165,6 +169,7 @@ namespace my {
     template <class T>
     list<T>::list(const list<T>& lt) {
         _head = new node(); // 创建一个头结点
+        MY_TELEMETRY_ALLOCATE(list_kind, sizeof(node));
         _head->_next = _head; // 头结点的下一个指向自己
         _head->_prev = _head; // 头结点的前一个指向自己
         for (const auto& e : lt) {
@@ -189,7 +194,8 @@ namespace my {
     // 现代写法
     template <class T>
     list<T>& list<T>::operator=(const list<T>& lt) {
-        swap(lt); // 交换当前list和临时list的内容
+        list<T> tmp(lt); // 拷贝构造出一个临时list
+        swap(tmp); // 交换当前list和临时list的内容，旧内容随tmp析构
         return *this;
     }
 
@@ -198,6 +204,7 @@ namespace my {
     list<T>::~list() {
         clear(); // 清空list
         delete _head; // 删除头结点
+        MY_TELEMETRY_DEALLOCATE(list_kind);
         _head = nullptr; // 将头结点指针置为nullptr
     }
 
@@ -258,11 +265,13 @@ namespace my {
     // 在指定位置插入元素
     template <class T>
     void list<T>::insert(iterator pos, const T& x) {
-        assert(pos._pnode); // 确保迭代器指向有效节点
+        MY_CHECK_CHEAP(pos._pnode); // 确保迭代器指向有效节点
 
         node* cur = pos._pnode; // 获取当前迭代器指向的节点
         node* prev = cur->_prev; // 获取当前节点的前一个节点
         node* newNode = new node(x); // 创建新节点
+        MY_TELEMETRY_ALLOCATE(list_kind, sizeof(node));
+        MY_TELEMETRY_COPY(list_kind, 1);
         
         // 将新节点插入到当前节点之前
         newNode->_next = cur;
@@ -274,14 +283,15 @@ namespace my {
     // 删除指定位置的元素
     template <class T>
     list<T>::iterator list<T>::erase(iterator pos) {
-        assert(pos._pnode); // 确保迭代器指向有效节点
-        assert(pos != end()); // 确保不能删除头结点
+        MY_CHECK_CHEAP(pos._pnode); // 确保迭代器指向有效节点
+        MY_CHECK_CHEAP(pos != end()); // 确保不能删除头结点
 
         node* cur = pos._pnode; // 获取当前迭代器指向的节点
         node* prev = cur->_prev; // 获取当前节点的前一个节点
         node* next = cur->_next; // 获取当前节点的后一个节点
 
         delete cur; // 删除当前节点
+        MY_TELEMETRY_DEALLOCATE(list_kind);
 
         // 将前一个节点的next指针指向后一个节点
         prev->_next = next;
@@ -334,7 +344,7 @@ namespace my {
      * 2、若当前容器的size大于所给n，则只保留前n个有效数据。
      *  */ 
     template <class T>
-    void list<T>::resize(size_t n, const T& val = T()) {
+    void list<T>::resize(size_t n, const T& val /* = T() */) {
         iterator it = begin(); // 获取迭代器指向头部
         size_t len = 0; // 计数器初始化为0
         while (len < n && it != end()) { // 遍历容器
@@ -0,0 +1,354 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../hardening/hardening.h"
+
+namespace my {
+    /**
+     * 基于内存映射文件的持久化vector（Linux）
+     * 1、元素直接存放在mmap映射的文件中，打开文件不需要读取和逐个push_back，
+     *    页面在第一次访问时才由内核按需载入，几GB的数组也能在毫秒级“加载”完成。
+     * 2、文件布局：64字节的文件头（魔数、元素个数、元素大小）+ 连续存放的元素，
+     *    文件长度决定容量，扩容时用ftruncate加长文件再用mremap扩大映射。
+     * 3、只读模式下以PROT_READ映射，数据与页缓存共享，完全零拷贝。
+     * 元素以原始字节形式落盘，因此T必须是可平凡拷贝的类型（不能含指针指向的外部资源）。
+     */
+    template <class T>
+    class mmap_vector {
+        static_assert(std::is_trivially_copyable_v<T>, "mmap_vector requires a trivially copyable T");
+        static_assert(alignof(T) <= 64, "mmap_vector requires alignof(T) <= 64");
+
+    public:
+        // 迭代器
+        typedef T* iterator;
+        typedef const T* const_iterator;
+
+        // 打开方式
+        enum mode {
+            read_only, // 只读，文件必须已存在
+            read_write // 读写，文件不存在时创建
+        };
+
+        // 默认成员函数
+        mmap_vector(); // 构造函数，不关联任何文件
+        mmap_vector(const char* path, mode m = read_write); // 构造并打开文件
+        mmap_vector(const mmap_vector&) = delete;
+        mmap_vector& operator=(const mmap_vector&) = delete;
+        ~mmap_vector(); // 析构函数，自动关闭文件
+
+        // 文件相关函数
+        bool open(const char* path, mode m = read_write); // 打开文件，失败返回false
+        void close(); // 同步并关闭文件，多余的容量会从文件中截掉
+        bool is_open()const; // 检查是否已打开文件
+        bool sync(); // 把修改写回磁盘（msync），失败返回false
+
+        // 迭代器相关函数
+        iterator begin();
+        iterator end();
+        const_iterator begin()const;
+        const_iterator end()const;
+
+        // 容量和大小
+        size_t size()const; // 有效长度
+        size_t capacity()const; // 容量
+        bool reserve(size_t n); // 改变容量（加长文件），失败返回false
+        bool empty()const;
+
+        // 修改容器内容相关函数
+        bool push_back(const T& x); // 尾插，扩容失败返回false
+        void pop_back();
+        void clear();
+
+        // 访问容器相关函数
+        T& operator[](size_t i);
+        const T& operator[](size_t i)const;
+        T* data();
+        const T* data()const;
+
+    private:
+        // 文件头，固定占用64字节，保证元素按64字节对齐
+        struct alignas(64) _header {
+            uint64_t _magic; // 魔数，用于识别文件格式
+            uint64_t _size; // 元素个数
+            uint64_t _elem_size; // 元素大小，防止用错类型打开
+        };
+
+        static constexpr uint64_t magic = 0x52545645564d4d59ULL; // "YMMVEVTR"
+
+        size_t fileLength(size_t n)const; // 容纳n个元素所需的文件长度
+        bool remap(size_t n); // 把文件和映射扩大到能容纳n个元素
+
+        _header* _map; // 映射的起始地址（即文件头）
+        size_t _map_len; // 映射的长度
+        int _fd; // 文件描述符
+        mode _mode; // 打开方式
+    };
+
+    // 具体实现
+    // 默认成员函数
+
+    // 构造函数
+    template <class T>
+    mmap_vector<T>::mmap_vector()
+        : _map(nullptr)
+        , _map_len(0)
+        , _fd(-1)
+        , _mode(read_write)
+    {}
+
+    // 构造并打开文件
+    template <class T>
+    mmap_vector<T>::mmap_vector(const char* path, mode m)
+        : _map(nullptr)
+        , _map_len(0)
+        , _fd(-1)
+        , _mode(m)
+    {
+        open(path, m);
+    }
+
+    // 析构函数
+    template <class T>
+    mmap_vector<T>::~mmap_vector() {
+        close();
+    }
+
+    // 文件相关函数
+
+    /**
+     * 打开文件
+     * 1、读写模式下文件为空（新建）时写入文件头。
+     * 2、文件已有内容时检查魔数和元素大小，不匹配则打开失败。
+     * 3、文件长度超出元素个数的部分就是剩余容量。
+     */
+    template <class T>
+    bool mmap_vector<T>::open(const char* path, mode m) {
+        close();
+        _mode = m;
+        _fd = ::open(path, m == read_only ? O_RDONLY : (O_RDWR | O_CREAT), 0644);
+        if (_fd < 0) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(_fd, &st) != 0) {
+            close();
+            return false;
+        }
+        size_t len = st.st_size;
+        bool fresh = len == 0;
+        if (fresh) {
+            if (m == read_only) {
+                close();
+                return false;
+            }
+            len = sizeof(_header);
+            if (ftruncate(_fd, len) != 0) {
+                close();
+                return false;
+            }
+        }
+        if (len < sizeof(_header)) { // 文件太短，不可能是合法格式
+            close();
+            return false;
+        }
+        int prot = m == read_only ? PROT_READ : (PROT_READ | PROT_WRITE);
+        void* p = mmap(nullptr, len, prot, MAP_SHARED, _fd, 0);
+        if (p == MAP_FAILED) {
+            close();
+            return false;
+        }
+        _map = static_cast<_header*>(p);
+        _map_len = len;
+        if (fresh) {
+            _map->_magic = magic;
+            _map->_size = 0;
+            _map->_elem_size = sizeof(T);
+        } else if (_map->_magic != magic || _map->_elem_size != sizeof(T) || _map->_size > capacity()) {
+            munmap(_map, _map_len); // 格式不匹配，直接解除映射，不能按错误的类型截断文件
+            _map = nullptr;
+            _map_len = 0;
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    // 同步并关闭文件
+    template <class T>
+    void mmap_vector<T>::close() {
+        if (_map) {
+            size_t used = fileLength(size());
+            if (_mode == read_write) {
+                sync();
+            }
+            munmap(_map, _map_len);
+            if (_mode == read_write && used < _map_len) {
+                (void)ftruncate(_fd, used); // 截掉多余的容量，节省磁盘空间
+            }
+            _map = nullptr;
+            _map_len = 0;
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+    }
+
+    // 检查是否已打开文件
+    template <class T>
+    bool mmap_vector<T>::is_open()const {
+        return _map != nullptr;
+    }
+
+    // 把修改写回磁盘，只读模式下什么也不做
+    template <class T>
+    bool mmap_vector<T>::sync() {
+        if (!_map || _mode == read_only) {
+            return true;
+        }
+        return msync(_map, _map_len, MS_SYNC) == 0;
+    }
+
+    // 迭代器相关函数
+    template <class T>
+    mmap_vector<T>::iterator mmap_vector<T>::begin() {
+        return data();
+    }
+
+    template <class T>
+    mmap_vector<T>::iterator mmap_vector<T>::end() {
+        return data() + size();
+    }
+
+    template <class T>
+    mmap_vector<T>::const_iterator mmap_vector<T>::begin()const {
+        return data();
+    }
+
+    template <class T>
+    mmap_vector<T>::const_iterator mmap_vector<T>::end()const {
+        return data() + size();
+    }
+
+    // 容量和大小
+
+    // 有效长度，保存在文件头中
+    template <class T>
+    size_t mmap_vector<T>::size()const {
+        return _map ? _map->_size : 0;
+    }
+
+    // 容量，由映射长度决定
+    template <class T>
+    size_t mmap_vector<T>::capacity()const {
+        return _map ? (_map_len - sizeof(_header)) / sizeof(T) : 0;
+    }
+
+    /**
+     * 改变容量
+     * 1、当n大于当前的capacity时，加长文件并扩大映射。
+     * 2、当n小于当前的capacity时，什么也不做。
+     */
+    template <class T>
+    bool mmap_vector<T>::reserve(size_t n) {
+        if (n <= capacity()) {
+            return true;
+        }
+        return remap(n);
+    }
+
+    template <class T>
+    bool mmap_vector<T>::empty()const {
+        return size() == 0;
+    }
+
+    // 修改容器内容相关函数
+
+    // 尾插，容量不足时按2倍扩容
+    template <class T>
+    bool mmap_vector<T>::push_back(const T& x) {
+        MY_CHECK_CHEAP(_map && _mode == read_write); // 只读模式不能修改
+        size_t sz = size();
+        if (sz == capacity()) {
+            size_t new_capacity = sz == 0 ? 4096 / sizeof(T) + 1 : sz * 2; // 扩大容量
+            if (!remap(new_capacity)) {
+                return false;
+            }
+        }
+        data()[sz] = x;
+        _map->_size = sz + 1;
+        return true;
+    }
+
+    template <class T>
+    void mmap_vector<T>::pop_back() {
+        MY_CHECK_CHEAP(_mode == read_write); // 只读模式不能修改
+        MY_CHECK_CHEAP(!empty()); // 确保容器不为空
+        _map->_size--;
+    }
+
+    template <class T>
+    void mmap_vector<T>::clear() {
+        MY_CHECK_CHEAP(_mode == read_write); // 只读模式不能修改
+        if (_map) {
+            _map->_size = 0;
+        }
+    }
+
+    // 访问容器相关函数
+    template <class T>
+    T& mmap_vector<T>::operator[](size_t i) {
+        MY_CHECK_CHEAP(i < size()); // 确保下标合法
+        return data()[i];
+    }
+
+    template <class T>
+    const T& mmap_vector<T>::operator[](size_t i)const {
+        MY_CHECK_CHEAP(i < size()); // 确保下标合法
+        return data()[i];
+    }
+
+    // 元素紧跟在文件头之后
+    template <class T>
+    T* mmap_vector<T>::data() {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(_map) + sizeof(_header));
+    }
+
+    template <class T>
+    const T* mmap_vector<T>::data()const {
+        return reinterpret_cast<const T*>(reinterpret_cast<const char*>(_map) + sizeof(_header));
+    }
+
+    // 容纳n个元素所需的文件长度
+    template <class T>
+    size_t mmap_vector<T>::fileLength(size_t n)const {
+        return sizeof(_header) + n * sizeof(T);
+    }
+
+    /**
+     * 把文件和映射扩大到能容纳n个元素
+     * 先ftruncate加长文件，再用mremap扩大映射；地址空间不够时内核会把映射搬到新地址，
+     * 因此扩容后之前取得的迭代器和引用全部失效（与vector一致）
+     */
+    template <class T>
+    bool mmap_vector<T>::remap(size_t n) {
+        MY_CHECK_CHEAP(_map && _mode == read_write); // 只读模式不能扩容
+        size_t len = fileLength(n);
+        if (ftruncate(_fd, len) != 0) {
+            return false;
+        }
+        void* p = mremap(_map, _map_len, len, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) {
+            (void)ftruncate(_fd, _map_len); // 恢复原来的文件长度
+            return false;
+        }
+        _map = static_cast<_header*>(p);
+        _map_len = len;
+        return true;
+    }
+}
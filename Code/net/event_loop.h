@@ -0,0 +1,299 @@
+#pragma once
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include "../vector/vector.h"
+#include "../queue/queue.h"
+#include "../priority_queue/priority_queue.h"
+#include "../flat_hash_map/flat_hash_map.h"
+
+namespace my {
+    namespace net {
+        // 一个被监听的文件描述符
+        struct _channel {
+            int _fd;
+            std::function<void(uint32_t)> _callback; // 事件回调，参数为epoll返回的事件
+            bool _removed = false; // 已被remove，等本轮事件处理完再释放
+        };
+
+        // 定时器堆中的一项，按到期时间排成小堆
+        struct _timer {
+            int64_t _when; // 到期时间（毫秒）
+            uint64_t _id;
+
+            bool operator>(const _timer& t) const {
+                return _when != t._when ? _when > t._when : _id > t._id;
+            }
+        };
+
+        /**
+         * 基于epoll的单线程事件循环（reactor）
+         * 文件描述符的注册、修改、删除以及定时器都只能在运行事件循环的线程中调用，
+         * 其他线程通过post()投递任务、stop()停止循环（内部用eventfd唤醒epoll_wait）
+         * 定时器保存在小堆中，epoll_wait的超时时间取最近一个定时器的到期时间，不需要额外的timerfd
+         */
+        class event_loop {
+        public:
+            typedef std::function<void(uint32_t)> io_callback;
+            typedef std::function<void()> task;
+
+            event_loop();
+            ~event_loop();
+            event_loop(const event_loop&) = delete;
+            event_loop& operator=(const event_loop&) = delete;
+
+            // 监听fd上的events（EPOLLIN、EPOLLOUT、EPOLLET等），事件发生时调用cb，失败返回false
+            bool add(int fd, uint32_t events, io_callback cb);
+            bool modify(int fd, uint32_t events); // 修改监听的事件
+            void remove(int fd); // 不再监听fd，不会关闭fd
+
+            // 定时器，返回的id可用于取消
+            uint64_t run_after(int64_t ms, task cb); // ms毫秒后执行一次
+            uint64_t run_every(int64_t ms, task cb); // 每隔ms毫秒执行一次
+            void cancel(uint64_t id); // 取消定时器，可以在定时器自己的回调中调用
+
+            void run(); // 运行事件循环，直到stop()；run()之前调用过stop()时立即返回
+            void stop(); // 停止事件循环，可以在任意线程调用，可以早于run()
+            void post(task t); // 投递任务，在事件循环线程中执行，可以在任意线程调用
+
+            static int64_t now_ms(); // 单调时钟的当前时间（毫秒）
+
+        private:
+            struct _timer_entry {
+                task _callback;
+                int64_t _interval; // 0表示只执行一次
+            };
+
+            int nextTimeout(); // epoll_wait的超时时间
+            void runTimers(); // 执行所有已到期的定时器
+            void runTasks(); // 执行投递过来的任务
+            uint64_t addTimer(int64_t ms, int64_t interval, task cb);
+
+            int _epfd; // epoll实例
+            int _wakeupfd; // 用于唤醒epoll_wait的eventfd
+            std::atomic<bool> _quit{false}; // 只在构造时置为false，run()开始时不清除，早于run()的stop()也不会丢失
+            std::vector<epoll_event> _events; // epoll_wait的结果，装满时扩大一倍
+            flat_hash_map<int, _channel*> _channels; // 每个fd对应的channel
+            vector<_channel*> _garbage; // 本轮被删除、等待释放的channel
+
+            priority_queue<_timer, std::vector<_timer>, greater<_timer>> _timers; // 到期时间的小堆
+            flat_hash_map<uint64_t, _timer_entry> _timerEntries; // 尚未取消的定时器
+            uint64_t _nextTimerId = 1;
+            uint64_t _runningTimer = 0; // 正在执行回调的定时器
+            bool _runningCancelled = false; // 正在执行的定时器是否在回调中被取消
+
+            std::mutex _mutex; // 保护_tasks
+            queue<task> _tasks; // 其他线程投递的任务
+        };
+
+        inline event_loop::event_loop()
+            : _epfd(epoll_create1(EPOLL_CLOEXEC))
+            , _wakeupfd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+            , _events(64)
+        {
+            if (_epfd < 0 || _wakeupfd < 0) {
+                int err = errno;
+                if (_epfd >= 0) {
+                    ::close(_epfd);
+                }
+                if (_wakeupfd >= 0) {
+                    ::close(_wakeupfd);
+                }
+                throw std::system_error(err, std::generic_category(), "event_loop");
+            }
+            add(_wakeupfd, EPOLLIN, [this](uint32_t) {
+                uint64_t v;
+                while (::read(_wakeupfd, &v, sizeof(v)) > 0) {}
+            });
+        }
+
+        inline event_loop::~event_loop() {
+            for (auto& kv : _channels) {
+                delete kv.second;
+            }
+            for (_channel* ch : _garbage) {
+                delete ch;
+            }
+            ::close(_wakeupfd);
+            ::close(_epfd);
+        }
+
+        inline bool event_loop::add(int fd, uint32_t events, io_callback cb) {
+            if (_channels.contains(fd)) {
+                return false;
+            }
+            _channel* ch = new _channel{fd, std::move(cb)};
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.ptr = ch;
+            if (epoll_ctl(_epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+                delete ch;
+                return false;
+            }
+            _channels[fd] = ch;
+            return true;
+        }
+
+        inline bool event_loop::modify(int fd, uint32_t events) {
+            auto it = _channels.find(fd);
+            if (it == _channels.end()) {
+                return false;
+            }
+            epoll_event ev{};
+            ev.events = events;
+            ev.data.ptr = it->second;
+            return epoll_ctl(_epfd, EPOLL_CTL_MOD, fd, &ev) == 0;
+        }
+
+        // channel可能正在执行回调，或者本轮还有它的事件没处理，所以只做标记，本轮结束后再释放
+        inline void event_loop::remove(int fd) {
+            auto it = _channels.find(fd);
+            if (it == _channels.end()) {
+                return;
+            }
+            _channel* ch = it->second;
+            _channels.erase(it);
+            epoll_ctl(_epfd, EPOLL_CTL_DEL, fd, nullptr);
+            ch->_removed = true;
+            _garbage.push_back(ch);
+        }
+
+        inline uint64_t event_loop::run_after(int64_t ms, task cb) {
+            return addTimer(ms, 0, std::move(cb));
+        }
+
+        inline uint64_t event_loop::run_every(int64_t ms, task cb) {
+            return addTimer(ms, ms > 0 ? ms : 1, std::move(cb));
+        }
+
+        inline uint64_t event_loop::addTimer(int64_t ms, int64_t interval, task cb) {
+            uint64_t id = _nextTimerId++;
+            _timerEntries[id] = _timer_entry{std::move(cb), interval};
+            _timers.push(_timer{now_ms() + ms, id});
+            return id;
+        }
+
+        // 只从表中删除，堆中的那一项到期时发现已不在表中就直接丢弃
+        inline void event_loop::cancel(uint64_t id) {
+            if (id == _runningTimer) {
+                _runningCancelled = true;
+            }
+            _timerEntries.erase(id);
+        }
+
+        inline void event_loop::run() {
+            while (!_quit.load(std::memory_order_acquire)) {
+                int n = epoll_wait(_epfd, _events.data(), int(_events.size()), nextTimeout());
+                if (n < 0 && errno != EINTR) {
+                    break;
+                }
+                for (int i = 0; i < n; ++i) {
+                    _channel* ch = static_cast<_channel*>(_events[i].data.ptr);
+                    if (!ch->_removed) {
+                        ch->_callback(_events[i].events);
+                    }
+                }
+                if (n == int(_events.size())) {
+                    _events.resize(_events.size() * 2);
+                }
+                runTimers();
+                runTasks();
+                for (_channel* ch : _garbage) {
+                    delete ch;
+                }
+                _garbage.clear();
+            }
+        }
+
+        inline void event_loop::stop() {
+            _quit.store(true, std::memory_order_release);
+            uint64_t one = 1;
+            ssize_t r = ::write(_wakeupfd, &one, sizeof(one));
+            (void)r;
+        }
+
+        inline void event_loop::post(task t) {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _tasks.push(std::move(t));
+            }
+            uint64_t one = 1;
+            ssize_t r = ::write(_wakeupfd, &one, sizeof(one));
+            (void)r;
+        }
+
+        inline int64_t event_loop::now_ms() {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // 没有定时器时一直等待；有任务待执行时不等待
+        inline int event_loop::nextTimeout() {
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_tasks.empty()) {
+                    return 0;
+                }
+            }
+            while (!_timers.empty() && !_timerEntries.contains(_timers.top()._id)) {
+                _timers.pop(); // 丢弃已取消的定时器
+            }
+            if (_timers.empty()) {
+                return -1;
+            }
+            int64_t d = _timers.top()._when - now_ms();
+            return d <= 0 ? 0 : int(d > INT32_MAX ? INT32_MAX : d);
+        }
+
+        /**
+         * 回调中可能增删定时器，表会扩容，因此先把回调移出来再执行；
+         * 周期定时器执行完且没有被取消时再放回去
+         */
+        inline void event_loop::runTimers() {
+            int64_t now = now_ms();
+            while (!_timers.empty() && _timers.top()._when <= now) {
+                _timer t = _timers.top();
+                _timers.pop();
+                auto it = _timerEntries.find(t._id);
+                if (it == _timerEntries.end()) {
+                    continue;
+                }
+                _timer_entry e = std::move(it->second);
+                _timerEntries.erase(it);
+                _runningTimer = t._id;
+                _runningCancelled = false;
+                e._callback();
+                _runningTimer = 0;
+                if (e._interval > 0 && !_runningCancelled) {
+                    t._when += e._interval;
+                    _timerEntries[t._id] = std::move(e);
+                    _timers.push(t);
+                }
+            }
+        }
+
+        // 在锁内把任务一次性取出，在锁外执行，任务里可以继续post
+        inline void event_loop::runTasks() {
+            queue<task> tasks;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                while (!_tasks.empty()) {
+                    tasks.push(std::move(_tasks.front()));
+                    _tasks.pop();
+                }
+            }
+            while (!tasks.empty()) {
+                tasks.front()();
+                tasks.pop();
+            }
+        }
+    }
+}
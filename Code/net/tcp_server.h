@@ -0,0 +1,387 @@
+#pragma once
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "event_loop.h"
+#include "../string/string.h"
+#include "../iobuf/iobuf.h"
+
+namespace my {
+    namespace net {
+        class tcp_server;
+
+        /**
+         * 一个TCP连接，属于某一个事件循环，所有操作都在该循环的线程中进行
+         * 读缓冲区是my::string，读到的数据追加在末尾，由消息回调自己从头部取走（erase）
+         * 发送时若写队列为空先直接写，写不完的部分放入写队列（my::iobuf），
+         * 等EPOLLOUT再用sendmsg一次写出多个片段，写完后取消对EPOLLOUT的监听
+         */
+        class tcp_connection {
+        public:
+            tcp_connection(tcp_server* server, event_loop* loop, int fd);
+            ~tcp_connection();
+            tcp_connection(const tcp_connection&) = delete;
+            tcp_connection& operator=(const tcp_connection&) = delete;
+
+            int fd() const { return _fd; }
+            event_loop& loop() { return *_loop; }
+            string& input() { return _input; } // 已读入、尚未处理的数据
+            size_t pending_bytes() const { return _output.size(); } // 写队列中尚未发出的字节数
+
+            void send(const char* data, size_t len);
+            void send(const string& s) { send(s.c_str(), s.size()); }
+            void send(iobuf&& buf); // 由多个片段组成的响应，写不完的部分直接接入写队列，不拷贝
+            void shutdown(); // 写队列发完后关闭连接
+            void close(); // 立即关闭连接，丢弃写队列
+
+        private:
+            friend class tcp_server;
+
+            void handleEvent(uint32_t events);
+            void handleRead();
+            void handleWrite();
+            void updateEvents(); // 根据写队列是否为空决定是否监听EPOLLOUT
+
+            tcp_server* _server;
+            event_loop* _loop;
+            int _fd;
+            string _input; // 读缓冲区
+            iobuf _output; // 写队列
+            bool _writing = false; // 是否正在监听EPOLLOUT
+            bool _closing = false; // 写完后关闭
+            bool _closed = false;
+        };
+
+        /**
+         * TCP服务器
+         * threads为1时是单线程reactor；大于1时是多reactor：每个线程一个事件循环，
+         * 各自创建一个设置了SO_REUSEPORT的监听socket绑定同一个端口，由内核把新连接分散到各个线程，
+         * 线程之间没有共享的接受队列，也不需要把连接从一个线程转交给另一个线程
+         * 连接和消息回调在连接所属的线程中执行
+         */
+        class tcp_server {
+        public:
+            typedef std::function<void(tcp_connection&)> callback;
+
+            explicit tcp_server(size_t threads = 1);
+            ~tcp_server();
+            tcp_server(const tcp_server&) = delete;
+            tcp_server& operator=(const tcp_server&) = delete;
+
+            void on_connection(callback cb) { _onConnection = std::move(cb); } // 新连接建立
+            void on_message(callback cb) { _onMessage = std::move(cb); } // 读到了新数据
+            void on_close(callback cb) { _onClose = std::move(cb); } // 连接关闭前
+
+            // 在port上监听，port为0时由系统分配，失败返回false
+            bool listen(uint16_t port, const char* ip = "0.0.0.0");
+            uint16_t port() const { return _port; }
+
+            void run(); // 启动其余线程的事件循环，当前线程运行第0个循环，直到stop()
+            void stop(); // 停止所有事件循环，可以在任意线程调用
+            size_t thread_count() const { return _reactors.size(); }
+            event_loop& loop(size_t i) { return _reactors[i]->_loop; }
+
+        private:
+            friend class tcp_connection;
+
+            // 一个线程的事件循环、监听socket和其上的连接
+            struct reactor {
+                event_loop _loop;
+                int _listenfd = -1;
+                flat_hash_map<int, tcp_connection*> _connections;
+                vector<tcp_connection*> _dead; // 已关闭、等待释放的连接
+            };
+
+            void handleAccept(reactor& r);
+            void destroy(tcp_connection* conn); // 关闭并释放连接
+
+            std::vector<std::unique_ptr<reactor>> _reactors;
+            std::vector<std::thread> _threads;
+            uint16_t _port = 0;
+            callback _onConnection;
+            callback _onMessage;
+            callback _onClose;
+        };
+
+        // tcp_connection具体实现
+
+        inline tcp_connection::tcp_connection(tcp_server* server, event_loop* loop, int fd)
+            : _server(server)
+            , _loop(loop)
+            , _fd(fd)
+        {}
+
+        inline tcp_connection::~tcp_connection() {
+            if (_fd >= 0) {
+                ::close(_fd);
+            }
+        }
+
+        inline void tcp_connection::send(const char* data, size_t len) {
+            if (_closed || _closing) {
+                return;
+            }
+            if (_output.empty()) {
+                ssize_t n = ::send(_fd, data, len, MSG_NOSIGNAL);
+                if (n < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                        close();
+                        return;
+                    }
+                    n = 0;
+                }
+                data += n;
+                len -= size_t(n);
+            }
+            if (len > 0) {
+                _output.append(data, len);
+                updateEvents();
+            }
+        }
+
+        inline void tcp_connection::send(iobuf&& buf) {
+            if (_closed || _closing) {
+                return;
+            }
+            bool idle = _output.empty();
+            _output.append(std::move(buf));
+            if (idle) {
+                handleWrite();
+            }
+        }
+
+        inline void tcp_connection::shutdown() {
+            if (_closed) {
+                return;
+            }
+            _closing = true;
+            if (_output.empty()) {
+                close();
+            }
+        }
+
+        inline void tcp_connection::close() {
+            if (_closed) {
+                return;
+            }
+            _closed = true;
+            _server->destroy(this);
+        }
+
+        /**
+         * 对端关闭时（EPOLLHUP/EPOLLRDHUP）接收缓冲区里可能还有没读的数据，
+         * 先读到EAGAIN或0交给消息回调，再由handleRead关闭连接
+         */
+        inline void tcp_connection::handleEvent(uint32_t events) {
+            if (events & EPOLLERR) {
+                close();
+                return;
+            }
+            if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+                handleRead();
+            }
+            if (!_closed && (events & EPOLLOUT)) {
+                handleWrite();
+            }
+            if (!_closed && (events & EPOLLHUP)) {
+                close(); // 两个方向都已关闭，写队列也发不出去了
+            }
+        }
+
+        // 边沿触发，一直读到EAGAIN为止；读到0说明对端不再发送，写队列发完后关闭连接
+        inline void tcp_connection::handleRead() {
+            char buf[65536];
+            bool peerClosed = false;
+            size_t before = _input.size();
+            while (true) {
+                ssize_t n = ::read(_fd, buf, sizeof(buf));
+                if (n > 0) {
+                    _input.append(buf, size_t(n));
+                } else if (n == 0) {
+                    peerClosed = true;
+                    break;
+                } else if (errno == EINTR) {
+                    continue;
+                } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                } else {
+                    close();
+                    return;
+                }
+            }
+            if (_input.size() != before && _server->_onMessage) {
+                _server->_onMessage(*this);
+            }
+            if (peerClosed) {
+                shutdown();
+            }
+        }
+
+        inline void tcp_connection::handleWrite() {
+            while (!_output.empty()) {
+                if (_output.send_to(_fd) < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                        break;
+                    }
+                    close();
+                    return;
+                }
+            }
+            updateEvents();
+            if (!_output.empty()) {
+                return;
+            }
+            if (_closing) {
+                close();
+            }
+        }
+
+        inline void tcp_connection::updateEvents() {
+            bool want = !_output.empty();
+            if (want != _writing) {
+                _writing = want;
+                _loop->modify(_fd, EPOLLIN | EPOLLRDHUP | EPOLLET | (want ? uint32_t(EPOLLOUT) : 0u));
+            }
+        }
+
+        // tcp_server具体实现
+
+        inline tcp_server::tcp_server(size_t threads) {
+            if (threads == 0) {
+                threads = 1;
+            }
+            for (size_t i = 0; i < threads; ++i) {
+                _reactors.push_back(std::make_unique<reactor>());
+            }
+        }
+
+        inline tcp_server::~tcp_server() {
+            stop();
+            for (std::thread& t : _threads) {
+                if (t.joinable()) {
+                    t.join();
+                }
+            }
+            for (auto& r : _reactors) {
+                for (auto& kv : r->_connections) {
+                    delete kv.second;
+                }
+                for (tcp_connection* c : r->_dead) {
+                    delete c;
+                }
+                if (r->_listenfd >= 0) {
+                    ::close(r->_listenfd);
+                }
+            }
+        }
+
+        // 每个reactor各建一个监听socket，port为0时第一个socket由系统分配端口，其余的绑定同一个端口
+        inline bool tcp_server::listen(uint16_t port, const char* ip) {
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            if (inet_pton(AF_INET, ip, &addr.sin_addr) != 1) {
+                return false;
+            }
+            for (auto& rp : _reactors) {
+                reactor& r = *rp;
+                int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                if (fd < 0) {
+                    return false;
+                }
+                int on = 1;
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+                setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on));
+                addr.sin_port = htons(port);
+                if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, SOMAXCONN) < 0) {
+                    ::close(fd);
+                    return false;
+                }
+                if (port == 0) {
+                    socklen_t len = sizeof(addr);
+                    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+                    port = ntohs(addr.sin_port);
+                }
+                r._listenfd = fd;
+                r._loop.add(fd, EPOLLIN, [this, &r](uint32_t) { handleAccept(r); });
+            }
+            _port = port;
+            return true;
+        }
+
+        inline void tcp_server::run() {
+            for (size_t i = 1; i < _reactors.size(); ++i) {
+                event_loop* loop = &_reactors[i]->_loop;
+                _threads.emplace_back([loop] { loop->run(); });
+            }
+            _reactors[0]->_loop.run();
+            for (std::thread& t : _threads) {
+                t.join();
+            }
+            _threads.clear();
+        }
+
+        inline void tcp_server::stop() {
+            for (auto& r : _reactors) {
+                r->_loop.stop();
+            }
+        }
+
+        // 监听socket是水平触发，每次事件最多接受一批连接，剩下的下一轮继续
+        inline void tcp_server::handleAccept(reactor& r) {
+            for (int i = 0; i < 64; ++i) {
+                int fd = ::accept4(r._listenfd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0) {
+                    return; // EAGAIN或暂时性错误（如文件描述符耗尽）
+                }
+                int on = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                tcp_connection* conn = new tcp_connection(this, &r._loop, fd);
+                if (!r._loop.add(fd, EPOLLIN | EPOLLRDHUP | EPOLLET, [conn](uint32_t ev) { conn->handleEvent(ev); })) {
+                    delete conn;
+                    continue;
+                }
+                r._connections[fd] = conn;
+                if (_onConnection) {
+                    _onConnection(*conn);
+                }
+            }
+        }
+
+        /**
+         * 回调可能还在使用连接对象，先放入_dead，由投递的任务在本轮事件处理完后释放
+         * fd在释放连接时才关闭，在此之前不会被新连接复用
+         */
+        inline void tcp_server::destroy(tcp_connection* conn) {
+            if (_onClose) {
+                _onClose(*conn);
+            }
+            for (auto& rp : _reactors) {
+                reactor& r = *rp;
+                if (&r._loop != conn->_loop) {
+                    continue;
+                }
+                r._connections.erase(conn->_fd);
+                r._loop.remove(conn->_fd);
+                r._dead.push_back(conn);
+                if (r._dead.size() == 1) {
+                    r._loop.post([&r] {
+                        for (tcp_connection* c : r._dead) {
+                            delete c;
+                        }
+                        r._dead.clear();
+                    });
+                }
+                break;
+            }
+        }
+    }
+}
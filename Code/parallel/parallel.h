@@ -0,0 +1,348 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include "thread_pool.h"
+#include "../vector/vector.h"
+
+namespace my {
+    /**
+     * 并行算法
+     * 输入是随机访问迭代器区间（如my::vector的T*迭代器），区间被切成若干块，
+     * 由内置线程池和调用线程一起处理。
+     * grain为每块的元素个数，传0时按线程数自动选择：块太小调度开销大，块太大负载不均衡。
+     * reduce和inclusive_scan要求op满足结合律，结果与顺序执行一致。
+     * 用户函数抛出异常时，其余尚未开始的块不再执行，等已经开始的块结束后，把第一个异常重新抛给调用者。
+     */
+    namespace parallel {
+        // 自动选择块大小时，每块至少包含的元素个数
+        inline constexpr size_t min_grain = 4096;
+
+        // 根据工作线程数创建线程池，0个工作线程时不创建，所有块由调用线程执行
+        inline std::unique_ptr<thread_pool> _make_pool(size_t workers) {
+            return std::unique_ptr<thread_pool>(workers == 0 ? nullptr : new thread_pool(workers));
+        }
+
+        /**
+         * 获取默认线程池，第一次使用时创建
+         * 调用线程自己也参与计算，因此工作线程数取CPU核数减1，参与计算的线程总数正好等于核数，不会超额订阅
+         */
+        inline std::unique_ptr<thread_pool>& _pool_holder() {
+            static std::unique_ptr<thread_pool> pool = _make_pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+            return pool;
+        }
+
+        // 默认线程池，单核机器上为nullptr
+        inline thread_pool* default_pool() {
+            return _pool_holder().get();
+        }
+
+        // 重新设置默认线程池的工作线程数（不含调用线程，可以为0），不能在并行算法执行期间调用
+        inline void set_thread_count(size_t workers) {
+            _pool_holder() = _make_pool(workers);
+        }
+
+        // 获取参与计算的线程数（工作线程 + 调用线程）
+        inline size_t thread_count() {
+            thread_pool* pool = default_pool();
+            return (pool ? pool->size() : 0) + 1;
+        }
+
+        // 根据元素个数和块大小算出块数，grain为0时每个线程大约分到4块
+        inline size_t _chunk_count(size_t n, size_t grain) {
+            if (n == 0) {
+                return 0;
+            }
+            if (grain == 0) {
+                grain = std::max(min_grain, n / (thread_count() * 4));
+            }
+            return (n + grain - 1) / grain;
+        }
+
+        /**
+         * 并行执行 f(0), f(1), ..., f(chunks - 1)
+         * 调用线程自己也参与领取任务，因此即使线程池中的线程都在忙（如嵌套调用），也一定能完成
+         * 块的下标通过原子计数器分发，先到先得，天然负载均衡
+         * 某一块抛出异常时记下第一个异常，之后领到的块直接跳过（仍计入已完成），
+         * 调用线程等所有块都结束后再重新抛出；此后没有线程还会调用f，所以按引用捕获f是安全的
+         */
+        template <class F>
+        void _run_chunks(size_t chunks, const F& f) {
+            thread_pool* pool = default_pool();
+            if (chunks <= 1 || pool == nullptr) {
+                for (size_t i = 0; i < chunks; i++) {
+                    f(i);
+                }
+                return;
+            }
+            struct state {
+                std::atomic<size_t> _next{ 0 }; // 下一个待领取的块
+                std::atomic<size_t> _done{ 0 }; // 已结束的块数
+                std::atomic<bool> _failed{ false }; // 是否已有块抛出异常
+                std::exception_ptr _error; // 第一个异常，由_mtx保护
+                std::mutex _mtx;
+                std::condition_variable _cv;
+            };
+            auto st = std::make_shared<state>();
+            auto work = [st, &f, chunks] {
+                size_t i;
+                while ((i = st->_next.fetch_add(1)) < chunks) {
+                    if (!st->_failed.load(std::memory_order_relaxed)) {
+                        try {
+                            f(i);
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(st->_mtx);
+                            if (!st->_error) {
+                                st->_error = std::current_exception();
+                            }
+                            st->_failed.store(true, std::memory_order_relaxed);
+                        }
+                    }
+                    if (st->_done.fetch_add(1) + 1 == chunks) {
+                        std::lock_guard<std::mutex> lock(st->_mtx);
+                        st->_cv.notify_all();
+                    }
+                }
+            };
+            // 提交失败（如内存不足）也没关系，剩下的块都会由调用线程领取
+            size_t helpers = std::min(pool->size(), chunks - 1);
+            try {
+                for (size_t i = 0; i < helpers; i++) {
+                    pool->submit(work);
+                }
+            } catch (...) {
+            }
+            work();
+            std::unique_lock<std::mutex> lock(st->_mtx);
+            st->_cv.wait(lock, [&] { return st->_done.load() == chunks; });
+            if (st->_error) {
+                std::rethrow_exception(st->_error);
+            }
+        }
+
+        // 对每个元素调用f
+        template <class RandomIt, class F>
+        void for_each(RandomIt first, RandomIt last, F f, size_t grain = 0) {
+            size_t n = last - first;
+            size_t chunks = _chunk_count(n, grain);
+            _run_chunks(chunks, [&](size_t c) {
+                std::for_each(first + c * n / chunks, first + (c + 1) * n / chunks, f);
+            });
+        }
+
+        // 对每个元素调用f，结果写入out开始的区间，返回写入结束后的位置
+        template <class RandomIt, class OutIt, class F>
+        OutIt transform(RandomIt first, RandomIt last, OutIt out, F f, size_t grain = 0) {
+            size_t n = last - first;
+            size_t chunks = _chunk_count(n, grain);
+            _run_chunks(chunks, [&](size_t c) {
+                size_t b = c * n / chunks, e = (c + 1) * n / chunks;
+                std::transform(first + b, first + e, out + b, f);
+            });
+            return out + n;
+        }
+
+        // 归约，每块先各自求部分和，再按块的顺序合并到init上
+        template <class RandomIt, class T, class Op = std::plus<>>
+        T reduce(RandomIt first, RandomIt last, T init, Op op = Op(), size_t grain = 0) {
+            size_t n = last - first;
+            size_t chunks = _chunk_count(n, grain);
+            if (chunks == 0) {
+                return init;
+            }
+            vector<T> partial(chunks, init);
+            _run_chunks(chunks, [&](size_t c) {
+                RandomIt b = first + c * n / chunks, e = first + (c + 1) * n / chunks;
+                T acc = *b;
+                for (++b; b != e; ++b) {
+                    acc = op(acc, *b);
+                }
+                partial[c] = acc;
+            });
+            for (size_t c = 0; c < chunks; c++) {
+                init = op(init, partial[c]);
+            }
+            return init;
+        }
+
+        // 查找第一个满足pred的元素，找不到返回last
+        // 用原子变量记录目前找到的最小下标，位于其后的块直接跳过
+        template <class RandomIt, class Pred>
+        RandomIt find_if(RandomIt first, RandomIt last, Pred pred, size_t grain = 0) {
+            size_t n = last - first;
+            size_t chunks = _chunk_count(n, grain);
+            std::atomic<size_t> found(n);
+            _run_chunks(chunks, [&](size_t c) {
+                size_t b = c * n / chunks, e = (c + 1) * n / chunks;
+                for (size_t i = b; i < e && i < found.load(std::memory_order_relaxed); i++) {
+                    if (pred(first[i])) {
+                        size_t cur = found.load();
+                        while (i < cur && !found.compare_exchange_weak(cur, i)) {}
+                        return;
+                    }
+                }
+            });
+            return first + found.load();
+        }
+
+        /**
+         * 包含式前缀扫描，out[i] = first[0] op first[1] op ... op first[i]
+         * 1、每块并行求出块内的总和。
+         * 2、顺序求出每块之前所有块的前缀（块数很少，代价可以忽略）。
+         * 3、每块带着自己的前缀并行做块内扫描。
+         * out可以等于first（原地扫描），返回写入结束后的位置
+         */
+        template <class RandomIt, class OutIt, class Op = std::plus<>>
+        OutIt inclusive_scan(RandomIt first, RandomIt last, OutIt out, Op op = Op(), size_t grain = 0) {
+            typedef typename std::iterator_traits<RandomIt>::value_type T;
+            size_t n = last - first;
+            size_t chunks = _chunk_count(n, grain);
+            if (chunks == 0) {
+                return out;
+            }
+            vector<T> sums(chunks, *first);
+            _run_chunks(chunks, [&](size_t c) {
+                RandomIt b = first + c * n / chunks, e = first + (c + 1) * n / chunks;
+                T acc = *b;
+                for (++b; b != e; ++b) {
+                    acc = op(acc, *b);
+                }
+                sums[c] = acc;
+            });
+            for (size_t c = 1; c < chunks; c++) {
+                sums[c] = op(sums[c - 1], sums[c]); // sums[c]变为前c+1块的总和
+            }
+            _run_chunks(chunks, [&](size_t c) {
+                size_t b = c * n / chunks, e = (c + 1) * n / chunks;
+                T acc = c == 0 ? first[b] : op(sums[c - 1], first[b]);
+                out[b] = acc;
+                for (size_t i = b + 1; i < e; i++) {
+                    acc = op(acc, first[i]);
+                    out[i] = acc;
+                }
+            });
+            return out + n;
+        }
+
+        /**
+         * 归并路径划分：A、B两个有序区间归并后的前k个元素中，有多少个来自A
+         * 相等的元素A在前（与std::merge一致）。在[max(0, k - lb), min(k, la)]中二分，
+         * 找到最小的i，使 i == min(k, la) 或 B[k - i - 1] < A[i]，即A[i]不应再排进前k个
+         */
+        template <class It, class Compare>
+        size_t _merge_split(It a, size_t la, It b, size_t lb, size_t k, Compare& comp) {
+            size_t lo = k > lb ? k - lb : 0;
+            size_t hi = std::min(k, la);
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (!comp(b[k - mid - 1], a[mid])) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo;
+        }
+
+        /**
+         * 归并排序的一轮：src中每width块是一段有序区间，相邻两段归并后写入dst
+         * 每段归并的输出按原来的块边界切开，第c块的输出用_merge_split定位它在两段输入中的起点和终点，
+         * 因此每个块独立完成、并行执行，最后一轮（只剩一次归并）也能用上所有线程
+         */
+        template <class Src, class Dst, class Bound, class Compare>
+        void _merge_round(Src src, Dst dst, size_t chunks, size_t width, Bound& bound, Compare& comp) {
+            _run_chunks(chunks, [&](size_t c) {
+                size_t left = c / (2 * width) * (2 * width);
+                size_t mid = std::min(left + width, chunks);
+                size_t right = std::min(left + 2 * width, chunks);
+                size_t base = bound(left), la = bound(mid) - base, lb = bound(right) - bound(mid);
+                size_t k0 = bound(c) - base, k1 = bound(c + 1) - base; // 本块负责归并结果的[k0, k1)
+                size_t i0 = _merge_split(src + base, la, src + base + la, lb, k0, comp);
+                size_t i1 = _merge_split(src + base, la, src + base + la, lb, k1, comp);
+                std::merge(std::make_move_iterator(src + base + i0), std::make_move_iterator(src + base + i1),
+                    std::make_move_iterator(src + base + la + (k0 - i0)), std::make_move_iterator(src + base + la + (k1 - i1)),
+                    dst + base + k0, comp);
+            });
+        }
+
+        // 归并排序的辅助空间，记录每块是否已构造，析构时（包括异常退出时）只销毁已构造的块
+        template <class T>
+        struct _merge_buffer {
+            _merge_buffer(size_t n, size_t chunks) : _data(std::allocator<T>().allocate(n)), _n(n), _built(chunks, char(0)) {}
+            _merge_buffer(const _merge_buffer&) = delete;
+            _merge_buffer& operator=(const _merge_buffer&) = delete;
+            template <class Bound>
+            void destroy(Bound& bound) {
+                if constexpr (!std::is_trivially_destructible_v<T>) {
+                    _run_chunks(_built.size(), [&](size_t c) {
+                        if (_built[c]) {
+                            std::destroy(_data + bound(c), _data + bound(c + 1));
+                            _built[c] = 0;
+                        }
+                    });
+                }
+            }
+            ~_merge_buffer() {
+                if constexpr (!std::is_trivially_destructible_v<T>) {
+                    size_t chunks = _built.size();
+                    for (size_t c = 0; c < chunks; c++) {
+                        if (_built[c]) {
+                            std::destroy(_data + c * _n / chunks, _data + (c + 1) * _n / chunks);
+                        }
+                    }
+                }
+                std::allocator<T>().deallocate(_data, _n);
+            }
+
+            T* _data;
+            size_t _n;
+            vector<char> _built;
+        };
+
+        /**
+         * 并行归并排序
+         * 1、区间切成若干块，每块并行调用std::sort（内省排序），排好后移动到辅助空间中。
+         * 2、相邻的有序段两两归并，在原区间和辅助空间之间来回移动，段宽每轮翻倍，直到整体有序。
+         *    每一轮都按输出位置切块并行（见_merge_round），不会退化成单线程的inplace_merge。
+         * grain为0时块数取参与计算的线程数。需要n个元素的辅助空间，元素类型只要求可移动构造、可移动赋值
+         */
+        template <class RandomIt, class Compare = std::less<>>
+        void sort(RandomIt first, RandomIt last, Compare comp = Compare(), size_t grain = 0) {
+            typedef typename std::iterator_traits<RandomIt>::value_type T;
+            size_t n = last - first;
+            size_t chunks = grain == 0 ? std::min(thread_count(), (n + min_grain - 1) / min_grain) : _chunk_count(n, grain);
+            if (chunks <= 1) {
+                std::sort(first, last, comp);
+                return;
+            }
+            auto bound = [&](size_t c) { return std::min(c, chunks) * n / chunks; }; // 第c块的起始下标
+            _merge_buffer<T> buf(n, chunks);
+            _run_chunks(chunks, [&](size_t c) {
+                std::sort(first + bound(c), first + bound(c + 1), comp);
+                std::uninitialized_move(first + bound(c), first + bound(c + 1), buf._data + bound(c));
+                buf._built[c] = 1;
+            });
+            bool inBuffer = true; // 当前的有序段位于辅助空间中
+            for (size_t width = 1; width < chunks; width *= 2) {
+                if (inBuffer) {
+                    _merge_round(buf._data, first, chunks, width, bound, comp);
+                } else {
+                    _merge_round(first, buf._data, chunks, width, bound, comp);
+                }
+                inBuffer = !inBuffer;
+            }
+            if (inBuffer) {
+                _run_chunks(chunks, [&](size_t c) {
+                    std::move(buf._data + bound(c), buf._data + bound(c + 1), first + bound(c));
+                });
+            }
+            buf.destroy(bound);
+        }
+    }
+}
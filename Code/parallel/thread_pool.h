@@ -0,0 +1,93 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../queue/queue.h"
+
+namespace my {
+    /**
+     * 固定线程数的线程池
+     * 任务放在一个由互斥锁保护的my::queue中，工作线程用条件变量等待新任务。
+     * 析构时先处理完队列中剩余的任务，再让所有工作线程退出。
+     */
+    class thread_pool {
+    public:
+        thread_pool(size_t threads = std::thread::hardware_concurrency()); // 构造函数，启动threads个工作线程
+        thread_pool(const thread_pool&) = delete;
+        thread_pool& operator=(const thread_pool&) = delete;
+        ~thread_pool(); // 析构函数，等待所有工作线程退出
+
+        void submit(std::function<void()> task); // 提交一个任务
+        size_t size() const; // 获取工作线程个数
+
+    private:
+        void workerLoop(); // 工作线程主循环
+
+        std::vector<std::thread> _workers; // 工作线程
+        queue<std::function<void()>> _tasks; // 任务队列
+        std::mutex _mtx; // 保护任务队列
+        std::condition_variable _cv; // 有新任务或需要退出时通知工作线程
+        bool _stop; // 是否需要退出
+    };
+
+    // 线程池具体实现
+
+    // 构造函数，至少启动一个工作线程
+    inline thread_pool::thread_pool(size_t threads)
+        : _stop(false)
+    {
+        if (threads == 0) {
+            threads = 1;
+        }
+        _workers.reserve(threads);
+        for (size_t i = 0; i < threads; i++) {
+            _workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    // 析构函数
+    inline thread_pool::~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _stop = true;
+        }
+        _cv.notify_all();
+        for (auto& t : _workers) {
+            t.join();
+        }
+    }
+
+    // 提交一个任务
+    inline void thread_pool::submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _tasks.push(std::move(task));
+        }
+        _cv.notify_one();
+    }
+
+    // 获取工作线程个数
+    inline size_t thread_pool::size() const {
+        return _workers.size();
+    }
+
+    // 工作线程主循环，队列为空且需要退出时结束
+    inline void thread_pool::workerLoop() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(_mtx);
+                _cv.wait(lock, [this] { return _stop || !_tasks.empty(); });
+                if (_tasks.empty()) {
+                    return;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop();
+            }
+            task();
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <vector>
+#include "priority_queue.h"
+
+namespace my {
+    // 多路归并中每一路的游标
+    template <class InputIterator>
+    struct _merge_cursor {
+        InputIterator _cur; // 当前位置
+        InputIterator _end; // 结束位置
+        size_t _run; // 所属的路编号，用于相等元素的稳定排序
+    };
+
+    // 游标比较器 按当前元素比较，相等时编号小的路优先，保证归并结果稳定
+    template <class InputIterator, class Compare>
+    struct _merge_cursor_compare {
+        bool operator()(const _merge_cursor<InputIterator>& x, const _merge_cursor<InputIterator>& y) const {
+            if (_compare(*x._cur, *y._cur)) {
+                return true;
+            }
+            if (_compare(*y._cur, *x._cur)) {
+                return false;
+            }
+            return x._run < y._run;
+        }
+        Compare _compare;
+    };
+
+    /**
+     * 多路归并
+     * runs中每个元素是一对迭代器[first, second)，表示一路按Compare升序排好的序列
+     * 1、每一路的游标放入一个反向堆中，堆顶是当前所有路中最小的元素。
+     * 2、输出堆顶元素后，游标后移：该路未结束时用replace_top替换堆顶，只做一次向下调整；
+     *    该路结束时才pop。
+     * 总复杂度为 O(N log K)，N为元素总数，K为路数。
+     * 与priority_queue一样，比较器在内部默认构造，传入的比较器对象只用于推导类型。
+     * 返回写入结束后的输出迭代器
+     */
+    template <class Runs, class OutputIterator,
+              class InputIterator = typename Runs::value_type::first_type,
+              class Compare = less<typename std::iterator_traits<InputIterator>::value_type>>
+    OutputIterator kway_merge(const Runs& runs, OutputIterator out, Compare = Compare()) {
+        typedef _merge_cursor<InputIterator> cursor;
+        typedef _reverse_compare<_merge_cursor_compare<InputIterator, Compare>> cursor_compare;
+
+        priority_queue<cursor, std::vector<cursor>, cursor_compare> heap;
+        size_t run = 0;
+        for (const auto& r : runs) {
+            if (r.first != r.second) { // 跳过空的路
+                heap.push(cursor{ r.first, r.second, run });
+            }
+            run++;
+        }
+
+        while (!heap.empty()) {
+            cursor c = heap.top();
+            *out = *c._cur;
+            ++out;
+            ++c._cur;
+            if (c._cur != c._end) {
+                heap.replace_top(c); // 该路还有元素，原地替换堆顶
+            } else {
+                heap.pop(); // 该路已耗尽
+            }
+        }
+        return out;
+    }
+}
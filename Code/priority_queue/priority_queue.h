@@ -1,3 +1,5 @@
+#pragma once
+#include <cstddef>
 #include <vector>
 namespace my {
     // 比较器 内部结构为大堆
@@ -14,6 +16,15 @@ namespace my {
             return x > y; // 默认大于比较
         }
     };
+    // 反转比较器 交换参数顺序，把大堆变成小堆（或反之）
+    template <class Compare>
+    struct _reverse_compare {
+        template <class T>
+        bool operator()(const T& x, const T& y) const {
+            return _compare(y, x);
+        }
+        Compare _compare;
+    };
 
     // 优先队列类模板
     template <class T, class Container = std::vector<T>, class Compare = less<T>>
@@ -23,6 +34,7 @@ namespace my {
         void adjustDown(int n, int parent); // 向下调整
         void push(const T& x); // 插入队尾
         void pop(); // 弹出队头
+        void replace_top(const T& x); // 用x替换队头，只做一次向下调整
         T& top(); // 获取队头元素
         const T& top() const; // 获取队头元素的常量引用
         size_t size() const; // 获取队列中有效元素的个数
@@ -86,6 +98,17 @@ namespace my {
         adjustDown(_container.size(), 0); // 将根节点进行一次向下调整
     }
 
+    /**
+     * 用x替换队头
+     * 等价于先pop再push，但只需要一次向下调整，
+     * 适合“弹出最优元素后马上插入一个新元素”的场景（如Top-K、多路归并）
+     */
+    template <class T, class Container, class Compare>
+    void priority_queue<T, Container, Compare>::replace_top(const T& x) {
+        _container[0] = x;
+        adjustDown(_container.size(), 0); // 将新的根节点进行一次向下调整
+    }
+
     // 获取队头元素
     template <class T, class Container, class Compare>
     T& priority_queue<T, Container, Compare>::top() {
@@ -0,0 +1,146 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include "../hardening/hardening.h"
+#include "../vector/vector.h"
+
+namespace my {
+    /**
+     * 把键映射为保持大小顺序的无符号整数
+     * 无符号整数不变；有符号整数翻转符号位；浮点数为正时翻转符号位、为负时按位取反（不支持NaN）
+     */
+    template <class Key, class Enable = void>
+    struct _radix_key;
+
+    template <class Key>
+    struct _radix_key<Key, std::enable_if_t<std::is_integral_v<Key>>> {
+        typedef std::conditional_t<(sizeof(Key) <= 4), uint32_t, uint64_t> type;
+        static type encode(Key k) {
+            if constexpr (std::is_signed_v<Key>) {
+                return type(std::make_unsigned_t<Key>(k)) ^ (type(1) << (sizeof(Key) * 8 - 1));
+            } else {
+                return type(k);
+            }
+        }
+    };
+
+    template <class Key>
+    struct _radix_key<Key, std::enable_if_t<std::is_floating_point_v<Key> && (sizeof(Key) == 4 || sizeof(Key) == 8)>> {
+        typedef std::conditional_t<sizeof(Key) == 4, uint32_t, uint64_t> type;
+        static type encode(Key k) {
+            type u = std::bit_cast<type>(k);
+            constexpr type sign = type(1) << (sizeof(type) * 8 - 1);
+            return (u & sign) ? ~u : (u | sign);
+        }
+    };
+
+    /**
+     * 基数堆（单调优先队列），小堆
+     * 适用于弹出的键单调不减的场景（Dijkstra、离散事件模拟）：新插入的键不能小于最近一次top/pop得到的键
+     * 按键与“当前最小键”最高的不同二进制位分桶，第i个桶中的键与最小键在第i-1位首次不同，共 位数+1 个桶；
+     * 第0个桶存放等于最小键的元素，top/pop直接在这里进行
+     * 第0个桶取空后，下一次top/pop时找到第一个非空的桶，以其中的最小键作为新的最小键，把该桶的元素重新分到更低的桶中
+     * 每个元素最多被下移 位数 次，push/pop均摊O(log C)（C为键的取值范围），过程中只有整数比较和顺序扫描，
+     * 没有二叉堆那样难以预测的分支；每个桶是一段连续的数组
+     * 接口与priority_queue一致；top只能读，修改键会破坏分桶；top可能重新分桶，同一个堆不能被多个线程同时读
+     */
+    template <class Key, class Value>
+    class radix_heap {
+    public:
+        typedef std::pair<Key, Value> value_type;
+
+        void push(const Key& key, const Value& value); // 插入，key不能小于最近一次top/pop得到的键
+        void push(const value_type& x) { push(x.first, x.second); }
+        void pop(); // 弹出键最小的元素
+        const value_type& top() const; // 获取键最小的元素
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        void clear(); // 清空，同时重置单调性的下界
+
+    private:
+        typedef typename _radix_key<Key>::type ukey;
+        static constexpr int Bits = sizeof(ukey) * 8;
+
+        // 键u所在的桶：与最小键相同时为0，否则为最高不同位的位置加1
+        size_t bucketOf(ukey u) const { return u == _last ? 0 : size_t(std::bit_width(ukey(u ^ _last))); }
+        void place(value_type&& x) const; // 按当前最小键放入对应的桶
+        void pull() const; // 第0个桶为空时，从第一个非空的桶中重新分配
+
+        // 重新分桶不改变堆中的元素，top()中也可以进行
+        mutable vector<value_type> _buckets[Bits + 1];
+        mutable uint64_t _nonempty = 0; // 第i位表示第i+1个桶非空，查找第一个非空桶只需一条指令
+        mutable ukey _last = 0; // 最近一次top/pop得到的键
+        size_t _size = 0;
+    };
+
+    // 基数堆具体实现
+
+    template <class Key, class Value>
+    void radix_heap<Key, Value>::place(value_type&& x) const {
+        size_t i = bucketOf(_radix_key<Key>::encode(x.first));
+        _buckets[i].push_back(std::move(x));
+        if (i > 0) {
+            _nonempty |= uint64_t(1) << (i - 1);
+        }
+    }
+
+    template <class Key, class Value>
+    void radix_heap<Key, Value>::push(const Key& key, const Value& value) {
+        MY_CHECK_CHEAP(_radix_key<Key>::encode(key) >= _last); // 键必须单调不减
+        place(value_type(key, value));
+        _size++;
+    }
+
+    // 弹出后不立即重新分桶：此时插入介于刚弹出的键和剩余最小键之间的键仍然是合法的
+    template <class Key, class Value>
+    void radix_heap<Key, Value>::pop() {
+        MY_CHECK_CHEAP(_size > 0);
+        if (_buckets[0].empty()) {
+            pull();
+        }
+        _buckets[0].pop_back();
+        _size--;
+    }
+
+    template <class Key, class Value>
+    const typename radix_heap<Key, Value>::value_type& radix_heap<Key, Value>::top() const {
+        MY_CHECK_CHEAP(_size > 0);
+        if (_buckets[0].empty()) {
+            pull();
+        }
+        return _buckets[0].data()[_buckets[0].size() - 1];
+    }
+
+    template <class Key, class Value>
+    void radix_heap<Key, Value>::clear() {
+        for (vector<value_type>& b : _buckets) {
+            b.clear();
+        }
+        _nonempty = 0;
+        _last = 0;
+        _size = 0;
+    }
+
+    // 该桶中所有键与旧的最小键在同一位首次不同，换成桶内最小键后，它们的最高不同位都更低，一定落到更低的桶中
+    template <class Key, class Value>
+    void radix_heap<Key, Value>::pull() const {
+        size_t i = size_t(std::countr_zero(_nonempty)) + 1;
+        vector<value_type>& b = _buckets[i];
+        value_type* p = b.data();
+        size_t n = b.size();
+        ukey m = _radix_key<Key>::encode(p[0].first);
+        for (size_t j = 1; j < n; j++) {
+            ukey u = _radix_key<Key>::encode(p[j].first);
+            m = u < m ? u : m;
+        }
+        _last = m;
+        for (size_t j = 0; j < n; j++) {
+            place(std::move(p[j]));
+        }
+        b.clear();
+        _nonempty &= ~(uint64_t(1) << (i - 1));
+    }
+}
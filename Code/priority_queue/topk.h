@@ -0,0 +1,96 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "priority_queue.h"
+
+namespace my {
+    /**
+     * 有界Top-K容器，保留数据流中按Compare排序“最大”的K个元素
+     * 1、内部是一个容量为K的反向堆（Compare为less时是小堆），堆顶是当前第K大的元素，即门槛。
+     * 2、未满K个时直接入堆；已满时先与堆顶比较一次，不超过门槛的元素直接丢弃，
+     *    否则用replace_top原地替换堆顶，只做一次向下调整。
+     * 对于绝大多数元素都被拒绝的长数据流，每个元素平均只需一次比较。
+     */
+    template <class T, class Compare = less<T>>
+    class topk {
+    public:
+        topk(size_t k); // 构造函数，k为保留的元素个数
+
+        bool push(const T& x); // 插入元素，返回该元素是否被保留
+        const T& top() const; // 获取当前门槛（保留元素中最差的那个）
+        size_t size() const; // 获取当前保留的元素个数
+        size_t k() const; // 获取上限K
+        bool empty() const; // 检查是否为空
+        bool full() const; // 检查是否已保留K个元素
+        std::vector<T> take_sorted(); // 取出全部保留元素，按从优到劣排列，取出后容器为空
+
+    private:
+        priority_queue<T, std::vector<T>, _reverse_compare<Compare>> _heap; // 反向堆，堆顶为门槛
+        size_t _k; // 保留元素个数上限
+        Compare _compare; // 比较方式
+    };
+
+    // Top-K具体实现
+
+    // 构造函数
+    template <class T, class Compare>
+    topk<T, Compare>::topk(size_t k)
+        : _k(k)
+    {}
+
+    // 插入元素
+    template <class T, class Compare>
+    bool topk<T, Compare>::push(const T& x) {
+        if (_heap.size() < _k) { // 未满K个，直接入堆
+            _heap.push(x);
+            return true;
+        }
+        if (_k == 0 || !_compare(_heap.top(), x)) { // 不优于门槛，直接丢弃
+            return false;
+        }
+        _heap.replace_top(x); // 替换门槛，一次向下调整
+        return true;
+    }
+
+    // 获取当前门槛
+    template <class T, class Compare>
+    const T& topk<T, Compare>::top() const {
+        return _heap.top();
+    }
+
+    // 获取当前保留的元素个数
+    template <class T, class Compare>
+    size_t topk<T, Compare>::size() const {
+        return _heap.size();
+    }
+
+    // 获取上限K
+    template <class T, class Compare>
+    size_t topk<T, Compare>::k() const {
+        return _k;
+    }
+
+    // 检查是否为空
+    template <class T, class Compare>
+    bool topk<T, Compare>::empty() const {
+        return _heap.empty();
+    }
+
+    // 检查是否已保留K个元素
+    template <class T, class Compare>
+    bool topk<T, Compare>::full() const {
+        return _heap.size() >= _k;
+    }
+
+    // 取出全部保留元素，堆顶依次是从劣到优，所以倒着填入结果
+    template <class T, class Compare>
+    std::vector<T> topk<T, Compare>::take_sorted() {
+        std::vector<T> result(_heap.size());
+        size_t i = result.size();
+        while (!_heap.empty()) {
+            result[--i] = _heap.top();
+            _heap.pop();
+        }
+        return result;
+    }
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include <deque>
+#include <iterator>
+#include <utility>
 
 namespace my {
     template <class T, class Container = std::deque<T>>
@@ -10,11 +12,66 @@ namespace my {
             _container.push_back(value);
         }
 
+        // 队尾入队列（右值版本），直接移动进容器，避免大对象的深拷贝
+        void push(T&& value) {
+            _container.push_back(std::move(value));
+        }
+
+        // 在队尾原地构造元素，参数完美转发给T的构造函数
+        template <class... Args>
+        T& emplace(Args&&... args) {
+            if constexpr (requires { _container.emplace_back(std::forward<Args>(args)...); }) {
+                _container.emplace_back(std::forward<Args>(args)...);
+            } else {
+                _container.push_back(T(std::forward<Args>(args)...));
+            }
+            return _container.back();
+        }
+
+        // 批量入队列，[first, last)中的元素按顺序追加到队尾
+        // 底层容器支持区间插入时一次性插入，否则逐个尾插
+        template <class InputIterator>
+        void push_range(InputIterator first, InputIterator last) {
+            if constexpr (requires { _container.insert(_container.end(), first, last); }) {
+                _container.insert(_container.end(), first, last);
+            } else {
+                while (first != last) {
+                    _container.push_back(*first);
+                    ++first;
+                }
+            }
+        }
+
         // 队头出队列
         void pop() {
             _container.pop_front();
         }
 
+        /**
+         * 批量出队列，最多弹出n个元素，按出队顺序（队头在前）移动到out
+         * 底层容器支持区间删除时，先整体移动再一次性删除头部，否则逐个弹出
+         * 返回写入结束后的输出迭代器
+         */
+        template <class OutputIterator>
+        OutputIterator pop_n(OutputIterator out, size_t n) {
+            if (n > _container.size()) {
+                n = _container.size();
+            }
+            if constexpr (requires { _container.erase(_container.begin(), _container.end()); }) {
+                auto first = _container.begin();
+                auto last = std::next(first, n);
+                out = std::move(first, last, out);
+                _container.erase(first, last);
+            } else {
+                while (n--) {
+                    *out = std::move(_container.front());
+                    ++out;
+                    _container.pop_front();
+                }
+            }
+            return out;
+        }
+
         // 获取队头元素
         T& front() {
             return _container.front();
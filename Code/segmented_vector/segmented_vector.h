@@ -0,0 +1,286 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include "../hardening/hardening.h"
+#include "../telemetry/telemetry.h"
+
+namespace my {
+    template <class T, size_t First, class Alloc>
+    class segmented_vector;
+
+    /**
+     * segmented_vector的迭代器
+     * 除了下标，还缓存当前元素的地址和所在分段的末尾，顺序遍历时只有走到分段末尾才重新定位
+     * 元素不会被搬动，迭代器在push_back之后仍然有效；创建时下标还不小于size()的迭代器（如end()），
+     * 在之后的push_back使该下标有效后也可以解引用，此时再定位
+     */
+    template <class Owner, class U>
+    struct _segmented_iterator {
+        typedef _segmented_iterator<Owner, U> self;
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::remove_const_t<U> value_type;
+        typedef ptrdiff_t difference_type;
+        typedef U* pointer;
+        typedef U& reference;
+
+        _segmented_iterator() = default;
+        _segmented_iterator(Owner* owner, size_t index) : _owner(owner), _index(index) { locate(); }
+
+        U& operator*() const { return *get(); }
+        U* operator->() const { return get(); }
+        U& operator[](ptrdiff_t n) const { return (*_owner)[_index + n]; }
+        self& operator++() {
+            ++_index;
+            if (!_ptr || ++_ptr == _segmentEnd) {
+                locate();
+            }
+            return *this;
+        }
+        self& operator--() {
+            --_index;
+            locate();
+            return *this;
+        }
+        self operator++(int) { self tmp(*this); ++*this; return tmp; }
+        self operator--(int) { self tmp(*this); --*this; return tmp; }
+        self& operator+=(ptrdiff_t n) { _index += n; locate(); return *this; }
+        self& operator-=(ptrdiff_t n) { _index -= n; locate(); return *this; }
+        self operator+(ptrdiff_t n) const { self tmp(*this); return tmp += n; }
+        self operator-(ptrdiff_t n) const { self tmp(*this); return tmp -= n; }
+        ptrdiff_t operator-(const self& rhs) const { return ptrdiff_t(_index) - ptrdiff_t(rhs._index); }
+        bool operator==(const self& rhs) const { return _index == rhs._index; }
+        bool operator!=(const self& rhs) const { return _index != rhs._index; }
+        bool operator<(const self& rhs) const { return _index < rhs._index; }
+        bool operator>(const self& rhs) const { return _index > rhs._index; }
+        bool operator<=(const self& rhs) const { return _index <= rhs._index; }
+        bool operator>=(const self& rhs) const { return _index >= rhs._index; }
+
+        // 根据下标重新计算地址和分段末尾；下标不小于size()（如end()）时不计算
+        // 只用已发布的长度判断，不读写线程正在修改的段数，读线程可以与push_back同时遍历
+        void locate() const {
+            if (_index < _owner->size()) {
+                size_t k = Owner::segmentOf(_index);
+                U* seg = _owner->_segments[k];
+                _ptr = seg + (_index - Owner::segmentStart(k));
+                _segmentEnd = seg + Owner::segment_size(k);
+            } else {
+                _ptr = nullptr;
+                _segmentEnd = nullptr;
+            }
+        }
+
+        U* get() const {
+            if (!_ptr) {
+                locate();
+            }
+            return _ptr;
+        }
+
+        Owner* _owner = nullptr;
+        size_t _index = 0;
+        mutable U* _ptr = nullptr; // 当前元素的地址，未定位时为空
+        mutable U* _segmentEnd = nullptr;
+    };
+
+    /**
+     * 分段vector，元素一旦放入就不再搬动
+     * 第k段的长度为 First * 2^k，容量不足时只申请下一段，已有元素留在原地：
+     * 没有vector扩容时整体拷贝的延迟尖刺，元素的指针和引用在pop_back/clear之前一直有效
+     * 下标i加上First后最高位的位置就是段号，下标访问是一次前导零计数加一次查表，O(1)
+     * 段表是定长数组，永远不会重新分配；长度用release/acquire发布，
+     * 一个线程push_back的同时，其他线程可以读取下标小于size()的元素
+     * First必须是2的幂
+     */
+    template <class T, size_t First = 16, class Alloc = std::allocator<T>>
+    class segmented_vector {
+        static_assert(First > 0 && (First & (First - 1)) == 0, "First must be a power of 2");
+
+    public:
+        typedef T value_type;
+        typedef Alloc allocator_type;
+        typedef std::allocator_traits<Alloc> alloc_traits;
+        typedef _segmented_iterator<segmented_vector, T> iterator;
+        typedef _segmented_iterator<const segmented_vector, const T> const_iterator;
+
+        // 默认成员函数
+        segmented_vector() = default;
+        segmented_vector(const segmented_vector& v);
+        segmented_vector(segmented_vector&& v) noexcept;
+        segmented_vector& operator=(segmented_vector v) noexcept; // 拷贝并交换，同时用作移动赋值
+        ~segmented_vector();
+
+        // 迭代器
+        iterator begin() { return iterator(this, 0); }
+        iterator end() { return iterator(this, size()); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+
+        // 容量和大小（capacity和segment_count只能由写线程调用）
+        size_t size() const { return _size.load(std::memory_order_acquire); }
+        size_t capacity() const { return segmentStart(_segmentCount); }
+        bool empty() const { return size() == 0; }
+        void reserve(size_t n); // 提前申请足够的分段，不搬动元素
+
+        // 修改容器内容（只能有一个线程写）
+        void push_back(const T& x) { emplace_back(x); }
+        void push_back(T&& x) { emplace_back(std::move(x)); }
+        template <class... Args>
+        T& emplace_back(Args&&... args);
+        void pop_back();
+        void clear(); // 析构所有元素，保留分段
+        void swap(segmented_vector& v) noexcept;
+
+        // 访问容器
+        T& operator[](size_t i);
+        const T& operator[](size_t i) const;
+        T& back() { return (*this)[size() - 1]; }
+        const T& back() const { return (*this)[size() - 1]; }
+
+        // 按分段访问，热循环中逐段处理连续内存
+        size_t segment_count() const { return _segmentCount; }
+        T* segment_data(size_t k) { return _segments[k]; } // 第k段的首地址
+        const T* segment_data(size_t k) const { return _segments[k]; }
+        static constexpr size_t segment_size(size_t k) { return First << k; } // 第k段的长度
+
+    private:
+        template <class Owner, class U>
+        friend struct _segmented_iterator;
+
+        static constexpr size_t FirstBits = std::countr_zero(First);
+        static constexpr size_t MaxSegments = sizeof(size_t) * 8 - FirstBits;
+
+        // 下标i所在的段和第k段第一个元素的下标
+        static size_t segmentOf(size_t i) { return size_t(std::bit_width(i + First)) - 1 - FirstBits; }
+        static constexpr size_t segmentStart(size_t k) { return (First << k) - First; }
+
+        T* slot(size_t i) const { // 下标i的地址，不检查
+            size_t k = segmentOf(i);
+            return _segments[k] + (i - segmentStart(k));
+        }
+        void addSegment();
+        void release(); // 析构所有元素并释放所有分段
+
+        T* _segments[MaxSegments] = {}; // 段表，定长，不会重新分配
+        size_t _segmentCount = 0;
+        std::atomic<size_t> _size{0}; // 写线程用release发布，读线程用acquire读取
+        [[no_unique_address]] Alloc _alloc;
+    };
+
+    // 分段vector具体实现
+
+    template <class T, size_t First, class Alloc>
+    segmented_vector<T, First, Alloc>::segmented_vector(const segmented_vector& v)
+        : _alloc(alloc_traits::select_on_container_copy_construction(v._alloc))
+    {
+        size_t n = v.size();
+        reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            emplace_back(v[i]);
+        }
+    }
+
+    template <class T, size_t First, class Alloc>
+    segmented_vector<T, First, Alloc>::segmented_vector(segmented_vector&& v) noexcept
+        : _alloc(std::move(v._alloc))
+    {
+        swap(v);
+    }
+
+    template <class T, size_t First, class Alloc>
+    segmented_vector<T, First, Alloc>& segmented_vector<T, First, Alloc>::operator=(segmented_vector v) noexcept {
+        swap(v);
+        return *this;
+    }
+
+    template <class T, size_t First, class Alloc>
+    segmented_vector<T, First, Alloc>::~segmented_vector() {
+        release();
+    }
+
+    template <class T, size_t First, class Alloc>
+    void segmented_vector<T, First, Alloc>::reserve(size_t n) {
+        while (capacity() < n) {
+            addSegment();
+        }
+    }
+
+    // 新段的长度等于之前所有段的总长度加First，每次申请都让容量翻倍
+    template <class T, size_t First, class Alloc>
+    void segmented_vector<T, First, Alloc>::addSegment() {
+        MY_CHECK_CHEAP(_segmentCount < MaxSegments);
+        size_t n = segment_size(_segmentCount);
+        _segments[_segmentCount] = alloc_traits::allocate(_alloc, n);
+        MY_TELEMETRY_ALLOCATE(vector_kind, n * sizeof(T));
+        _segmentCount++;
+    }
+
+    template <class T, size_t First, class Alloc>
+    template <class... Args>
+    T& segmented_vector<T, First, Alloc>::emplace_back(Args&&... args) {
+        size_t n = _size.load(std::memory_order_relaxed); // 只有写线程修改长度
+        if (n == capacity()) {
+            addSegment();
+        }
+        T* p = slot(n);
+        alloc_traits::construct(_alloc, p, std::forward<Args>(args)...);
+        _size.store(n + 1, std::memory_order_release); // 元素构造完成后才对读线程可见
+        return *p;
+    }
+
+    template <class T, size_t First, class Alloc>
+    void segmented_vector<T, First, Alloc>::pop_back() {
+        size_t n = _size.load(std::memory_order_relaxed);
+        MY_CHECK_CHEAP(n > 0);
+        _size.store(n - 1, std::memory_order_release);
+        alloc_traits::destroy(_alloc, slot(n - 1));
+    }
+
+    template <class T, size_t First, class Alloc>
+    void segmented_vector<T, First, Alloc>::clear() {
+        size_t n = _size.load(std::memory_order_relaxed);
+        _size.store(0, std::memory_order_release);
+        for (size_t i = 0; i < n; i++) {
+            alloc_traits::destroy(_alloc, slot(i));
+        }
+    }
+
+    template <class T, size_t First, class Alloc>
+    void segmented_vector<T, First, Alloc>::release() {
+        clear();
+        for (size_t k = 0; k < _segmentCount; k++) {
+            alloc_traits::deallocate(_alloc, _segments[k], segment_size(k));
+            MY_TELEMETRY_DEALLOCATE(vector_kind);
+            _segments[k] = nullptr;
+        }
+        _segmentCount = 0;
+    }
+
+    // 交换段表、长度和分配器，不搬动元素
+    template <class T, size_t First, class Alloc>
+    void segmented_vector<T, First, Alloc>::swap(segmented_vector& v) noexcept {
+        for (size_t k = 0; k < MaxSegments; k++) {
+            std::swap(_segments[k], v._segments[k]);
+        }
+        std::swap(_segmentCount, v._segmentCount);
+        size_t n = _size.load(std::memory_order_relaxed);
+        _size.store(v._size.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        v._size.store(n, std::memory_order_relaxed);
+        std::swap(_alloc, v._alloc);
+    }
+
+    template <class T, size_t First, class Alloc>
+    T& segmented_vector<T, First, Alloc>::operator[](size_t i) {
+        MY_CHECK_CHEAP(i < size());
+        return *slot(i);
+    }
+
+    template <class T, size_t First, class Alloc>
+    const T& segmented_vector<T, First, Alloc>::operator[](size_t i) const {
+        MY_CHECK_CHEAP(i < size());
+        return *slot(i);
+    }
+}
@@ -0,0 +1,422 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "../hardening/hardening.h"
+#include "../vector/vector.h"
+
+// 关闭浮点乘加融合（a * b + c 合并为一条FMA指令），否则支持FMA的指令集与不支持的指令集舍入结果不同
+#if defined(__clang__)
+#pragma clang fp contract(off)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MY_SIMD_X86 1
+#define MY_SIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MY_SIMD_X86 0
+#define MY_SIMD_TARGET(isa)
+#endif
+
+namespace my {
+    /**
+     * 数值类型（float、double、int32_t、int64_t）数组的SIMD算法
+     * 1、每个算法只写一份内核：每次处理64字节（一条AVX-512寄存器）的块，块由GCC向量扩展的
+     *    寄存器宽度向量组成（基线SSE2为4个16字节、AVX2为2个32字节、AVX-512为1个64字节），
+     *    再用target属性分别编译出三个版本。
+     * 2、运行时用__builtin_cpu_supports检测CPU，选出最快的可用版本。
+     * 3、三个版本的逐通道运算和归约顺序完全相同，并且关闭了乘加融合，
+     *    因此浮点求和、点积等结果在任何指令集下都逐位一致。
+     */
+    namespace simd {
+        // 指令集
+        enum class isa {
+            baseline, // 基线指令集（x86-64上为SSE2，其余平台为标量代码）
+            avx2,
+            avx512
+        };
+
+        // 检测CPU支持的最高指令集
+        inline isa detect() {
+#if MY_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) {
+                return isa::avx512;
+            }
+            if (__builtin_cpu_supports("avx2")) {
+                return isa::avx2;
+            }
+#endif
+            return isa::baseline;
+        }
+
+        inline std::atomic<isa>& _active_isa() {
+            static std::atomic<isa> active(detect());
+            return active;
+        }
+
+        // 获取当前使用的指令集
+        inline isa active() {
+            return _active_isa().load(std::memory_order_relaxed);
+        }
+
+        // 指定使用的指令集（用于对比测试），不能超过CPU实际支持的指令集，返回最终生效的指令集
+        inline isa set_isa(isa which) {
+            if (which > detect()) {
+                which = detect();
+            }
+            _active_isa().store(which, std::memory_order_relaxed);
+            return which;
+        }
+
+        // 支持的元素类型
+        template <class T>
+        inline constexpr bool _supported = std::is_same_v<T, float> || std::is_same_v<T, double>
+            || std::is_same_v<T, int32_t> || std::is_same_v<T, int64_t>;
+
+        // 各指令集共用的内核，always_inline保证内联到带target属性的调用者中，按调用者的指令集生成代码
+        // 各指令集共用的内核，always_inline保证内联到带target属性的调用者中，按调用者的指令集生成代码
+        namespace _kernel {
+            // W字节的向量类型，向量扩展属性不能用于依赖类型，所以逐个类型、宽度特化
+            template <class T, size_t W>
+            struct _vec;
+#define MY_SIMD_VEC(T) \
+            template <> struct _vec<T, 16> { typedef T type __attribute__((vector_size(16))); }; \
+            template <> struct _vec<T, 32> { typedef T type __attribute__((vector_size(32))); }; \
+            template <> struct _vec<T, 64> { typedef T type __attribute__((vector_size(64))); }
+            MY_SIMD_VEC(float);
+            MY_SIMD_VEC(double);
+            MY_SIMD_VEC(int32_t);
+            MY_SIMD_VEC(int64_t);
+#undef MY_SIMD_VEC
+
+            template <class T, size_t W>
+            using vec = typename _vec<T, W>::type;
+
+            template <class T>
+            inline constexpr size_t lanes = 64 / sizeof(T); // 每个块的通道数
+
+            /**
+             * 64字节的块，由64 / W个W字节的向量组成，W取目标指令集的寄存器宽度（SSE2为16、AVX2为32、AVX-512为64）
+             * 块的第l个通道是第l / (W / sizeof(T))个向量的第l % (W / sizeof(T))个通道，
+             * 逐通道运算和归约顺序与W无关，所以各指令集的结果逐位一致。
+             * 不直接用64字节的向量类型：GCC在AVX2下会把拆开的64字节累加器放在栈上每轮读写，比SSE2还慢
+             */
+            template <class T, size_t W>
+            struct block {
+                static constexpr size_t parts = 64 / W; // 向量个数
+                static constexpr size_t width = W / sizeof(T); // 每个向量的通道数
+
+                // 从p读取一个块，不要求对齐
+                __attribute__((always_inline)) void load(const T* p) {
+                    for (size_t k = 0; k < parts; k++) {
+                        std::memcpy(&v[k], p + k * width, W);
+                    }
+                }
+                // 写回p，不要求对齐
+                __attribute__((always_inline)) void store(T* p) const {
+                    for (size_t k = 0; k < parts; k++) {
+                        std::memcpy(p + k * width, &v[k], W);
+                    }
+                }
+                // 每个通道都设为x
+                __attribute__((always_inline)) void broadcast(T x) {
+                    for (size_t k = 0; k < parts; k++) {
+                        v[k] = vec<T, W>{} + x; // 标量与向量运算时，标量会广播到每个通道
+                    }
+                }
+                // 第l个通道
+                __attribute__((always_inline)) T lane(size_t l) const {
+                    return v[l / width][l % width];
+                }
+
+                vec<T, W> v[parts];
+            };
+
+            // 求和
+            template <class T, size_t W>
+            __attribute__((always_inline)) inline T sum(const T* p, size_t n) {
+                block<T, W> acc = {};
+                size_t i = 0;
+                for (; i + lanes<T> <= n; i += lanes<T>) {
+                    block<T, W> b;
+                    b.load(p + i);
+                    for (size_t k = 0; k < acc.parts; k++) {
+                        acc.v[k] += b.v[k];
+                    }
+                }
+                T s = T();
+                for (size_t l = 0; l < lanes<T>; l++) { // 固定顺序的水平归约
+                    s += acc.lane(l);
+                }
+                for (; i < n; i++) {
+                    s += p[i];
+                }
+                return s;
+            }
+
+            // 最小值（less为true）或最大值，n必须大于0
+            template <class T, size_t W, bool less>
+            __attribute__((always_inline)) inline T extreme(const T* p, size_t n) {
+                size_t i = 0;
+                T best = p[0];
+                if (n >= lanes<T>) {
+                    block<T, W> acc;
+                    acc.load(p);
+                    for (i = lanes<T>; i + lanes<T> <= n; i += lanes<T>) {
+                        block<T, W> b;
+                        b.load(p + i);
+                        for (size_t k = 0; k < acc.parts; k++) {
+                            acc.v[k] = less ? (b.v[k] < acc.v[k] ? b.v[k] : acc.v[k]) : (b.v[k] > acc.v[k] ? b.v[k] : acc.v[k]);
+                        }
+                    }
+                    best = acc.lane(0);
+                    for (size_t l = 1; l < lanes<T>; l++) {
+                        T x = acc.lane(l);
+                        best = less ? (x < best ? x : best) : (x > best ? x : best);
+                    }
+                }
+                for (; i < n; i++) {
+                    best = less ? (p[i] < best ? p[i] : best) : (p[i] > best ? p[i] : best);
+                }
+                return best;
+            }
+
+            // 点积
+            template <class T, size_t W>
+            __attribute__((always_inline)) inline T dot(const T* x, const T* y, size_t n) {
+                block<T, W> acc = {};
+                size_t i = 0;
+                for (; i + lanes<T> <= n; i += lanes<T>) {
+                    block<T, W> bx, by;
+                    bx.load(x + i);
+                    by.load(y + i);
+                    for (size_t k = 0; k < acc.parts; k++) {
+                        acc.v[k] += bx.v[k] * by.v[k];
+                    }
+                }
+                T s = T();
+                for (size_t l = 0; l < lanes<T>; l++) {
+                    s += acc.lane(l);
+                }
+                for (; i < n; i++) {
+                    s += x[i] * y[i];
+                }
+                return s;
+            }
+
+            // y = a * x + y
+            template <class T, size_t W>
+            __attribute__((always_inline)) inline void axpy(T a, const T* x, T* y, size_t n) {
+                size_t i = 0;
+                block<T, W> ba;
+                ba.broadcast(a);
+                for (; i + lanes<T> <= n; i += lanes<T>) {
+                    block<T, W> bx, by;
+                    bx.load(x + i);
+                    by.load(y + i);
+                    for (size_t k = 0; k < by.parts; k++) {
+                        by.v[k] = ba.v[k] * bx.v[k] + by.v[k];
+                    }
+                    by.store(y + i);
+                }
+                for (; i < n; i++) {
+                    y[i] = a * x[i] + y[i];
+                }
+            }
+
+            // 统计等于x的元素个数，比较结果每个通道为0或-1，累加后取反即为个数
+            template <class T, size_t W>
+            __attribute__((always_inline)) inline size_t count(const T* p, size_t n, T x) {
+                typedef decltype(vec<T, W>() == vec<T, W>()) mask;
+                constexpr size_t parts = block<T, W>::parts;
+                mask acc[parts] = {};
+                block<T, W> bx;
+                bx.broadcast(x);
+                size_t i = 0;
+                for (; i + lanes<T> <= n; i += lanes<T>) {
+                    block<T, W> b;
+                    b.load(p + i);
+                    for (size_t k = 0; k < parts; k++) {
+                        acc[k] += (b.v[k] == bx.v[k]);
+                    }
+                }
+                size_t c = 0;
+                for (size_t l = 0; l < lanes<T>; l++) {
+                    c -= acc[l / block<T, W>::width][l % block<T, W>::width];
+                }
+                for (; i < n; i++) {
+                    c += p[i] == x;
+                }
+                return c;
+            }
+
+            // 查找第一个等于x的元素下标，找不到返回n
+            template <class T, size_t W>
+            __attribute__((always_inline)) inline size_t find(const T* p, size_t n, T x) {
+                block<T, W> bx;
+                bx.broadcast(x);
+                size_t i = 0;
+                for (; i + lanes<T> <= n; i += lanes<T>) {
+                    block<T, W> b;
+                    b.load(p + i);
+                    bool any = false;
+                    for (size_t k = 0; k < b.parts; k++) {
+                        auto m = b.v[k] == bx.v[k];
+                        for (size_t l = 0; l < b.width; l++) {
+                            any |= m[l] != 0;
+                        }
+                    }
+                    if (any) {
+                        break; // 命中的块交给下面的逐个比较
+                    }
+                }
+                for (; i < n; i++) {
+                    if (p[i] == x) {
+                        return i;
+                    }
+                }
+                return n;
+            }
+        }
+
+        // 寄存器宽度（字节），作为参数传给内核
+        template <size_t W>
+        using _width = std::integral_constant<size_t, W>;
+
+        // 在指定指令集下执行f，f必须是always_inline的lambda，内联后按该指令集生成代码
+        template <class F>
+        MY_SIMD_TARGET("avx2") auto _on_avx2(const F& f) {
+            return f(_width<32>());
+        }
+
+        template <class F>
+        MY_SIMD_TARGET("avx512f") auto _on_avx512(const F& f) {
+            return f(_width<64>());
+        }
+
+        // 按当前指令集分发
+        template <class F>
+        auto _dispatch(const F& f) {
+#if MY_SIMD_X86
+            switch (active()) {
+            case isa::avx512:
+                return _on_avx512(f);
+            case isa::avx2:
+                return _on_avx2(f);
+            default:
+                break;
+            }
+#endif
+            return f(_width<16>());
+        }
+
+#define MY_SIMD_KERNEL [&](auto w) __attribute__((always_inline))
+
+        // 求和
+        template <class T>
+        T sum(const T* p, size_t n) {
+            static_assert(_supported<T>, "my::simd supports float, double, int32_t and int64_t");
+            return _dispatch(MY_SIMD_KERNEL { return _kernel::sum<T, w()>(p, n); });
+        }
+
+        // 最小值，n必须大于0
+        template <class T>
+        T min(const T* p, size_t n) {
+            static_assert(_supported<T>, "my::simd supports float, double, int32_t and int64_t");
+            MY_CHECK_CHEAP(n > 0);
+            return _dispatch(MY_SIMD_KERNEL { return _kernel::extreme<T, w(), true>(p, n); });
+        }
+
+        // 最大值，n必须大于0
+        template <class T>
+        T max(const T* p, size_t n) {
+            static_assert(_supported<T>, "my::simd supports float, double, int32_t and int64_t");
+            MY_CHECK_CHEAP(n > 0);
+            return _dispatch(MY_SIMD_KERNEL { return _kernel::extreme<T, w(), false>(p, n); });
+        }
+
+        // 点积，整数类型按T的位宽累加
+        template <class T>
+        T dot(const T* x, const T* y, size_t n) {
+            static_assert(_supported<T>, "my::simd supports float, double, int32_t and int64_t");
+            return _dispatch(MY_SIMD_KERNEL { return _kernel::dot<T, w()>(x, y, n); });
+        }
+
+        // y = a * x + y
+        template <class T>
+        void axpy(T a, const T* x, T* y, size_t n) {
+            static_assert(_supported<T>, "my::simd supports float, double, int32_t and int64_t");
+            _dispatch(MY_SIMD_KERNEL { _kernel::axpy<T, w()>(a, x, y, n); });
+        }
+
+        // 统计等于x的元素个数
+        template <class T>
+        size_t count(const T* p, size_t n, T x) {
+            static_assert(_supported<T>, "my::simd supports float, double, int32_t and int64_t");
+            return _dispatch(MY_SIMD_KERNEL { return _kernel::count<T, w()>(p, n, x); });
+        }
+
+        // 查找第一个等于x的元素下标，找不到返回n
+        template <class T>
+        size_t find(const T* p, size_t n, T x) {
+            static_assert(_supported<T>, "my::simd supports float, double, int32_t and int64_t");
+            return _dispatch(MY_SIMD_KERNEL { return _kernel::find<T, w()>(p, n, x); });
+        }
+
+        // my::vector版本
+        template <class T, class Alloc>
+        T sum(const vector<T, Alloc>& v) {
+            return sum(v.data(), v.size());
+        }
+
+        template <class T, class Alloc>
+        T min(const vector<T, Alloc>& v) {
+            return min(v.data(), v.size());
+        }
+
+        template <class T, class Alloc>
+        T max(const vector<T, Alloc>& v) {
+            return max(v.data(), v.size());
+        }
+
+        template <class T, class Alloc>
+        T dot(const vector<T, Alloc>& x, const vector<T, Alloc>& y) {
+            MY_CHECK_CHEAP(x.size() == y.size());
+            return dot(x.data(), y.data(), x.size());
+        }
+
+        template <class T, class Alloc>
+        void axpy(T a, const vector<T, Alloc>& x, vector<T, Alloc>& y) {
+            MY_CHECK_CHEAP(x.size() == y.size());
+            axpy(a, x.data(), y.data(), x.size());
+        }
+
+        template <class T, class Alloc>
+        size_t count(const vector<T, Alloc>& v, T x) {
+            return count(v.data(), v.size(), x);
+        }
+
+        // 返回第一个等于x的元素的迭代器，找不到返回end()
+        template <class T, class Alloc>
+        typename vector<T, Alloc>::const_iterator find(const vector<T, Alloc>& v, T x) {
+            return v.begin() + find(v.data(), v.size(), x);
+        }
+    }
+}
+
+#undef MY_SIMD_KERNEL
+#undef MY_SIMD_TARGET
+#undef MY_SIMD_X86
+
+#if defined(__clang__)
+#pragma clang fp contract(on)
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
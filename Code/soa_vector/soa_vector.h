@@ -0,0 +1,317 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <utility>
+#include "../hardening/hardening.h"
+#include "../vector/vector.h"
+
+namespace my {
+    template <class... Fields>
+    class soa_vector;
+
+    /**
+     * soa_vector的迭代器
+     * 元素并不真实存在于某一块内存中，解引用返回由各列元素引用组成的tuple（代理引用），
+     * 因此 for (auto [id, price] : v) 中的id、price直接引用列中的数据，可读可写
+     * 与vector<bool>的迭代器一样，reference是代理类型而不是真正的引用；
+     * 提供完整的随机访问运算，std::distance、std::find_if、std::count_if等只读算法可以直接使用
+     */
+    template <class Owner, class Ref>
+    struct _soa_iterator {
+        typedef _soa_iterator<Owner, Ref> self;
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef typename std::remove_const_t<Owner>::value_type value_type;
+        typedef ptrdiff_t difference_type;
+        typedef void pointer; // 元素不在一块内存中，没有指向整条记录的指针
+        typedef Ref reference;
+
+        _soa_iterator() : _owner(nullptr), _index(0) {}
+        _soa_iterator(Owner* owner, size_t index); // 构造函数
+
+        // 运算符重载函数
+        self& operator++(); // 前置自增操作符
+        self& operator--(); // 前置自减操作符
+        self operator++(int); // 后置自增操作符
+        self operator--(int); // 后置自减操作符
+        self& operator+=(ptrdiff_t n) { _index += n; return *this; }
+        self& operator-=(ptrdiff_t n) { _index -= n; return *this; }
+        self operator+(ptrdiff_t n) const; // 向后移动n个位置
+        self operator-(ptrdiff_t n) const { return self(_owner, _index - n); }
+        friend self operator+(ptrdiff_t n, const self& it) { return it + n; }
+        ptrdiff_t operator-(const self& rhs) const; // 两个迭代器之间的距离
+        bool operator==(const self& rhs) const; // 相等比较操作符
+        bool operator!=(const self& rhs) const; // 不相等比较操作符
+        bool operator<(const self& rhs) const { return _index < rhs._index; }
+        bool operator>(const self& rhs) const { return _index > rhs._index; }
+        bool operator<=(const self& rhs) const { return _index <= rhs._index; }
+        bool operator>=(const self& rhs) const { return _index >= rhs._index; }
+        Ref operator*() const; // 解引用操作符，返回代理引用
+        Ref operator[](ptrdiff_t n) const { return (*_owner)[_index + n]; }
+
+        // 成员变量
+        Owner* _owner; // 所属的容器
+        size_t _index; // 当前下标
+    };
+
+    /**
+     * 结构体数组（SoA，Structure of Arrays）
+     * 普通的vector<Record>把每条记录的所有字段连续存放（AoS），只扫描一两个字段时，
+     * 其余字段也会被一起加载进缓存，浪费内存带宽。
+     * soa_vector<Fields...>把每个字段单独存放在一个my::vector中（按列存储），
+     * 只扫描某一列时读到的缓存行全部是有用数据，也更容易被编译器向量化。
+     */
+    template <class... Fields>
+    class soa_vector {
+    public:
+        typedef std::tuple<Fields...> value_type; // 一条记录
+        typedef std::tuple<Fields&...> reference; // 代理引用
+        typedef std::tuple<const Fields&...> const_reference; // 常量代理引用
+        typedef _soa_iterator<soa_vector<Fields...>, reference> iterator;
+        typedef _soa_iterator<const soa_vector<Fields...>, const_reference> const_iterator;
+
+        // 第I列的元素类型
+        template <size_t I>
+        using column_type = std::tuple_element_t<I, value_type>;
+
+        // 迭代器相关函数
+        iterator begin();
+        iterator end();
+        const_iterator begin()const;
+        const_iterator end()const;
+
+        // 容量和大小
+        size_t size()const; // 有效长度
+        size_t capacity()const; // 容量
+        void reserve(size_t n); // 每一列都改变容量
+        bool empty()const;
+
+        // 修改容器内容相关函数
+        void push_back(const value_type& x); // 尾插一条记录
+        void push_back(value_type&& x); // 尾插一条记录，各字段移动进对应的列
+        template <class... Args>
+            requires (sizeof...(Args) == sizeof...(Fields))
+        void emplace_back(Args&&... args); // 每列用对应的参数直接构造，参数原样转发
+        void pop_back();
+        void clear();
+
+        // 访问容器相关函数
+        reference operator[](size_t i);
+        const_reference operator[](size_t i)const;
+        template <size_t I>
+        std::span<column_type<I>> column(); // 获取第I列的连续数组
+        template <size_t I>
+        std::span<const column_type<I>> column()const;
+
+    private:
+        template <class Tuple, size_t... I>
+        void pushBack(Tuple&& args, std::index_sequence<I...>); // 第I列用args的第I项构造，失败时撤销已插入的列
+        template <class Ref, size_t... I>
+        Ref at(size_t i, std::index_sequence<I...>)const; // 取第i条记录的代理引用
+
+        std::tuple<vector<Fields>...> _columns; // 每个字段一列
+    };
+
+    // 迭代器类具体实现
+
+    // 构造函数
+    template <class Owner, class Ref>
+    _soa_iterator<Owner, Ref>::_soa_iterator(Owner* owner, size_t index)
+        : _owner(owner)
+        , _index(index)
+    {}
+
+    // 前置自增操作符
+    template <class Owner, class Ref>
+    _soa_iterator<Owner, Ref>::self& _soa_iterator<Owner, Ref>::operator++() {
+        _index++;
+        return *this;
+    }
+
+    // 前置自减操作符
+    template <class Owner, class Ref>
+    _soa_iterator<Owner, Ref>::self& _soa_iterator<Owner, Ref>::operator--() {
+        _index--;
+        return *this;
+    }
+
+    // 后置自增操作符
+    template <class Owner, class Ref>
+    _soa_iterator<Owner, Ref>::self _soa_iterator<Owner, Ref>::operator++(int) {
+        self tmp(*this);
+        _index++;
+        return tmp;
+    }
+
+    // 后置自减操作符
+    template <class Owner, class Ref>
+    _soa_iterator<Owner, Ref>::self _soa_iterator<Owner, Ref>::operator--(int) {
+        self tmp(*this);
+        _index--;
+        return tmp;
+    }
+
+    // 向后移动n个位置
+    template <class Owner, class Ref>
+    _soa_iterator<Owner, Ref>::self _soa_iterator<Owner, Ref>::operator+(ptrdiff_t n) const {
+        return self(_owner, _index + n);
+    }
+
+    // 两个迭代器之间的距离
+    template <class Owner, class Ref>
+    ptrdiff_t _soa_iterator<Owner, Ref>::operator-(const self& rhs) const {
+        return static_cast<ptrdiff_t>(_index) - static_cast<ptrdiff_t>(rhs._index);
+    }
+
+    // 相等比较操作符
+    template <class Owner, class Ref>
+    bool _soa_iterator<Owner, Ref>::operator==(const self& rhs) const {
+        return _index == rhs._index;
+    }
+
+    // 不相等比较操作符
+    template <class Owner, class Ref>
+    bool _soa_iterator<Owner, Ref>::operator!=(const self& rhs) const {
+        return _index != rhs._index;
+    }
+
+    // 解引用操作符
+    template <class Owner, class Ref>
+    Ref _soa_iterator<Owner, Ref>::operator*() const {
+        return (*_owner)[_index];
+    }
+
+    // soa_vector具体实现
+
+    // 迭代器相关函数
+    template <class... Fields>
+    soa_vector<Fields...>::iterator soa_vector<Fields...>::begin() {
+        return iterator(this, 0);
+    }
+
+    template <class... Fields>
+    soa_vector<Fields...>::iterator soa_vector<Fields...>::end() {
+        return iterator(this, size());
+    }
+
+    template <class... Fields>
+    soa_vector<Fields...>::const_iterator soa_vector<Fields...>::begin()const {
+        return const_iterator(this, 0);
+    }
+
+    template <class... Fields>
+    soa_vector<Fields...>::const_iterator soa_vector<Fields...>::end()const {
+        return const_iterator(this, size());
+    }
+
+    // 容量和大小
+
+    // 有效长度，所有列长度相同，取第一列即可
+    template <class... Fields>
+    size_t soa_vector<Fields...>::size()const {
+        return std::get<0>(_columns).size();
+    }
+
+    // 容量
+    template <class... Fields>
+    size_t soa_vector<Fields...>::capacity()const {
+        return std::get<0>(_columns).capacity();
+    }
+
+    // 每一列都改变容量
+    template <class... Fields>
+    void soa_vector<Fields...>::reserve(size_t n) {
+        std::apply([n](auto&... col) { (col.reserve(n), ...); }, _columns);
+    }
+
+    template <class... Fields>
+    bool soa_vector<Fields...>::empty()const {
+        return size() == 0;
+    }
+
+    // 修改容器内容相关函数
+
+    // 尾插一条记录
+    template <class... Fields>
+    void soa_vector<Fields...>::push_back(const value_type& x) {
+        pushBack(x, std::index_sequence_for<Fields...>());
+    }
+
+    template <class... Fields>
+    void soa_vector<Fields...>::push_back(value_type&& x) {
+        pushBack(std::move(x), std::index_sequence_for<Fields...>());
+    }
+
+    // 按字段尾插一条记录，forward_as_tuple只保存参数的引用，不产生中间的记录对象
+    template <class... Fields>
+    template <class... Args>
+        requires (sizeof...(Args) == sizeof...(Fields))
+    void soa_vector<Fields...>::emplace_back(Args&&... args) {
+        pushBack(std::forward_as_tuple(std::forward<Args>(args)...), std::index_sequence_for<Fields...>());
+    }
+
+    template <class... Fields>
+    void soa_vector<Fields...>::pop_back() {
+        MY_CHECK_CHEAP(!empty()); // 确保容器不为空
+        std::apply([](auto&... col) { (col.pop_back(), ...); }, _columns);
+    }
+
+    template <class... Fields>
+    void soa_vector<Fields...>::clear() {
+        std::apply([](auto&... col) { (col.clear(), ...); }, _columns);
+    }
+
+    // 访问容器相关函数
+    template <class... Fields>
+    soa_vector<Fields...>::reference soa_vector<Fields...>::operator[](size_t i) {
+        MY_CHECK_CHEAP(i < size()); // 确保下标合法
+        return at<reference>(i, std::index_sequence_for<Fields...>());
+    }
+
+    template <class... Fields>
+    soa_vector<Fields...>::const_reference soa_vector<Fields...>::operator[](size_t i)const {
+        MY_CHECK_CHEAP(i < size()); // 确保下标合法
+        return at<const_reference>(i, std::index_sequence_for<Fields...>());
+    }
+
+    // 获取第I列的连续数组，热循环中直接遍历它可以获得最好的访存性能
+    template <class... Fields>
+    template <size_t I>
+    std::span<typename soa_vector<Fields...>::template column_type<I>> soa_vector<Fields...>::column() {
+        auto& col = std::get<I>(_columns);
+        return col.span();
+    }
+
+    template <class... Fields>
+    template <size_t I>
+    std::span<const typename soa_vector<Fields...>::template column_type<I>> soa_vector<Fields...>::column()const {
+        const auto& col = std::get<I>(_columns);
+        return col.span();
+    }
+
+    /**
+     * 把记录的每个字段尾插到对应的列
+     * 逗号折叠表达式从左到右依次插入，done记录已经插入成功的列数；
+     * 某一列的构造或扩容抛出异常时，把前面已经插入的列各弹出一个，各列长度保持一致后重新抛出
+     */
+    template <class... Fields>
+    template <class Tuple, size_t... I>
+    void soa_vector<Fields...>::pushBack(Tuple&& args, std::index_sequence<I...>) {
+        size_t done = 0;
+        try {
+            ((std::get<I>(_columns).emplace_back(std::get<I>(std::forward<Tuple>(args))), done++), ...);
+        } catch (...) {
+            ((I < done ? std::get<I>(_columns).pop_back() : void()), ...);
+            throw;
+        }
+    }
+
+    // 取第i条记录的代理引用，const版本与非const版本共用，返回类型决定是否可写
+    template <class... Fields>
+    template <class Ref, size_t... I>
+    Ref soa_vector<Fields...>::at(size_t i, std::index_sequence<I...>)const {
+        auto& columns = const_cast<std::tuple<vector<Fields>...>&>(_columns);
+        return Ref(std::get<I>(columns).data()[i]...);
+    }
+}
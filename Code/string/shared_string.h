@@ -0,0 +1,135 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+#include "string.h"
+#include "string_view.h"
+
+namespace my {
+    /**
+     * 不可变的引用计数字符串
+     * 引用计数、长度和字符数据放在同一次申请的内存中（[计数|长度|字符...|'\0']），
+     * 拷贝只增加原子引用计数，适合把同一份数据分发给大量接收者
+     * 内容创建后不再修改，多个线程可以同时持有同一份数据；单个shared_string对象本身不是线程安全的
+     */
+    class shared_string {
+    public:
+        typedef const char* iterator;
+        typedef const char* const_iterator;
+
+        // 默认成员函数
+        shared_string() : _rep(nullptr) {}
+        shared_string(const char* str) : shared_string(str, strlen(str)) {}
+        shared_string(const char* str, size_t len);
+        shared_string(string_view s) : shared_string(s.data(), s.size()) {}
+        shared_string(const string& s) : shared_string(s.c_str(), s.size()) {}
+        shared_string(const shared_string& s); // 只增加引用计数
+        shared_string(shared_string&& s) noexcept : _rep(s._rep) { s._rep = nullptr; }
+        shared_string& operator=(const shared_string& s);
+        shared_string& operator=(shared_string&& s) noexcept;
+        ~shared_string() { release(); }
+
+        // 迭代器
+        const_iterator begin() const { return data(); }
+        const_iterator end() const { return data() + size(); }
+
+        // 容量和大小
+        size_t size() const { return _rep ? _rep->_size : 0; }
+        bool empty() const { return size() == 0; }
+        size_t use_count() const { return _rep ? _rep->_refs.load(std::memory_order_relaxed) : 0; }
+
+        // 访问字符串
+        const char& operator[](size_t i) const {
+            MY_CHECK_CHEAP(i < size());
+            return data()[i];
+        }
+        const char* data() const { return _rep ? _rep->chars() : ""; }
+        const char* c_str() const { return data(); }
+
+        // 转换
+        operator string_view() const { return string_view(data(), size()); }
+        string to_string() const; // 拷贝出一个可修改的my::string
+
+        void swap(shared_string& s) { std::swap(_rep, s._rep); }
+
+        // 比较字符串，指向同一份数据时不比较内容
+        bool operator==(const shared_string& s) const {
+            return _rep == s._rep || string_view(*this) == string_view(s);
+        }
+        bool operator!=(const shared_string& s) const { return !(*this == s); }
+        bool operator<(const shared_string& s) const { return string_view(*this) < string_view(s); }
+        bool operator>(const shared_string& s) const { return string_view(*this) > string_view(s); }
+        bool operator<=(const shared_string& s) const { return string_view(*this) <= string_view(s); }
+        bool operator>=(const shared_string& s) const { return string_view(*this) >= string_view(s); }
+
+    private:
+        // 头部，字符数据紧跟在后面
+        struct _header {
+            std::atomic<size_t> _refs;
+            size_t _size;
+
+            char* chars() { return reinterpret_cast<char*>(this + 1); }
+            const char* chars() const { return reinterpret_cast<const char*>(this + 1); }
+        };
+
+        void release();
+
+        _header* _rep; // 空串不申请内存
+    };
+
+    // 具体实现
+
+    inline shared_string::shared_string(const char* str, size_t len)
+        : _rep(nullptr)
+    {
+        if (len == 0) {
+            return;
+        }
+        void* p = ::operator new(sizeof(_header) + len + 1);
+        MY_TELEMETRY_ALLOCATE(string_kind, sizeof(_header) + len + 1);
+        _rep = ::new (p) _header{{1}, len};
+        memcpy(_rep->chars(), str, len);
+        _rep->chars()[len] = '\0';
+    }
+
+    inline shared_string::shared_string(const shared_string& s)
+        : _rep(s._rep)
+    {
+        if (_rep) {
+            _rep->_refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    inline shared_string& shared_string::operator=(const shared_string& s) {
+        shared_string tmp(s);
+        swap(tmp);
+        return *this;
+    }
+
+    inline shared_string& shared_string::operator=(shared_string&& s) noexcept {
+        if (this != &s) {
+            release();
+            _rep = s._rep;
+            s._rep = nullptr;
+        }
+        return *this;
+    }
+
+    // 最后一个持有者负责释放，acq_rel保证其他线程之前对数据的读取都已完成
+    inline void shared_string::release() {
+        if (_rep && _rep->_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            _rep->~_header();
+            ::operator delete(_rep);
+            MY_TELEMETRY_DEALLOCATE(string_kind);
+        }
+        _rep = nullptr;
+    }
+
+    inline string shared_string::to_string() const {
+        string s;
+        s.append(data(), size());
+        return s;
+    }
+}
@@ -1,279 +1,90 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include "string.h"
-#include <cassert>
+#include "utf8.h"
 
 using namespace my;
 
-// 默认成员函数
-
-// 构造函数
-string::string(const char* str = "") {
-    _size = strlen(str);
-    _capacity = _size;
-    _str = new char[_capacity + 1]; // 多的一个用于存放'\0'
-    strcpy(_str, str);
-}
-
-// 拷贝构造函数
-
-// 传统写法
-// string::string(const string& s)
-//     : _str(new char[s._capacity + 1])
-//     , _size(0)
-//     , _capacity(0)
-// {
-//     strcpy(_str, s._str);
-//     _size = s._size;
-//     _capacity = s._capacity;
-// }
-
-// 现代写法
-string::string(const string& s)
-    : _str(nullptr)
-    , _size(0)
-    , _capacity(0)
-{
-    string tmp(s._str);
-    swap(tmp);
-}
-
-// 赋值运算符重载
-
-// 传统写法
-// string& string::operator=(const string& s) {
-//     // 防止自己给自己赋值
-//     if (this != &s) {
-//         delete[] _str;
-//         _str = new char[s._capacity + 1];
-//         strcpy(_str, s._str);
-//         _size = s._size;
-//         _capacity = s._capacity;
-//     }
-//     return *this; // 返回左值（支持连续赋值）
-// }
-
-// 现代写法
-string& string::operator=(const string& s) {
-    if (this != &s) {
-        string tmp(s);
-        swap(tmp);
-    }
-    return *this;
-}
-// 析构函数
-string::~string() {
-    delete[] _str;
-    _str = nullptr;
-    _size = 0;
-    _capacity = 0;
-}
-
-
-// 迭代器
-
-// begin返回字符串中第一个字符的地址
-string::iterator string::begin() {
-    return _str;
-}
-string::const_iterator string::begin()const {
-    return _str;
-}
-
-// end返回字符串最后一个字读的后一个字符（'\0'）的地址
-string::iterator string::end() {
-    return _str + _size;
-}
-string::const_iterator string::end()const {
-    return _str + _size;
-}
-
-// 容量和大小
-
-// 获取字符串当前的有效长度（不包括’\0’）
-size_t string::size() {
-    return _size;
-}
-
-// 获取字符串当前的容量
-size_t string::capacity() {
-    return _capacity;
-}
-
-/**
- * 改变容量，大小不变
- * 1、当n大于对象当前的capacity时，将capacity扩大到n或大于n。
- * 2、当n小于对象当前的capacity时，什么也不做。
- */
-void string::reserve(size_t n) {
-    if (n > _capacity) {
-        char* tmp = new char[n + 1];
-        strncpy(tmp, _str, _size + 1); // 限制最大拷贝长度为n
-        delete[] _str;
-        _str = tmp; // 将新开辟的空间交给_str
-        _capacity = n;
-    }
-}
-
-/**
- * 改变有效长度
- * 1、当n大于当前的size时，将size扩大到n，扩大的字符为ch，若ch未给出，则默认为’\0’。
- * 2、当n小于当前的size时，将size缩小到n。
- */
-void string::resize(size_t n, char c = '\0') {
-    if (n <= _size) {
-        _size = n;
-        _str[_size] = '\0';
+// 00~99的两位数字表，每次除以100写两位，除法次数减半
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+// 十进制位数
+static size_t decimalDigits(unsigned long long v) {
+    size_t n = 1;
+    while (v >= 10000) {
+        v /= 10000;
+        n += 4;
+    }
+    return n + (v >= 10) + (v >= 100) + (v >= 1000);
+}
+
+// 先算出位数，再从低位向高位写入[first, first + 位数)
+static void writeDecimal(char* first, size_t len, unsigned long long v) {
+    char* p = first + len;
+    while (v >= 100) {
+        p -= 2;
+        memcpy(p, digitPairs + (v % 100) * 2, 2);
+        v /= 100;
+    }
+    if (v >= 10) {
+        p -= 2;
+        memcpy(p, digitPairs + v * 2, 2);
     } else {
-        if (n > _capacity) {
-            reserve(n);
-        }
-        for (size_t i = _size; i < n; i++) { //将size扩大到n，扩大的字符为c
-            _str[i] = c;
-        }
-        _size = n;
-        _str[_size] = '\0';
+        *--p = char('0' + v);
     }
 }
 
-// 判空
-bool string::empty()const {
-    return strcmp(_str, "") == 0;
-}
-
-// 添加字符串
-
-// 在当前字符串的后面尾插上一个字符
-void string::push_back(char c) {
-    if (_size == _capacity) {
-        reserve(_capacity == 0 ? 4 : _capacity * 2);
-    }
-    _str[_size] = c;
-    _str[_size + 1] = '\0';
-    _size++;
-} // insert(_size, c);
-
-// 在当前字符串的后面尾插一个字符串
-void string::append(const char* str) {
-    size_t len = _size + strlen(str);
-    if (len > _capacity) {
-        reserve(len);
+string& string::append_uint(unsigned long long v) {
+    size_t len = decimalDigits(v);
+    if (_size + len > _capacity) {
+        reserve(std::max(_size + len, _capacity * 2));
     }
-    strcpy(_str + _size, str);
-    _size = len;
-} // insert(_size, str);
-
-
-string& string::operator+=(char c) {
-    push_back(c);
-    return *this;
-}
-string& string::operator+=(const char* str) {
-    append(str);
+    writeDecimal(_str + _size, len, v);
+    _size += len;
+    _str[_size] = '\0';
     return *this;
 }
 
-// 在字符串的任意位置插入字符或是字符串
-string& string::insert(size_t pos, char c) {
-    assert(pos <= _size); // 检测下标的合法性
-    if (_size == _capacity) {
-        reserve(_capacity == 0 ? 4 : _capacity * 2);
-    }
-    char* end = _str + _size;
-    // 后移
-    while (end >= _str + pos) {
-        *(end + 1) = *(end);
-        end--;
-    }
-    _str[pos] = c;
-    _size++;
-    return *this;
-}
-string& string::insert(size_t pos, const char* str) {
-    assert(pos <= _size);
-    size_t len = strlen(str);
-    if (len + _size > _capacity) {
-        reserve(len + _size);
+string& string::append_int(long long v) {
+    unsigned long long u = v < 0 ? 0ull - (unsigned long long)v : (unsigned long long)v; // 对LLONG_MIN也成立
+    size_t len = decimalDigits(u) + (v < 0);
+    if (_size + len > _capacity) {
+        reserve(std::max(_size + len, _capacity * 2));
     }
-    char* end = _str + _size;
-    while (end >= _str + pos)
-    {
-        *(end + len) = *(end);
-        end--;
+    if (v < 0) {
+        _str[_size] = '-';
     }
-    strncpy(_str + pos, str, len); // 注意末尾不需要多加入'\0'
+    writeDecimal(_str + _size + (v < 0), len - (v < 0), u);
     _size += len;
+    _str[_size] = '\0';
     return *this;
 }
 
-// 删除字符串任意位置开始的n个字符
-string& string::erase(size_t pos, size_t len) {
-    assert(pos < _size);
-    size_t n = _size - pos;
-    if (len >= n) { // pos后面的字符都被删除
-        _size = pos;
-        _str[_size] = '\0';
-    } else {
-        strcpy(_str + pos, _str + pos + len);
-        _size -= len;
+// std::to_chars不指定格式时输出能还原v的最短表示（Ryu），最长为24个字符
+string& string::append_double(double v) {
+    const size_t maxLen = 24;
+    if (_size + maxLen > _capacity) {
+        reserve(std::max(_size + maxLen, _capacity * 2));
     }
-    return *this;
-}
-
-// 置空
-void string::clear() {
-    _size = 0;
+    std::to_chars_result r = std::to_chars(_str + _size, _str + _size + maxLen, v);
+    _size = r.ptr - _str;
     _str[_size] = '\0';
-}
-
-// 交换两个对象的数据
-void string::swap(string& s) {
-    std::swap(_str, s._str);
-    std::swap(_size, s._size);
-    std::swap(_capacity, s._capacity);
-}
-
-// 获取对象C类型的字符串，返回以 \0 结尾的C风格字符串
-const char* string::c_str()const {
-    return _str;
-}
-
-// 访问字符串
-
-// []运算符重载（可读可写），通过[] +下标的方式获取字符串对应位置的字符
-char& string::operator[](size_t i) {
-    assert(i < _size);
-    return _str[i];
-}
-
-// []运算符重载（只读）
-const char& string::operator[](size_t i)const {
-    assert(i < _size);
-    return _str[i];
-}
-
-// 正向查找第一个匹配的字符
-size_t string::find(char c, size_t pos = 0)const {
-    assert(pos < _size);
-    for (size_t i = pos; i < _size; i++) { // 从pos位置开始向后寻找目标字符
-        if (_str[i] == c) {
-            return i;
-        }
-    }
-    return npos; // 没有找到目标字符，返回npos
-}
-
-// 正向查找第一个匹配的字符串
-size_t string::find(const char* str, size_t pos = 0)const {
-    assert(pos < _size);
-    const char* ret = strstr(_str + pos, str); //调用strstr进行查找
-    if (ret) { // ret不为空指针，说明找到了
-        return ret - _str; // 返回字符串第一个字符的下标
-    } else {
-        return npos; // 没有找到目标字符串，返回npos
-    }
+    return *this;
 }
 
 // 反向查找第一个匹配的字符
-size_t string::rfind(char c, size_t pos = npos)const {
+size_t string::rfind(char c, size_t pos /* = npos */)const {
     string tmp(*this);
     std::reverse(tmp.begin(), tmp.end());
     if (pos >= _size) { // 所给pos大于字符串有效长度，重新设置pos为字符串最后一个字符的下标
@@ -289,11 +100,12 @@ size_t string::rfind(char c, size_t pos = npos)const {
 }
 
 // 反向查找第一个匹配的字符串
-size_t string::rfind(const char* str, size_t pos = 0)const {
+size_t string::rfind(const char* str, size_t pos /* = 0 */)const {
     string tmp(*this);
     std::reverse(tmp.begin(), tmp.end());
     size_t len = strlen(str);
     char* arr = new char[len + 1];
+    MY_TELEMETRY_ALLOCATE(string_kind, len + 1);
     strcpy(arr, str);
     size_t left = 0, right = len - 1;
     //逆置字符串arr
@@ -308,6 +120,7 @@ size_t string::rfind(const char* str, size_t pos = 0)const {
     pos = _size - 1 - pos;
     size_t ret = tmp.find(arr, pos);
     delete[] arr;
+    MY_TELEMETRY_DEALLOCATE(string_kind);
     if (ret != npos) {
         return _size - 1 - ret - len;
     } else {
@@ -315,54 +128,42 @@ size_t string::rfind(const char* str, size_t pos = 0)const {
     }
 }
 
-// 比较字符串
-bool string::operator>(const string& s)const {
-    return strcmp(_str, s._str) > 0;
-}
-bool string::operator==(const string & s)const {
-    return strcmp(_str, s._str) == 0;
-}
-bool string::operator>=(const string& s)const {
-    return (*this > s) || (*this == s);
-}
-bool string::operator<(const string & s)const {
-    return !(*this >= s);
-}
-bool string::operator<=(const string & s)const {
-    return !(*this > s);
-}
-bool string::operator!=(const string & s)const {
-    return !(*this == s);
+// 开启了my::utf8::validate_on_read时，读到的内容不是合法的UTF-8则设置failbit
+static std::istream& checkUtf8(std::istream& in, const string& s) {
+    if (in.iword(utf8::_stream_index()) && !utf8::validate(s.c_str(), s.size())) {
+        in.setstate(std::ios_base::failbit);
+    }
+    return in;
 }
 
 // 字符串输入
-std::istream& operator>>(std::istream& in, string& s) {
+std::istream& my::operator>>(std::istream& in, string& s) {
     s.clear();
-    char c = in.get();
-    while (c != ' ' && c != '\n')
+    int c = in.get();
+    while (c != EOF && c != ' ' && c != '\n') // 读到文件末尾也要停止
     {
-        s += c;
+        s += char(c);
         c = in.get();
     }
-    return in;
+    return checkUtf8(in, s);
 }
 
 // 字符串输出
-std::ostream& operator<<(std::ostream& out, const string& s) {
+std::ostream& my::operator<<(std::ostream& out, const string& s) {
     for (auto c : s) {
-        std::cout << c;
+        out << c;
     }
     return out;
 }
 
 // 读取一行含有空格的字符串
-std::istream& getline(std::istream& in, string& s) {
+std::istream& my::getline(std::istream& in, string& s) {
     s.clear();
-    char c = in.get();
-    while (c != '\n')
+    int c = in.get();
+    while (c != EOF && c != '\n')
     {
-        s += c;
+        s += char(c);
         c = in.get();
     }
-    return in;
+    return checkUtf8(in, s);
 }
\ No newline at end of file
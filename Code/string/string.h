@@ -1,5 +1,10 @@
 #pragma once
+#include <algorithm>
 #include <iostream>
+#include <string> // std::char_traits，编译期可用的length/copy/move/compare
+#include <utility>
+#include "../hardening/hardening.h"
+#include "../telemetry/telemetry.h"
 
 namespace my
 {
@@ -7,68 +12,406 @@ namespace my
     {
     public:
         // 默认成员函数
-        string(const char* str = ""); // 构造函数
-        string(const string& s); // 拷贝构造函数
-        string& operator=(const string& s); // 赋值运算符重载
-        ~string(); // 析构函数
+        constexpr string(const char* str = ""); // 构造函数
+        constexpr string(const string& s); // 拷贝构造函数
+        constexpr string(string&& s) noexcept; // 移动构造函数，s变为空串
+        constexpr string& operator=(const string& s); // 赋值运算符重载
+        constexpr string& operator=(string&& s) noexcept; // 移动赋值，与s交换存储
+        constexpr ~string(); // 析构函数
 
         // 迭代器
         typedef char* iterator; //字符指针
         typedef const char* const_iterator;
-        iterator begin();
-        iterator end();
-        const_iterator begin()const;
-        const_iterator end()const;
+        constexpr iterator begin();
+        constexpr iterator end();
+        constexpr const_iterator begin()const;
+        constexpr const_iterator end()const;
 
         // 容量和大小
-        size_t size(); // 有效长度
-        size_t capacity(); // 容量
-        void reserve(size_t n); // 改变容量
-        void resize(size_t n, char c = '\0'); // 改变有效长度
-        bool empty()const;
+        constexpr size_t size()const; // 有效长度
+        constexpr size_t capacity()const; // 容量
+        constexpr void reserve(size_t n); // 改变容量
+        constexpr void resize(size_t n, char c = '\0'); // 改变有效长度
+        constexpr bool empty()const;
 
         // 添加字符串
-        void push_back(char c);
-        void append(const char* str);
-        string& operator+=(char c);
-        string& operator+=(const char* str);
-        string& insert(size_t pos, char c);
-        string& insert(size_t pos, const char* str);
+        constexpr void push_back(char c);
+        constexpr void append(const char* str);
+        constexpr void append(const char* str, size_t len); // 追加str开始的len个字符，可以含有'\0'
+        string& append_int(long long v); // 追加整数的十进制表示，直接写入预留的空间，不经过临时缓冲区
+        string& append_uint(unsigned long long v);
+        string& append_double(double v); // 追加能精确还原v的最短十进制表示
+        constexpr string& operator+=(char c);
+        constexpr string& operator+=(const char* str);
+        constexpr string& insert(size_t pos, char c);
+        constexpr string& insert(size_t pos, const char* str);
 
         // 删除字符串
-        string& erase(size_t pos, size_t len);
-        void clear();
+        constexpr string& erase(size_t pos, size_t len);
+        constexpr void clear();
 
         // 交换字符串
-        void swap(string& s);
+        constexpr void swap(string& s);
+
+        static constexpr size_t npos = -1; // 整型最大值，查找失败时返回
 
         // 返回以 \0 结尾的C风格字符串
-        const char* c_str()const;
+        constexpr const char* c_str()const;
 
         // 访问字符串
-        char& operator[](size_t i);
-        const char& operator[](size_t i)const;
-        size_t find(char c, size_t pos = 0)const;
-        size_t find(const char* str, size_t pos = 0)const;
+        constexpr char& operator[](size_t i);
+        constexpr const char& operator[](size_t i)const;
+        constexpr size_t find(char c, size_t pos = 0)const;
+        constexpr size_t find(const char* str, size_t pos = 0)const;
         size_t rfind(char c, size_t pos = npos)const;
         size_t rfind(const char* str, size_t pos = 0)const;
 
         // 比较字符串
-        bool operator>(const string& s)const;
-        bool operator>=(const string& s)const;
-        bool operator<(const string & s)const;
-        bool operator<=(const string & s)const;
-        bool operator==(const string & s)const;
-        bool operator!=(const string & s)const;
+        constexpr int compare(const string& s)const; // 小于、等于、大于分别返回负数、0、正数
+        constexpr bool operator>(const string& s)const;
+        constexpr bool operator>=(const string& s)const;
+        constexpr bool operator<(const string & s)const;
+        constexpr bool operator<=(const string & s)const;
+        constexpr bool operator==(const string & s)const;
+        constexpr bool operator!=(const string & s)const;
 
     private:
-        char* _str; // 存储字符串
+        char* _str; // 存储字符串，被移动后为空指针（此时_size和_capacity都为0）
         size_t _size; // 记录字符串当前的有效长度
         size_t _capacity; // 记录字符串当前的容量
-        static const size_t npos; // 整型最大值
     };
 
-    const size_t string::npos = -1;
+    // 具体实现
+    // 除数字转换、反向查找和输入输出外都定义在头文件中，并且都是constexpr，可以在编译期构造和修改字符串（C++20）
+
+    // 默认成员函数
+
+    // 构造函数
+    constexpr string::string(const char* str /* = "" */) {
+        _size = std::char_traits<char>::length(str);
+        _capacity = _size;
+        _str = new char[_capacity + 1]; // 多的一个用于存放'\0'
+        MY_TELEMETRY_ALLOCATE(string_kind, _capacity + 1);
+        std::char_traits<char>::copy(_str, str, _size + 1);
+    }
+
+    // 拷贝构造函数
+
+    // 传统写法
+    // string::string(const string& s)
+    //     : _str(new char[s._capacity + 1])
+    //     , _size(0)
+    //     , _capacity(0)
+    // {
+    //     strcpy(_str, s._str);
+    //     _size = s._size;
+    //     _capacity = s._capacity;
+    // }
+
+    // 按长度拷贝，不能用string tmp(s._str)的现代写法：那样会在第一个'\0'处截断
+    constexpr string::string(const string& s)
+        : _str(new char[s._size + 1])
+        , _size(s._size)
+        , _capacity(s._size)
+    {
+        MY_TELEMETRY_ALLOCATE(string_kind, _capacity + 1);
+        MY_TELEMETRY_COPY(string_kind, 1);
+        std::char_traits<char>::copy(_str, s.c_str(), _size + 1);
+    }
+
+    // 移动构造函数，直接接管s的存储
+    constexpr string::string(string&& s) noexcept
+        : _str(s._str)
+        , _size(s._size)
+        , _capacity(s._capacity)
+    {
+        MY_TELEMETRY_MOVE(string_kind, 1);
+        s._str = nullptr;
+        s._size = 0;
+        s._capacity = 0;
+    }
+
+    // 赋值运算符重载
+
+    // 传统写法
+    // string& string::operator=(const string& s) {
+    //     // 防止自己给自己赋值
+    //     if (this != &s) {
+    //         delete[] _str;
+    //         _str = new char[s._capacity + 1];
+    //         strcpy(_str, s._str);
+    //         _size = s._size;
+    //         _capacity = s._capacity;
+    //     }
+    //     return *this; // 返回左值（支持连续赋值）
+    // }
+
+    // 现代写法
+    constexpr string& string::operator=(const string& s) {
+        if (this != &s) {
+            string tmp(s);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // 移动赋值，原来的存储交给s，随s一起释放
+    constexpr string& string::operator=(string&& s) noexcept {
+        MY_TELEMETRY_MOVE(string_kind, 1);
+        swap(s);
+        return *this;
+    }
+    // 析构函数
+    constexpr string::~string() {
+        if (_str) {
+            MY_TELEMETRY_DEALLOCATE(string_kind);
+        }
+        delete[] _str;
+        _str = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+
+
+    // 迭代器
+
+    // begin返回字符串中第一个字符的地址
+    constexpr string::iterator string::begin() {
+        return _str;
+    }
+    constexpr string::const_iterator string::begin()const {
+        return _str;
+    }
+
+    // end返回字符串最后一个字读的后一个字符（'\0'）的地址
+    constexpr string::iterator string::end() {
+        return _str + _size;
+    }
+    constexpr string::const_iterator string::end()const {
+        return _str + _size;
+    }
+
+    // 容量和大小
+
+    // 获取字符串当前的有效长度（不包括’\0’）
+    constexpr size_t string::size()const {
+        return _size;
+    }
+
+    // 获取字符串当前的容量
+    constexpr size_t string::capacity()const {
+        return _capacity;
+    }
+
+    /**
+     * 改变容量，大小不变
+     * 1、当n大于对象当前的capacity时，将capacity扩大到n或大于n。
+     * 2、当n小于对象当前的capacity时，什么也不做。
+     */
+    constexpr void string::reserve(size_t n) {
+        if (n > _capacity) {
+            char* tmp = new char[n + 1];
+            MY_TELEMETRY_ALLOCATE(string_kind, n + 1);
+            MY_TELEMETRY_REGROW(string_kind, _size + 1);
+            std::char_traits<char>::copy(tmp, _str, _size); // 按长度拷贝，中间含有'\0'的二进制数据也不会被截断
+            tmp[_size] = '\0'; // 被移动后的对象_str为空指针，'\0'单独写入
+            delete[] _str;
+            MY_TELEMETRY_DEALLOCATE(string_kind);
+            _str = tmp; // 将新开辟的空间交给_str
+            _capacity = n;
+        }
+    }
+
+    /**
+     * 改变有效长度
+     * 1、当n大于当前的size时，将size扩大到n，扩大的字符为ch，若ch未给出，则默认为’\0’。
+     * 2、当n小于当前的size时，将size缩小到n。
+     */
+    constexpr void string::resize(size_t n, char c /* = '\0' */) {
+        if (n < _size) {
+            _size = n;
+            _str[_size] = '\0';
+        } else if (n > _size) {
+            if (n > _capacity) {
+                reserve(n);
+            }
+            for (size_t i = _size; i < n; i++) { //将size扩大到n，扩大的字符为c
+                _str[i] = c;
+            }
+            _size = n;
+            _str[_size] = '\0';
+        }
+    }
+
+    // 判空
+    constexpr bool string::empty()const {
+        return _size == 0;
+    }
+
+    // 添加字符串
+
+    // 在当前字符串的后面尾插上一个字符
+    constexpr void string::push_back(char c) {
+        if (_size == _capacity) {
+            reserve(_capacity == 0 ? 4 : _capacity * 2);
+        }
+        _str[_size] = c;
+        _str[_size + 1] = '\0';
+        _size++;
+    } // insert(_size, c);
+
+    // 在当前字符串的后面尾插一个字符串
+    constexpr void string::append(const char* str) {
+        append(str, std::char_traits<char>::length(str));
+    } // insert(_size, str);
+
+    // 在当前字符串的后面尾插str开始的len个字符，str中可以含有'\0'
+    // 容量不足时至少扩大一倍，反复追加的均摊代价为O(1)
+    constexpr void string::append(const char* str, size_t len) {
+        if (len == 0) {
+            return;
+        }
+        if (_size + len > _capacity) {
+            reserve(std::max(_size + len, _capacity * 2));
+        }
+        std::char_traits<char>::copy(_str + _size, str, len);
+        _size += len;
+        _str[_size] = '\0';
+    }
+
+
+    constexpr string& string::operator+=(char c) {
+        push_back(c);
+        return *this;
+    }
+    constexpr string& string::operator+=(const char* str) {
+        append(str);
+        return *this;
+    }
+
+    // 在字符串的任意位置插入字符或是字符串
+    constexpr string& string::insert(size_t pos, char c) {
+        MY_CHECK_CHEAP(pos <= _size); // 检测下标的合法性
+        if (_size == _capacity) {
+            reserve(_capacity == 0 ? 4 : _capacity * 2);
+        }
+        std::char_traits<char>::move(_str + pos + 1, _str + pos, _size - pos + 1); // 连同'\0'一起后移一位
+        _str[pos] = c;
+        _size++;
+        return *this;
+    }
+    constexpr string& string::insert(size_t pos, const char* str) {
+        MY_CHECK_CHEAP(pos <= _size);
+        size_t len = std::char_traits<char>::length(str);
+        if (len == 0) {
+            return *this;
+        }
+        if (len + _size > _capacity) {
+            reserve(len + _size);
+        }
+        std::char_traits<char>::move(_str + pos + len, _str + pos, _size - pos + 1); // 连同'\0'一起后移len位
+        std::char_traits<char>::copy(_str + pos, str, len); // 注意末尾不需要多加入'\0'
+        _size += len;
+        return *this;
+    }
+
+    // 删除字符串任意位置开始的n个字符
+    constexpr string& string::erase(size_t pos, size_t len) {
+        MY_CHECK_CHEAP(pos < _size);
+        size_t n = _size - pos;
+        if (len >= n) { // pos后面的字符都被删除
+            _size = pos;
+            _str[_size] = '\0';
+        } else {
+            std::char_traits<char>::move(_str + pos, _str + pos + len, n - len + 1); // 前后两段可能重叠，连同'\0'一起前移
+            _size -= len;
+        }
+        return *this;
+    }
+
+    // 置空
+    constexpr void string::clear() {
+        if (_size != 0) {
+            _size = 0;
+            _str[_size] = '\0';
+        }
+    }
+
+    // 交换两个对象的数据
+    constexpr void string::swap(string& s) {
+        std::swap(_str, s._str);
+        std::swap(_size, s._size);
+        std::swap(_capacity, s._capacity);
+    }
+
+    // 获取对象C类型的字符串，返回以 \0 结尾的C风格字符串
+    constexpr const char* string::c_str()const {
+        return _str ? _str : "";
+    }
+
+    // 访问字符串
+
+    // []运算符重载（可读可写），通过[] +下标的方式获取字符串对应位置的字符
+    constexpr char& string::operator[](size_t i) {
+        MY_CHECK_CHEAP(i < _size);
+        return _str[i];
+    }
+
+    // []运算符重载（只读）
+    constexpr const char& string::operator[](size_t i)const {
+        MY_CHECK_CHEAP(i < _size);
+        return _str[i];
+    }
+
+    // 正向查找第一个匹配的字符，pos不小于长度时（包括空串）返回npos，与std::string一致
+    constexpr size_t string::find(char c, size_t pos /* = 0 */)const {
+        for (size_t i = pos; i < _size; i++) { // 从pos位置开始向后寻找目标字符
+            if (_str[i] == c) {
+                return i;
+            }
+        }
+        return npos; // 没有找到目标字符，返回npos
+    }
+
+    // 正向查找第一个匹配的字符串，pos超过长度时返回npos；str为空串时返回pos，与std::string一致
+    constexpr size_t string::find(const char* str, size_t pos /* = 0 */)const {
+        size_t len = std::char_traits<char>::length(str);
+        for (size_t i = pos; i <= _size && len <= _size - i; i++) { // 逐个位置比较，编译期也能执行（strstr不是constexpr）
+            if (std::char_traits<char>::compare(_str + i, str, len) == 0) {
+                return i; // 返回字符串第一个字符的下标
+            }
+        }
+        return npos; // 没有找到目标字符串，返回npos
+    }
+
+
+    // 比较字符串
+    // 按长度比较，中间含有'\0'的字符串也能正确比较
+    constexpr int string::compare(const string& s)const {
+        int ret = std::char_traits<char>::compare(_str, s._str, std::min(_size, s._size));
+        if (ret != 0) {
+            return ret;
+        }
+        return _size < s._size ? -1 : (_size > s._size ? 1 : 0);
+    }
+    constexpr bool string::operator>(const string& s)const {
+        return compare(s) > 0;
+    }
+    constexpr bool string::operator==(const string & s)const {
+        return _size == s._size && compare(s) == 0;
+    }
+    constexpr bool string::operator>=(const string& s)const {
+        return (*this > s) || (*this == s);
+    }
+    constexpr bool string::operator<(const string & s)const {
+        return !(*this >= s);
+    }
+    constexpr bool string::operator<=(const string & s)const {
+        return !(*this > s);
+    }
+    constexpr bool string::operator!=(const string & s)const {
+        return !(*this == s);
+    }
 
     // 字符串输入输出
     std::istream& operator>>(std::istream& in, string& s);
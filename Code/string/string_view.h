@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <charconv>
+#include <system_error>
+#include "string.h"
+
+namespace my {
+    /**
+     * 字符串视图，只保存指向字符数据的指针和长度，不拥有也不拷贝数据
+     * 可以由C风格字符串、my::string或指针加长度构造，
+     * 适合作为只读字符串参数，避免为了调用函数而构造临时的my::string
+     * 视图不保证以'\0'结尾，且被引用的数据必须比视图活得更久
+     */
+    class string_view {
+    public:
+        typedef const char* iterator;
+        typedef const char* const_iterator;
+        static const size_t npos = -1;
+
+        // 构造函数
+        string_view() : _str(""), _size(0) {}
+        string_view(const char* str) : _str(str), _size(strlen(str)) {}
+        string_view(const char* str, size_t len) : _str(str), _size(len) {}
+        string_view(const string& s) : _str(s.c_str()), _size(s.size()) {}
+
+        // 迭代器
+        const_iterator begin() const { return _str; }
+        const_iterator end() const { return _str + _size; }
+
+        // 容量和大小
+        size_t size() const { return _size; }
+        bool empty() const { return _size == 0; }
+
+        // 访问字符
+        const char& operator[](size_t i) const {
+            MY_CHECK_CHEAP(i < _size);
+            return _str[i];
+        }
+        const char* data() const { return _str; }
+
+        // 取从pos开始、长度最多为len的子视图
+        string_view substr(size_t pos, size_t len = npos) const {
+            MY_CHECK_CHEAP(pos <= _size);
+            if (len > _size - pos) {
+                len = _size - pos;
+            }
+            return string_view(_str + pos, len);
+        }
+
+        // 比较，先逐字节比较公共部分，再比较长度
+        int compare(string_view s) const {
+            size_t n = _size < s._size ? _size : s._size;
+            int ret = n == 0 ? 0 : memcmp(_str, s._str, n);
+            if (ret != 0) {
+                return ret;
+            }
+            return _size < s._size ? -1 : (_size > s._size ? 1 : 0);
+        }
+        bool operator==(string_view s) const { return _size == s._size && compare(s) == 0; }
+        bool operator!=(string_view s) const { return !(*this == s); }
+        bool operator<(string_view s) const { return compare(s) < 0; }
+        bool operator>(string_view s) const { return compare(s) > 0; }
+        bool operator<=(string_view s) const { return compare(s) <= 0; }
+        bool operator>=(string_view s) const { return compare(s) >= 0; }
+
+    private:
+        const char* _str; // 指向字符数据
+        size_t _size; // 字符个数
+    };
+
+    /**
+     * 把整个字符串解析为数字，成功返回true；有多余字符、为空或超出范围时返回false，out不变
+     * 不跳过空白，不接受正号，与std::from_chars一致；不依赖locale，也不要求以'\0'结尾
+     */
+    inline bool parse_int(string_view s, long long& out) {
+        long long v;
+        std::from_chars_result r = std::from_chars(s.begin(), s.end(), v);
+        if (r.ec != std::errc() || r.ptr != s.end()) {
+            return false;
+        }
+        out = v;
+        return true;
+    }
+
+    inline bool parse_uint(string_view s, unsigned long long& out) {
+        unsigned long long v;
+        std::from_chars_result r = std::from_chars(s.begin(), s.end(), v);
+        if (r.ec != std::errc() || r.ptr != s.end()) {
+            return false;
+        }
+        out = v;
+        return true;
+    }
+
+    // 接受定点和科学计数法，以及inf、nan
+    inline bool parse_double(string_view s, double& out) {
+        double v;
+        std::from_chars_result r = std::from_chars(s.begin(), s.end(), v);
+        if (r.ec != std::errc() || r.ptr != s.end()) {
+            return false;
+        }
+        out = v;
+        return true;
+    }
+}
@@ -0,0 +1,559 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <istream>
+#include <type_traits>
+#include "string.h"
+#include "string_view.h"
+#include "../vector/vector.h"
+#include "../simd/simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MY_UTF8_X86 1
+#define MY_UTF8_TARGET(isa) __attribute__((target(isa)))
+#else
+#define MY_UTF8_X86 0
+#define MY_UTF8_TARGET(isa)
+#endif
+
+namespace my {
+    /**
+     * UTF-8校验、码点计数以及与UTF-16/UTF-32之间的转换
+     * 1、校验使用查表法（Keiser & Lemire，simdutf/simdjson采用的算法）：每个字节只看它自己和前面三个字节，
+     *    用三次16项查表（pshufb）得到各类错误的位掩码并按位与，一个向量内没有任何分支；
+     *    全是ASCII的块只检查上一块末尾是否有未完成的多字节序列
+     * 2、内核用GCC向量扩展写成，分别按SSSE3（16字节）和AVX2（32字节）编译，运行时选择；
+     *    CPU不支持SSSE3时退回标量实现。AVX2是否启用跟随my::simd::active()，可以用my::simd::set_isa对比测试
+     * 3、转换时连续的ASCII块整块加宽/收窄，遇到多字节序列才逐个码点处理
+     */
+    namespace utf8 {
+        // 标量实现，也是向量实现的参照
+        namespace _scalar {
+            // 解码p[i]开始的一个码点，检查截断、过长编码、代理区和超出0x10FFFF，成功时i移到下一个码点
+            inline bool decode(const uint8_t* p, size_t n, size_t& i, char32_t& cp) {
+                uint8_t b = p[i];
+                if (b < 0x80) {
+                    cp = b;
+                    i += 1;
+                    return true;
+                }
+                size_t len;
+                char32_t min;
+                if ((b & 0xE0) == 0xC0) {
+                    len = 2;
+                    cp = b & 0x1F;
+                    min = 0x80;
+                } else if ((b & 0xF0) == 0xE0) {
+                    len = 3;
+                    cp = b & 0x0F;
+                    min = 0x800;
+                } else if ((b & 0xF8) == 0xF0) {
+                    len = 4;
+                    cp = b & 0x07;
+                    min = 0x10000;
+                } else {
+                    return false;
+                }
+                if (n - i < len) {
+                    return false;
+                }
+                for (size_t k = 1; k < len; k++) {
+                    uint8_t c = p[i + k];
+                    if ((c & 0xC0) != 0x80) {
+                        return false;
+                    }
+                    cp = (cp << 6) | (c & 0x3F);
+                }
+                if (cp < min || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                    return false;
+                }
+                i += len;
+                return true;
+            }
+
+            // 编码一个合法码点，返回写入后的位置
+            inline char* encode(char32_t cp, char* d) {
+                if (cp < 0x80) {
+                    *d++ = char(cp);
+                } else if (cp < 0x800) {
+                    *d++ = char(0xC0 | (cp >> 6));
+                    *d++ = char(0x80 | (cp & 0x3F));
+                } else if (cp < 0x10000) {
+                    *d++ = char(0xE0 | (cp >> 12));
+                    *d++ = char(0x80 | ((cp >> 6) & 0x3F));
+                    *d++ = char(0x80 | (cp & 0x3F));
+                } else {
+                    *d++ = char(0xF0 | (cp >> 18));
+                    *d++ = char(0x80 | ((cp >> 12) & 0x3F));
+                    *d++ = char(0x80 | ((cp >> 6) & 0x3F));
+                    *d++ = char(0x80 | (cp & 0x3F));
+                }
+                return d;
+            }
+
+            // 8个字节都是ASCII
+            inline bool ascii8(const uint8_t* p) {
+                uint64_t x;
+                memcpy(&x, p, 8);
+                return (x & 0x8080808080808080ull) == 0;
+            }
+
+            inline bool validate(const uint8_t* p, size_t n) {
+                size_t i = 0;
+                while (i < n) {
+                    if (i + 8 <= n && ascii8(p + i)) {
+                        i += 8;
+                        continue;
+                    }
+                    char32_t cp;
+                    if (!decode(p, n, i, cp)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            // 码点个数（非后续字节的个数）和四字节序列的个数
+            inline size_t count(const uint8_t* p, size_t n, size_t& four) {
+                size_t c = 0;
+                for (size_t i = 0; i < n; i++) {
+                    c += (p[i] & 0xC0) != 0x80;
+                    four += p[i] >= 0xF0;
+                }
+                return c;
+            }
+        }
+
+        // 各指令集共用的内核，always_inline保证内联到带target属性的调用者中
+        namespace _kernel {
+            template <size_t W>
+            struct _vec;
+            template <>
+            struct _vec<16> {
+                typedef uint8_t u8 __attribute__((vector_size(16)));
+                typedef int8_t i8 __attribute__((vector_size(16)));
+                typedef char c8 __attribute__((vector_size(16))); // x86内置函数的参数类型
+                typedef long long i64 __attribute__((vector_size(16)));
+            };
+            template <>
+            struct _vec<32> {
+                typedef uint8_t u8 __attribute__((vector_size(32)));
+                typedef int8_t i8 __attribute__((vector_size(32)));
+                typedef char c8 __attribute__((vector_size(32)));
+                typedef long long i64 __attribute__((vector_size(32)));
+            };
+
+            template <size_t W>
+            using u8 = typename _vec<W>::u8;
+
+            // 转换固定按16个字符一块
+            typedef uint8_t u8x16 __attribute__((vector_size(16)));
+            typedef uint16_t u16x16 __attribute__((vector_size(32)));
+            typedef uint32_t u32x16 __attribute__((vector_size(64)));
+
+            // 错误类型的位，一个位可以同时表示两种互不相交的情况
+            enum : uint8_t {
+                TOO_SHORT = 1 << 0, // 多字节序列的后续字节不足
+                TOO_LONG = 1 << 1, // ASCII或首字节后面出现了多余的后续字节
+                OVERLONG_3 = 1 << 2, // 三字节序列的过长编码
+                TOO_LARGE = 1 << 3, // 大于0x10FFFF
+                SURROGATE = 1 << 4, // 0xD800~0xDFFF
+                OVERLONG_2 = 1 << 5, // 两字节序列的过长编码
+                TOO_LARGE_1000 = 1 << 6,
+                OVERLONG_4 = 1 << 6,
+                TWO_CONTS = 1 << 7, // 两个连续的后续字节（是否合法要看前面第二、三个字节）
+                CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS
+            };
+
+            // 按前一个字节的高4位查表
+            inline constexpr uint8_t byte1_high[16] = {
+                TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, // 0xxx ASCII
+                TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS, // 10xx 后续字节
+                TOO_SHORT | OVERLONG_2, // 1100 两字节首字节
+                TOO_SHORT, // 1101 两字节首字节
+                TOO_SHORT | OVERLONG_3 | SURROGATE, // 1110 三字节首字节
+                TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4 // 1111 四字节首字节
+            };
+            // 按前一个字节的低4位查表
+            inline constexpr uint8_t byte1_low[16] = {
+                CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+                CARRY | OVERLONG_2,
+                CARRY,
+                CARRY,
+                CARRY | TOO_LARGE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+                CARRY | TOO_LARGE | TOO_LARGE_1000,
+                CARRY | TOO_LARGE | TOO_LARGE_1000
+            };
+            // 按当前字节的高4位查表
+            inline constexpr uint8_t byte2_high[16] = {
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4, // 1000
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE, // 1001
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, // 1010
+                TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, // 1011
+                TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+            };
+
+            // 16项的表重复填满一个向量，下标只有低4位，查表编译为pshufb
+            template <size_t W>
+            __attribute__((always_inline)) inline void table(u8<W>& v, const uint8_t* t) {
+                for (size_t i = 0; i < W; i++) {
+                    v[i] = t[i % 16];
+                }
+            }
+
+            // 内置函数按值返回32字节向量，在没有target属性的函数中会触发-Wpsabi；这些函数总是内联，不涉及调用约定
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+            /**
+             * 按idx的低4位在t中查表，t的每128位通道都是同一张16项的表
+             * x86上直接用pshufb：通用的__builtin_shuffle不知道下标小于16，32字节时会生成跨通道置换（两次pshufb加vpermq）
+             * 这里的内置函数在展开时才检查指令集，内联进带target属性的调用者后即可使用
+             */
+            template <size_t W>
+            __attribute__((always_inline)) inline void lookup(u8<W>& r, const u8<W>& t, const u8<W>& idx) {
+#if MY_UTF8_X86
+                typedef typename _vec<W>::c8 c8;
+                if constexpr (W == 16) {
+                    r = (u8<W>)__builtin_ia32_pshufb128((c8)t, (c8)idx);
+                } else {
+                    r = (u8<W>)__builtin_ia32_pshufb256((c8)t, (c8)idx);
+                }
+#else
+                r = __builtin_shuffle(t, u8<W>(idx & 0x0F));
+#endif
+            }
+
+            /**
+             * 把上一块和当前块拼起来，取当前块每个字节前面第N个字节
+             * 32字节时先用vperm2i128拼出[上一块高半, 当前块低半]，再与当前块做通道内的palignr，避免逐字节的跨通道置换
+             */
+            template <size_t W, size_t N>
+            __attribute__((always_inline)) inline void prev(u8<W>& r, const u8<W>& last, const u8<W>& in) {
+#if MY_UTF8_X86
+                typedef typename _vec<W>::i64 q64;
+                if constexpr (W == 16) {
+                    r = (u8<W>)__builtin_ia32_palignr128((q64)in, (q64)last, int(16 - N) * 8);
+                } else {
+                    q64 mid = __builtin_shuffle((q64)last, (q64)in, q64{2, 3, 4, 5});
+                    r = (u8<W>)__builtin_ia32_palignr256((q64)in, mid, int(16 - N) * 8);
+                }
+#else
+                u8<W> mask;
+                for (size_t i = 0; i < W; i++) {
+                    mask[i] = uint8_t(W - N + i);
+                }
+                r = __builtin_shuffle(last, in, mask);
+#endif
+            }
+#pragma GCC diagnostic pop
+
+            // 无符号饱和减法
+            template <size_t W>
+            __attribute__((always_inline)) inline void subs(u8<W>& r, const u8<W>& v, uint8_t c) {
+                r = (v > c) & (v - c);
+            }
+
+            // 向量是否有任何位不为0
+            template <class V>
+            __attribute__((always_inline)) inline bool any(const V& v) {
+                uint64_t x[sizeof(V) / 8];
+                memcpy(x, &v, sizeof(V));
+                uint64_t o = 0;
+                for (size_t i = 0; i < sizeof(V) / 8; i++) {
+                    o |= x[i];
+                }
+                return o != 0;
+            }
+
+            /**
+             * 一块数据的错误位 = 三次查表结果按位与，再与“必须是三、四字节序列的后续字节”的位置比较
+             * 最后不足一块的部分补0（ASCII）后再检查一次，末尾未完成的序列会表现为TOO_SHORT
+             */
+            template <size_t W>
+            __attribute__((always_inline)) inline bool validate(const uint8_t* p, size_t n) {
+                u8<W> t1, t2, t3;
+                table<W>(t1, byte1_high);
+                table<W>(t2, byte1_low);
+                table<W>(t3, byte2_high);
+                u8<W> maxv; // 最后三个字节分别不能是四、三、两字节序列的首字节
+                for (size_t i = 0; i < W; i++) {
+                    maxv[i] = i == W - 3 ? 0xEF : i == W - 2 ? 0xDF : i == W - 1 ? 0xBF : 0xFF;
+                }
+                u8<W> error = {}, last = {}, incomplete = {};
+                uint8_t tail[W];
+                size_t i = 0;
+                while (true) {
+                    u8<W> in;
+                    bool end = i + W > n;
+                    if (!end) {
+                        memcpy(&in, p + i, W);
+                    } else {
+                        memset(tail, 0, W);
+                        memcpy(tail, p + i, n - i);
+                        memcpy(&in, tail, W);
+                    }
+                    if (!any(in & 0x80)) {
+                        error |= incomplete; // 全是ASCII，只需检查上一块末尾
+                    } else {
+                        u8<W> p1, p2, p3;
+                        prev<W, 1>(p1, last, in);
+                        prev<W, 2>(p2, last, in);
+                        prev<W, 3>(p3, last, in);
+                        u8<W> l1, l2, l3;
+                        lookup<W>(l1, t1, p1 >> 4);
+                        lookup<W>(l2, t2, p1 & 0x0F);
+                        lookup<W>(l3, t3, in >> 4);
+                        u8<W> sc = l1 & l2 & l3;
+                        u8<W> third, fourth;
+                        subs<W>(third, p2, 0xE0 - 0x80); // 只有111xxxxx减完后不小于0x80
+                        subs<W>(fourth, p3, 0xF0 - 0x80); // 只有1111xxxx减完后不小于0x80
+                        error |= ((third | fourth) & 0x80) ^ sc;
+                    }
+                    incomplete = (in > maxv) & (in - maxv);
+                    last = in;
+                    if (end) {
+                        break;
+                    }
+                    i += W;
+                }
+                return !any(error);
+            }
+
+            // 码点个数和四字节首字节个数，每个通道的计数器是8位的，每127块归并一次
+            template <size_t W>
+            __attribute__((always_inline)) inline size_t count(const uint8_t* p, size_t n, size_t& four) {
+                typedef typename _vec<W>::i8 i8;
+                size_t c = 0, i = 0;
+                while (i + W <= n) {
+                    i8 acc = {}, acc4 = {};
+                    for (size_t k = 0; k < 127 && i + W <= n; k++, i += W) {
+                        i8 v;
+                        memcpy(&v, p + i, W);
+                        acc += (v > int8_t(-65)); // 不是后续字节（0x80~0xBF）时该通道为-1
+                        acc4 += (v >= int8_t(-16)) & (v < 0); // 0xF0~0xFF
+                    }
+                    for (size_t l = 0; l < W; l++) {
+                        c -= acc[l];
+                        four -= acc4[l];
+                    }
+                }
+                return c + _scalar::count(p + i, n - i, four);
+            }
+
+            // UTF-8转为UTF-16或UTF-32，ASCII块整块加宽，返回写入的个数，不合法时返回0
+            template <class Char>
+            __attribute__((always_inline)) inline size_t widen(const uint8_t* p, size_t n, Char* d) {
+                typedef std::conditional_t<sizeof(Char) == 2, u16x16, u32x16> wide;
+                Char* start = d;
+                size_t i = 0;
+                while (i < n) {
+                    if (i + 16 <= n) {
+                        u8x16 in;
+                        memcpy(&in, p + i, 16);
+                        if (!any(in & 0x80)) {
+                            wide w = __builtin_convertvector(in, wide);
+                            memcpy(d, &w, sizeof(w));
+                            d += 16;
+                            i += 16;
+                            continue;
+                        }
+                    }
+                    char32_t cp;
+                    if (!_scalar::decode(p, n, i, cp)) {
+                        return 0;
+                    }
+                    if (sizeof(Char) == 2 && cp >= 0x10000) {
+                        cp -= 0x10000;
+                        *d++ = Char(0xD800 + (cp >> 10));
+                        *d++ = Char(0xDC00 + (cp & 0x3FF));
+                    } else {
+                        *d++ = Char(cp);
+                    }
+                }
+                return d - start;
+            }
+
+            // UTF-16或UTF-32转为UTF-8，16个都是ASCII时整块收窄，返回写入的字节数，不合法时返回0
+            template <class Char>
+            __attribute__((always_inline)) inline size_t narrow(const Char* p, size_t n, char* d) {
+                typedef std::conditional_t<sizeof(Char) == 2, u16x16, u32x16> wide;
+                char* start = d;
+                size_t i = 0;
+                while (i < n) {
+                    if (i + 16 <= n) {
+                        wide in;
+                        memcpy(&in, p + i, sizeof(in));
+                        if (!any(in & ~0x7F)) {
+                            u8x16 out = __builtin_convertvector(in, u8x16);
+                            memcpy(d, &out, 16);
+                            d += 16;
+                            i += 16;
+                            continue;
+                        }
+                    }
+                    char32_t cp = p[i++];
+                    if (sizeof(Char) == 2 && cp >= 0xD800 && cp <= 0xDFFF) {
+                        if (cp >= 0xDC00 || i == n || p[i] < 0xDC00 || p[i] > 0xDFFF) {
+                            return 0; // 单独的代理项
+                        }
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (p[i++] - 0xDC00);
+                    } else if (cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                        return 0;
+                    }
+                    d = _scalar::encode(cp, d);
+                }
+                return d - start;
+            }
+        }
+
+        // 在指定指令集下执行f，f必须是always_inline的lambda，参数为向量宽度
+        template <class F>
+        MY_UTF8_TARGET("ssse3") auto _on_ssse3(const F& f) {
+            return f(std::integral_constant<size_t, 16>());
+        }
+
+        template <class F>
+        MY_UTF8_TARGET("avx2") auto _on_avx2(const F& f) {
+            return f(std::integral_constant<size_t, 32>());
+        }
+
+        inline bool _has_ssse3() {
+#if MY_UTF8_X86
+            static const bool has = (__builtin_cpu_init(), __builtin_cpu_supports("ssse3"));
+            return has;
+#else
+            return false;
+#endif
+        }
+
+        // 按指令集分发，不支持SSSE3时执行标量版本fallback
+        template <class F, class G>
+        auto _dispatch(const F& f, const G& fallback) {
+#if MY_UTF8_X86
+            if (simd::active() >= simd::isa::avx2) {
+                return _on_avx2(f);
+            }
+            if (_has_ssse3()) {
+                return _on_ssse3(f);
+            }
+#endif
+            return fallback();
+        }
+
+#define MY_UTF8_KERNEL [&](auto w) __attribute__((always_inline))
+#define MY_UTF8_SCALAR [&]()
+
+        // 是否为合法的UTF-8
+        inline bool validate(const char* str, size_t len) {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(str);
+            return _dispatch(MY_UTF8_KERNEL { return _kernel::validate<decltype(w)::value>(p, len); },
+                MY_UTF8_SCALAR { return _scalar::validate(p, len); });
+        }
+        inline bool validate(string_view s) {
+            return validate(s.data(), s.size());
+        }
+
+        // 码点个数，要求输入是合法的UTF-8
+        inline size_t count(const char* str, size_t len) {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(str);
+            size_t four = 0;
+            return _dispatch(MY_UTF8_KERNEL { return _kernel::count<decltype(w)::value>(p, len, four); },
+                MY_UTF8_SCALAR { return _scalar::count(p, len, four); });
+        }
+        inline size_t count(string_view s) {
+            return count(s.data(), s.size());
+        }
+
+        // 转为UTF-16需要的单元个数（四字节序列需要两个单元），要求输入是合法的UTF-8
+        inline size_t utf16_length(string_view s) {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(s.data());
+            size_t four = 0;
+            size_t c = _dispatch(MY_UTF8_KERNEL { return _kernel::count<decltype(w)::value>(p, s.size(), four); },
+                MY_UTF8_SCALAR { return _scalar::count(p, s.size(), four); });
+            return c + four;
+        }
+
+        /**
+         * 以下转换函数返回写入的个数，输入不合法时返回0
+         * 目标空间的大小：to_utf16、to_utf32至少为len，from_utf16至少为3 * len，from_utf32至少为4 * len
+         */
+        inline size_t to_utf16(const char* str, size_t len, char16_t* dest) {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(str);
+            return _dispatch(MY_UTF8_KERNEL { (void)w; return _kernel::widen(p, len, dest); },
+                MY_UTF8_SCALAR { return _kernel::widen(p, len, dest); });
+        }
+        inline size_t to_utf32(const char* str, size_t len, char32_t* dest) {
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(str);
+            return _dispatch(MY_UTF8_KERNEL { (void)w; return _kernel::widen(p, len, dest); },
+                MY_UTF8_SCALAR { return _kernel::widen(p, len, dest); });
+        }
+        inline size_t from_utf16(const char16_t* str, size_t len, char* dest) {
+            return _dispatch(MY_UTF8_KERNEL { (void)w; return _kernel::narrow(str, len, dest); },
+                MY_UTF8_SCALAR { return _kernel::narrow(str, len, dest); });
+        }
+        inline size_t from_utf32(const char32_t* str, size_t len, char* dest) {
+            return _dispatch(MY_UTF8_KERNEL { (void)w; return _kernel::narrow(str, len, dest); },
+                MY_UTF8_SCALAR { return _kernel::narrow(str, len, dest); });
+        }
+
+#undef MY_UTF8_KERNEL
+#undef MY_UTF8_SCALAR
+
+        // my::string、my::vector版本，输入不合法时返回false，out的内容不确定
+        inline bool to_utf16(string_view s, vector<char16_t>& out) {
+            out.resize(s.size());
+            size_t n = to_utf16(s.data(), s.size(), out.data());
+            out.resize(n);
+            return n != 0 || s.empty();
+        }
+        inline bool to_utf32(string_view s, vector<char32_t>& out) {
+            out.resize(s.size());
+            size_t n = to_utf32(s.data(), s.size(), out.data());
+            out.resize(n);
+            return n != 0 || s.empty();
+        }
+        inline bool from_utf16(const char16_t* str, size_t len, string& out) {
+            out.resize(3 * len);
+            size_t n = from_utf16(str, len, out.begin());
+            out.resize(n);
+            return n != 0 || len == 0;
+        }
+        inline bool from_utf32(const char32_t* str, size_t len, string& out) {
+            out.resize(4 * len);
+            size_t n = from_utf32(str, len, out.begin());
+            out.resize(n);
+            return n != 0 || len == 0;
+        }
+
+        // 流的iword下标，非0表示读入my::string时校验UTF-8
+        inline int _stream_index() {
+            static const int index = std::ios_base::xalloc();
+            return index;
+        }
+
+        // 流操纵符：in >> my::utf8::validate_on_read之后，operator>>和getline读到不合法的UTF-8时设置failbit
+        inline std::istream& validate_on_read(std::istream& in) {
+            in.iword(_stream_index()) = 1;
+            return in;
+        }
+        inline std::istream& no_validate_on_read(std::istream& in) {
+            in.iword(_stream_index()) = 0;
+            return in;
+        }
+    }
+}
+
+#undef MY_UTF8_TARGET
+#undef MY_UTF8_X86
@@ -0,0 +1,244 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <type_traits>
+
+/**
+ * 容器的内存分配统计，编译时通过 -DMY_TELEMETRY=1 开启，默认关闭
+ * 关闭时所有统计宏展开为空语句，没有任何开销
+ * 开启后vector、string、list在申请/释放内存、扩容、拷贝或移动构造元素时记录计数，
+ * 用来找出哪些地方应该提前reserve、哪些地方本该移动却发生了拷贝
+ * 每个线程的计数保存在thread_local中，只有本线程写入，不需要加锁；
+ * snapshot()汇总所有存活线程和已退出线程的计数
+ */
+#ifndef MY_TELEMETRY
+#define MY_TELEMETRY 0
+#endif
+
+namespace my {
+    namespace telemetry {
+        // 被统计的容器种类
+        enum container {
+            vector_kind,
+            string_kind,
+            list_kind,
+            container_count
+        };
+
+        inline const char* container_name(container c) {
+            static const char* names[container_count] = { "vector", "string", "list" };
+            return names[c];
+        }
+
+        // 一种容器的计数
+        struct counters {
+            uint64_t allocations = 0; // 申请内存的次数
+            uint64_t deallocations = 0; // 释放内存的次数
+            uint64_t bytes_allocated = 0; // 申请的总字节数
+            uint64_t regrowths = 0; // 扩容（申请新空间并搬运原有元素）的次数
+            uint64_t bytes_moved = 0; // 扩容时搬运的字节数
+            uint64_t copy_constructions = 0; // 拷贝构造的元素个数（string为整个字符串的拷贝次数）
+            uint64_t move_constructions = 0; // 移动构造的元素个数
+            uint64_t peak_capacity = 0; // 单次申请的最大字节数
+
+            counters& operator+=(const counters& c) {
+                allocations += c.allocations;
+                deallocations += c.deallocations;
+                bytes_allocated += c.bytes_allocated;
+                regrowths += c.regrowths;
+                bytes_moved += c.bytes_moved;
+                copy_constructions += c.copy_constructions;
+                move_constructions += c.move_constructions;
+                peak_capacity = peak_capacity > c.peak_capacity ? peak_capacity : c.peak_capacity;
+                return *this;
+            }
+        };
+
+        // 所有种类容器的计数
+        struct snapshot_t {
+            counters kinds[container_count];
+
+            const counters& operator[](container c) const { return kinds[c]; }
+        };
+
+        // 一个线程的计数，只有所属线程写入，其他线程在snapshot时读取，因此用relaxed原子变量
+        struct _thread_counters {
+            struct slot {
+                std::atomic<uint64_t> allocations{0};
+                std::atomic<uint64_t> deallocations{0};
+                std::atomic<uint64_t> bytes_allocated{0};
+                std::atomic<uint64_t> regrowths{0};
+                std::atomic<uint64_t> bytes_moved{0};
+                std::atomic<uint64_t> copy_constructions{0};
+                std::atomic<uint64_t> move_constructions{0};
+                std::atomic<uint64_t> peak_capacity{0};
+            };
+
+            _thread_counters(); // 注册到全局链表
+            ~_thread_counters(); // 线程退出时把计数并入全局，再从链表中摘掉
+
+            counters load(container c) const;
+            void reset();
+
+            slot _slots[container_count];
+            _thread_counters* _prev = nullptr;
+            _thread_counters* _next = nullptr;
+        };
+
+        // 全局汇总：存活线程的链表和已退出线程的计数
+        struct _registry {
+            std::mutex _mutex;
+            _thread_counters* _head = nullptr;
+            counters _retired[container_count];
+        };
+
+        inline _registry& _global() {
+            static _registry r;
+            return r;
+        }
+
+        inline _thread_counters& _local() {
+            thread_local _thread_counters c;
+            return c;
+        }
+
+        inline _thread_counters::_thread_counters() {
+            _registry& r = _global();
+            std::lock_guard<std::mutex> lock(r._mutex);
+            _next = r._head;
+            if (r._head) {
+                r._head->_prev = this;
+            }
+            r._head = this;
+        }
+
+        inline _thread_counters::~_thread_counters() {
+            _registry& r = _global();
+            std::lock_guard<std::mutex> lock(r._mutex);
+            for (int c = 0; c < container_count; ++c) {
+                r._retired[c] += load(container(c));
+            }
+            if (_prev) {
+                _prev->_next = _next;
+            } else {
+                r._head = _next;
+            }
+            if (_next) {
+                _next->_prev = _prev;
+            }
+        }
+
+        inline counters _thread_counters::load(container c) const {
+            const slot& s = _slots[c];
+            counters r;
+            r.allocations = s.allocations.load(std::memory_order_relaxed);
+            r.deallocations = s.deallocations.load(std::memory_order_relaxed);
+            r.bytes_allocated = s.bytes_allocated.load(std::memory_order_relaxed);
+            r.regrowths = s.regrowths.load(std::memory_order_relaxed);
+            r.bytes_moved = s.bytes_moved.load(std::memory_order_relaxed);
+            r.copy_constructions = s.copy_constructions.load(std::memory_order_relaxed);
+            r.move_constructions = s.move_constructions.load(std::memory_order_relaxed);
+            r.peak_capacity = s.peak_capacity.load(std::memory_order_relaxed);
+            return r;
+        }
+
+        inline void _thread_counters::reset() {
+            for (slot& s : _slots) {
+                s.allocations.store(0, std::memory_order_relaxed);
+                s.deallocations.store(0, std::memory_order_relaxed);
+                s.bytes_allocated.store(0, std::memory_order_relaxed);
+                s.regrowths.store(0, std::memory_order_relaxed);
+                s.bytes_moved.store(0, std::memory_order_relaxed);
+                s.copy_constructions.store(0, std::memory_order_relaxed);
+                s.move_constructions.store(0, std::memory_order_relaxed);
+                s.peak_capacity.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        // 只有本线程写入，读-改-写不需要原子的fetch_add，普通的load加store即可
+        inline void _add(std::atomic<uint64_t>& a, uint64_t n) {
+            a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        inline void _on_allocate(container c, size_t bytes) {
+            _thread_counters::slot& s = _local()._slots[c];
+            _add(s.allocations, 1);
+            _add(s.bytes_allocated, bytes);
+            if (bytes > s.peak_capacity.load(std::memory_order_relaxed)) {
+                s.peak_capacity.store(bytes, std::memory_order_relaxed);
+            }
+        }
+        inline void _on_deallocate(container c) {
+            _add(_local()._slots[c].deallocations, 1);
+        }
+        inline void _on_regrow(container c, size_t bytes_moved) {
+            _thread_counters::slot& s = _local()._slots[c];
+            _add(s.regrowths, 1);
+            _add(s.bytes_moved, bytes_moved);
+        }
+        inline void _on_copy(container c, size_t n) {
+            _add(_local()._slots[c].copy_constructions, n);
+        }
+        inline void _on_move(container c, size_t n) {
+            _add(_local()._slots[c].move_constructions, n);
+        }
+
+        // 汇总所有线程（包括已经退出的线程）的计数
+        inline snapshot_t snapshot() {
+            snapshot_t s;
+            _registry& r = _global();
+            std::lock_guard<std::mutex> lock(r._mutex);
+            for (int c = 0; c < container_count; ++c) {
+                s.kinds[c] = r._retired[c];
+                for (_thread_counters* t = r._head; t; t = t->_next) {
+                    s.kinds[c] += t->load(container(c));
+                }
+            }
+            return s;
+        }
+
+        // 清零所有计数，其他线程正在写入时清零可能被覆盖，应在各线程空闲时调用
+        inline void reset() {
+            _registry& r = _global();
+            std::lock_guard<std::mutex> lock(r._mutex);
+            for (int c = 0; c < container_count; ++c) {
+                r._retired[c] = counters();
+            }
+            for (_thread_counters* t = r._head; t; t = t->_next) {
+                t->reset();
+            }
+        }
+
+        // 以表格形式输出
+        inline void dump(std::ostream& out, const snapshot_t& s) {
+            out << "container allocations deallocations bytes_allocated regrowths bytes_moved copies moves peak_capacity\n";
+            for (int c = 0; c < container_count; ++c) {
+                const counters& k = s.kinds[c];
+                out << container_name(container(c)) << ' ' << k.allocations << ' ' << k.deallocations << ' '
+                    << k.bytes_allocated << ' ' << k.regrowths << ' ' << k.bytes_moved << ' '
+                    << k.copy_constructions << ' ' << k.move_constructions << ' ' << k.peak_capacity << '\n';
+            }
+        }
+        inline void dump(std::ostream& out) {
+            dump(out, snapshot());
+        }
+    }
+}
+
+// 容器中使用的统计宏，关闭时不求值任何参数；常量求值（constexpr）时不统计
+#if MY_TELEMETRY
+#define MY_TELEMETRY_ALLOCATE(kind, bytes) (std::is_constant_evaluated() ? (void)0 : ::my::telemetry::_on_allocate(::my::telemetry::kind, (bytes)))
+#define MY_TELEMETRY_DEALLOCATE(kind) (std::is_constant_evaluated() ? (void)0 : ::my::telemetry::_on_deallocate(::my::telemetry::kind))
+#define MY_TELEMETRY_REGROW(kind, bytes_moved) (std::is_constant_evaluated() ? (void)0 : ::my::telemetry::_on_regrow(::my::telemetry::kind, (bytes_moved)))
+#define MY_TELEMETRY_COPY(kind, n) (std::is_constant_evaluated() ? (void)0 : ::my::telemetry::_on_copy(::my::telemetry::kind, (n)))
+#define MY_TELEMETRY_MOVE(kind, n) (std::is_constant_evaluated() ? (void)0 : ::my::telemetry::_on_move(::my::telemetry::kind, (n)))
+#else
+#define MY_TELEMETRY_ALLOCATE(kind, bytes) ((void)0)
+#define MY_TELEMETRY_DEALLOCATE(kind) ((void)0)
+#define MY_TELEMETRY_REGROW(kind, bytes_moved) ((void)0)
+#define MY_TELEMETRY_COPY(kind, n) ((void)0)
+#define MY_TELEMETRY_MOVE(kind, n) ((void)0)
+#endif
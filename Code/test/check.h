@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdio>
+
+/**
+ * 测试用的检查宏
+ * 失败时打印位置和表达式并计数，不中断后续检查；main最后返回MY_TEST_RESULT()，有失败时CTest判定为不通过
+ */
+namespace my::test {
+    inline int& failures() {
+        static int n = 0;
+        return n;
+    }
+}
+
+#define MY_EXPECT(cond)                                                              \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ::my::test::failures()++;                                                \
+        }                                                                            \
+    } while (0)
+
+#define MY_TEST_RESULT() (::my::test::failures() == 0 ? 0 : 1)
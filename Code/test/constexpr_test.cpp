@@ -0,0 +1,84 @@
+#include <array>
+#include "check.h"
+#include "string/string.h"
+#include "vector/vector.h"
+
+/**
+ * vector和string在常量求值中的用法，全部是static_assert，能编译通过就说明这些操作可以在编译期执行
+ * 编译期申请的内存必须在编译期释放，所以每个检查都在一个constexpr lambda里构造、使用、析构
+ */
+namespace {
+    // vector：push_back、reserve、下标、拷贝、插入删除
+    static_assert([] {
+        my::vector<int> v;
+        v.reserve(4);
+        for (int i = 0; i < 16; i++) {
+            v.push_back(i * i);
+        }
+        return v.size() == 16 && v[15] == 225 && v.capacity() >= 16;
+    }());
+    static_assert([] {
+        my::vector<int> v;
+        for (int i = 0; i < 5; i++) {
+            v.push_back(i);
+        }
+        my::vector<int> w = v;
+        w.insert(w.begin(), 42);
+        w.erase(w.begin() + 1);
+        return w.size() == 5 && w[0] == 42 && w[4] == 4 && v[0] == 0;
+    }());
+
+    // 编译期算好的表拷贝到定长数组中带到运行时
+    constexpr auto squares = [] {
+        my::vector<int> v;
+        for (int i = 0; i < 8; i++) {
+            v.push_back(i * i);
+        }
+        std::array<int, 8> out{};
+        for (size_t i = 0; i < v.size(); i++) {
+            out[i] = v[i];
+        }
+        return out;
+    }();
+    static_assert(squares[7] == 49);
+
+    // string：构造、追加、插入、删除、查找、比较
+    static_assert([] {
+        my::string s("hello");
+        s += ' ';
+        s += "world";
+        return s.size() == 11 && s.find("world") == 6 && s.find('o') == 4 && s.find('z') == my::string::npos;
+    }());
+    static_assert([] {
+        my::string s("abc");
+        s.insert(0, "xy");
+        s.erase(1, 2);
+        return s == my::string("xbc") && s < my::string("xc") && s.compare(my::string("xbc")) == 0;
+    }());
+
+    // 空串和越界的pos上查找返回npos，空的子串在pos处匹配
+    static_assert(my::string("").find('a') == my::string::npos);
+    static_assert(my::string("").find("a") == my::string::npos);
+    static_assert(my::string("").find("") == 0);
+    static_assert(my::string("abc").find('a', 3) == my::string::npos);
+    static_assert(my::string("abc").find("", 3) == 3);
+    static_assert(my::string("abc").find("c", 7) == my::string::npos);
+
+    // 中间含有'\0'时拷贝和移动都不截断
+    static_assert([] {
+        my::string s;
+        s.append("a\0b", 3);
+        my::string copy = s;
+        my::string moved = static_cast<my::string&&>(copy);
+        return copy.size() == 0 && moved.size() == 3 && moved[2] == 'b' && moved == s;
+    }());
+    static_assert([] {
+        my::string a("first"), b("second");
+        a = static_cast<my::string&&>(b);
+        return a == my::string("second") && b == my::string("first");
+    }());
+}
+
+int main() {
+    return MY_TEST_RESULT();
+}
@@ -0,0 +1,42 @@
+#include <string>
+#include "check.h"
+#include "flat_hash_map/flat_hash_map.h"
+
+namespace {
+    // 带种子的哈希函数和判等函数，用来确认拷贝、移动时状态被一起带走
+    struct seeded_hash {
+        uint64_t seed = 0;
+        size_t operator()(int x) const { return std::hash<uint64_t>()(uint64_t(x) ^ seed); }
+    };
+    struct tagged_eq {
+        int tag = 0;
+        bool operator()(int a, int b) const { return a == b; }
+    };
+
+    void copyKeepsHasher() {
+        my::flat_hash_map<int, std::string, seeded_hash, tagged_eq> m(16, seeded_hash{42}, tagged_eq{7});
+        for (int i = 0; i < 1000; i++) {
+            m[i] = std::to_string(i);
+        }
+        auto copy = m;
+        MY_EXPECT(copy.hash_function().seed == 42);
+        MY_EXPECT(copy.key_eq().tag == 7);
+        MY_EXPECT(copy.size() == 1000 && copy.at(500) == "500");
+        auto moved = std::move(copy);
+        MY_EXPECT(moved.hash_function().seed == 42);
+        MY_EXPECT(moved.key_eq().tag == 7);
+        MY_EXPECT(moved.find(999) != moved.end());
+        copy[1] = "again"; // 被移动的表可以继续使用
+        MY_EXPECT(copy.size() == 1 && copy.hash_function().seed == 42);
+
+        my::flat_hash_set<int, seeded_hash, tagged_eq> s(0, seeded_hash{9});
+        s.insert(3);
+        auto s2 = s;
+        MY_EXPECT(s2.hash_function().seed == 9 && s2.count(3) == 1);
+    }
+}
+
+int main() {
+    copyKeepsHasher();
+    return MY_TEST_RESULT();
+}
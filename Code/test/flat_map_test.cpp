@@ -0,0 +1,55 @@
+#include <utility>
+#include "check.h"
+#include "flat_map/flat_map.h"
+#include "vector/vector.h"
+
+namespace {
+    // 统计拷贝次数，移动构造不抛异常
+    struct counted {
+        static inline int copies = 0;
+        int value = 0;
+        counted() = default;
+        counted(int v) : value(v) {}
+        counted(const counted& o) : value(o.value) { copies++; }
+        counted(counted&& o) noexcept : value(o.value) {}
+        counted& operator=(const counted& o) { value = o.value; copies++; return *this; }
+        counted& operator=(counted&& o) noexcept { value = o.value; return *this; }
+        bool operator<(const counted& o) const { return value < o.value; }
+    };
+
+    // 批量插入归并时移动原有元素，只有输入区间被拷贝进批次时产生拷贝
+    void insertRangeMoves() {
+        my::flat_map<int, counted> m;
+        my::vector<std::pair<int, counted>> init;
+        for (int i = 0; i < 1000; i += 2) {
+            init.push_back({i, counted(i)});
+        }
+        m.insert_range(init.begin(), init.end());
+        my::vector<std::pair<int, counted>> more;
+        for (int i = 1; i < 200; i += 2) {
+            more.push_back({i, counted(i)});
+        }
+        counted::copies = 0;
+        m.insert_range(more.begin(), more.end());
+        MY_EXPECT(counted::copies <= int(more.size()));
+        MY_EXPECT(m.size() == 600);
+        MY_EXPECT(m.at(199).value == 199 && m.at(998).value == 998);
+
+        my::flat_set<counted> s;
+        my::vector<counted> keys;
+        for (int i = 0; i < 1000; i++) {
+            keys.push_back(counted(i * 3));
+        }
+        s.insert_range(keys.begin(), keys.end());
+        counted::copies = 0;
+        s.insert_range(keys.begin(), keys.begin() + 10); // 全部已存在
+        s.insert_range(keys.begin(), keys.begin() + 1);
+        MY_EXPECT(counted::copies <= 11);
+        MY_EXPECT(s.size() == 1000);
+    }
+}
+
+int main() {
+    insertRangeMoves();
+    return MY_TEST_RESULT();
+}
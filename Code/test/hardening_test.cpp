@@ -0,0 +1,91 @@
+// 本测试固定使用full等级，与其它目标的等级无关；vector按等级放在不同的内联命名空间中，可以与其它等级的目标文件链接
+#undef MY_HARDENING_LEVEL
+#define MY_HARDENING_LEVEL 2
+#include <csignal>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "check.h"
+#include "vector/vector.h"
+
+namespace {
+    // 在子进程中执行f，返回子进程是否因检查失败而abort
+    template <class F>
+    bool aborts(F f) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::freopen("/dev/null", "w", stderr);
+            f();
+            _exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+    }
+
+    my::vector<int> iota(int n, int base) {
+        my::vector<int> v;
+        for (int i = 0; i < n; i++) {
+            v.push_back(base + i);
+        }
+        return v;
+    }
+
+    // swap之后，原来的迭代器指向另一个容器中的同一元素，仍然有效
+    void swapKeepsIterators() {
+        my::vector<int> a = iota(10, 0);
+        my::vector<int> b = iota(3, 100);
+        auto ia = a.begin() + 4;
+        auto ib = b.begin() + 1;
+        my::vector<int>::const_iterator ea = a.end();
+        a.swap(b);
+        MY_EXPECT(*ia == 4);
+        MY_EXPECT(*ib == 101);
+        MY_EXPECT(ea == b.end());
+        b.erase(ia); // ia现在属于b
+        MY_EXPECT(b.size() == 9 && b[4] == 5);
+        MY_EXPECT(*ib == 101); // a没有被修改，ib仍然有效
+        my::vector<int> empty;
+        empty.swap(a); // 没有创建过迭代器的一方没有锚
+        MY_EXPECT(*ib == 101);
+    }
+
+    // 修改容器后使用旧迭代器、把迭代器交给别的容器，仍然会被发现
+    void staleIteratorsDetected() {
+        MY_EXPECT(aborts([] {
+            my::vector<int> v = iota(4, 0);
+            auto it = v.begin();
+            v.push_back(4); // 扩容
+            (void)*it;
+        }));
+        MY_EXPECT(aborts([] {
+            my::vector<int> a = iota(4, 0), b = iota(4, 0);
+            auto it = a.begin();
+            a.swap(b);
+            a.erase(it); // it已经随元素转到b
+        }));
+        MY_EXPECT(!aborts([] {
+            my::vector<int> a = iota(4, 0), b = iota(4, 0);
+            auto it = a.begin();
+            a.swap(b);
+            b.erase(it);
+        }));
+    }
+
+    // 锚在常量求值中也能分配和释放
+    constexpr int constexprSwap() {
+        my::vector<int> a, b;
+        a.push_back(1);
+        a.push_back(2);
+        b.push_back(3);
+        auto it = a.begin() + 1;
+        a.swap(b);
+        return *it + *a.begin();
+    }
+    static_assert(constexprSwap() == 5);
+}
+
+int main() {
+    swapKeepsIterators();
+    staleIteratorsDetected();
+    return MY_TEST_RESULT();
+}
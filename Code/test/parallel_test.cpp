@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include "check.h"
+#include "parallel/parallel.h"
+#include "vector/vector.h"
+
+namespace {
+    // 没有默认构造函数，只能移动
+    struct keyed {
+        explicit keyed(int k) : key(k), payload(std::to_string(k)) {}
+        keyed(keyed&&) = default;
+        keyed& operator=(keyed&&) = default;
+        int key;
+        std::string payload;
+    };
+
+    // 各种长度、块数、线程数下结果与std::sort一致
+    void sortMatchesStd() {
+        std::mt19937 rng(7);
+        for (size_t workers : {0, 1, 3}) {
+            my::parallel::set_thread_count(workers);
+            for (size_t n : {0, 1, 5, 4096, 10000, 100003}) {
+                for (size_t grain : {0, 1000, 777}) {
+                    my::vector<int> v;
+                    for (size_t i = 0; i < n; i++) {
+                        v.push_back(int(rng() % 1000)); // 大量重复元素
+                    }
+                    my::vector<int> expect(v);
+                    std::sort(expect.begin(), expect.end());
+                    my::parallel::sort(v.begin(), v.end(), std::less<>(), grain);
+                    MY_EXPECT(std::equal(v.begin(), v.end(), expect.begin(), expect.end()));
+                }
+            }
+        }
+        my::vector<keyed> k;
+        for (int i = 0; i < 50000; i++) {
+            k.push_back(keyed(int(rng() % 50000)));
+        }
+        my::parallel::sort(k.begin(), k.end(), [](const keyed& a, const keyed& b) { return a.key > b.key; }, 1000);
+        bool ok = true;
+        for (size_t i = 0; i < k.size(); i++) {
+            ok = ok && k[i].payload == std::to_string(k[i].key) && (i == 0 || k[i - 1].key >= k[i].key);
+        }
+        MY_EXPECT(ok);
+    }
+
+    // 用户函数在某一块抛出异常：调用者收到这个异常，线程池仍然可用
+    void exceptionPropagates() {
+        for (size_t workers : {0, 2}) {
+            my::parallel::set_thread_count(workers);
+            my::vector<int> v;
+            for (int i = 0; i < 100000; i++) {
+                v.push_back(i);
+            }
+            bool thrown = false;
+            try {
+                my::parallel::for_each(v.begin(), v.end(), [](int x) {
+                    if (x == 54321) {
+                        throw std::runtime_error("chunk");
+                    }
+                }, 1000);
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            MY_EXPECT(thrown);
+            MY_EXPECT(my::parallel::reduce(v.begin(), v.end(), 0L, std::plus<>(), 1000) > 0);
+            bool compThrown = false;
+            try {
+                my::parallel::sort(v.begin(), v.end(), [](int, int) -> bool { throw std::logic_error("comp"); }, 1000);
+            } catch (const std::logic_error&) {
+                compThrown = true;
+            }
+            MY_EXPECT(compThrown);
+        }
+    }
+}
+
+int main() {
+    sortMatchesStd();
+    exceptionPropagates();
+    return MY_TEST_RESULT();
+}
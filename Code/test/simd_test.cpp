@@ -0,0 +1,128 @@
+#include <cstring>
+#include <random>
+#include "check.h"
+#include "simd/simd.h"
+#include "vector/vector.h"
+
+namespace {
+    using my::simd::isa;
+
+    // 逐位比较，浮点结果必须完全一致而不只是近似相等
+    template <class T>
+    bool sameBits(T a, T b) {
+        return std::memcmp(&a, &b, sizeof(T)) == 0;
+    }
+
+    template <class T>
+    my::vector<T> randomData(size_t n, std::mt19937_64& rng) {
+        my::vector<T> v;
+        for (size_t i = 0; i < n; i++) {
+            if constexpr (std::is_floating_point_v<T>) {
+                v.push_back(T(std::uniform_real_distribution<double>(-1000, 1000)(rng)));
+            } else {
+                v.push_back(T(int64_t(rng() % 2001) - 1000));
+            }
+        }
+        return v;
+    }
+
+    // 同一份输入在某个指令集下的全部结果
+    template <class T>
+    struct results {
+        T sum, min, max, dot;
+        my::vector<T> axpy;
+        size_t count, find, findMissing;
+    };
+
+    // 从p + offset开始取n个元素，offset不为0时数据不按向量宽度对齐
+    template <class T>
+    results<T> runAll(const my::vector<T>& x, const my::vector<T>& y, size_t offset, size_t n) {
+        const T* p = x.data() + offset;
+        const T* q = y.data() + offset;
+        results<T> r;
+        r.sum = my::simd::sum(p, n);
+        r.min = n ? my::simd::min(p, n) : T();
+        r.max = n ? my::simd::max(p, n) : T();
+        r.dot = my::simd::dot(p, q, n);
+        r.axpy = my::vector<T>(q, q + n);
+        my::simd::axpy(T(3), p, r.axpy.data(), n);
+        T key = n ? p[n * 2 / 3] : T(1);
+        r.count = my::simd::count(p, n, key);
+        r.find = my::simd::find(p, n, key);
+        r.findMissing = my::simd::find(p, n, T(12345));
+        return r;
+    }
+
+    // 与逐个元素的标量循环对比：整数全部一致，浮点只对不涉及归约顺序的结果比较
+    template <class T>
+    void checkScalar(const results<T>& r, const my::vector<T>& x, const my::vector<T>& y, size_t offset, size_t n) {
+        const T* p = x.data() + offset;
+        const T* q = y.data() + offset;
+        T sum = 0, dot = 0, mn = n ? p[0] : T(), mx = n ? p[0] : T();
+        T key = n ? p[n * 2 / 3] : T(1);
+        size_t count = 0, find = n;
+        for (size_t i = 0; i < n; i++) {
+            sum += p[i];
+            dot += p[i] * q[i];
+            mn = p[i] < mn ? p[i] : mn;
+            mx = p[i] > mx ? p[i] : mx;
+            count += p[i] == key;
+            if (find == n && p[i] == key) {
+                find = i;
+            }
+            MY_EXPECT(sameBits(r.axpy[i], T(T(3) * p[i] + q[i])));
+        }
+        if constexpr (std::is_integral_v<T>) {
+            MY_EXPECT(r.sum == sum);
+            MY_EXPECT(r.dot == dot);
+        }
+        MY_EXPECT(sameBits(r.min, mn));
+        MY_EXPECT(sameBits(r.max, mx));
+        MY_EXPECT(r.count == count);
+        MY_EXPECT(r.find == find);
+        MY_EXPECT(r.findMissing == n);
+    }
+
+    template <class T>
+    void checkSame(const results<T>& a, const results<T>& b) {
+        MY_EXPECT(sameBits(a.sum, b.sum));
+        MY_EXPECT(sameBits(a.min, b.min));
+        MY_EXPECT(sameBits(a.max, b.max));
+        MY_EXPECT(sameBits(a.dot, b.dot));
+        MY_EXPECT(a.axpy.size() == b.axpy.size() && std::memcmp(a.axpy.data(), b.axpy.data(), a.axpy.size() * sizeof(T)) == 0);
+        MY_EXPECT(a.count == b.count);
+        MY_EXPECT(a.find == b.find);
+        MY_EXPECT(a.findMissing == b.findMissing);
+    }
+
+    // 基线、AVX2、AVX-512三个版本对同一输入逐位一致；CPU不支持的指令集跳过
+    template <class T>
+    void isasAgree() {
+        std::mt19937_64 rng(sizeof(T));
+        for (size_t n : {0, 1, 7, 15, 16, 17, 63, 64, 65, 1000, 4099}) {
+            for (size_t offset : {0, 1, 3}) {
+                auto x = randomData<T>(n + offset, rng);
+                auto y = randomData<T>(n + offset, rng);
+                my::simd::set_isa(isa::baseline);
+                results<T> base = runAll(x, y, offset, n);
+                checkScalar(base, x, y, offset, n);
+                for (isa which : {isa::avx2, isa::avx512}) {
+                    if (my::simd::set_isa(which) != which) {
+                        continue;
+                    }
+                    checkSame(base, runAll(x, y, offset, n));
+                }
+            }
+        }
+        my::simd::set_isa(my::simd::detect());
+    }
+}
+
+int main() {
+    std::printf("simd: highest isa %d\n", int(my::simd::detect()));
+    isasAgree<float>();
+    isasAgree<double>();
+    isasAgree<int32_t>();
+    isasAgree<int64_t>();
+    return MY_TEST_RESULT();
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include "check.h"
+#include "soa_vector/soa_vector.h"
+
+namespace {
+    typedef my::soa_vector<int, std::string> table;
+    static_assert(std::is_same_v<std::iterator_traits<table::iterator>::iterator_category, std::random_access_iterator_tag>);
+    static_assert(std::is_same_v<std::iterator_traits<table::iterator>::value_type, std::tuple<int, std::string>>);
+    static_assert(std::is_same_v<std::iterator_traits<table::const_iterator>::difference_type, ptrdiff_t>);
+
+    // 构造第throwAt个对象时抛出异常
+    struct fragile {
+        static inline int count = 0;
+        static inline int throwAt = -1;
+
+        int value;
+        fragile(int v) : value(v) {
+            if (count++ == throwAt) {
+                throw std::runtime_error("construct");
+            }
+        }
+    };
+
+    // emplace_back的参数直接转发给各列：只能移动的类型也能插入，不产生中间的tuple
+    void emplaceForwards() {
+        my::soa_vector<int, std::unique_ptr<int>> v;
+        for (int i = 0; i < 10; i++) {
+            v.emplace_back(i, std::make_unique<int>(i * i));
+        }
+        MY_EXPECT(v.size() == 10);
+        MY_EXPECT(*std::get<1>(v[3]) == 9);
+
+        table t;
+        std::string s = "abc";
+        t.emplace_back(1, std::move(s));
+        t.emplace_back(2, "def"); // 第二列直接用const char*构造std::string
+        t.push_back(std::make_tuple(3, std::string("ghi")));
+        MY_EXPECT(t.size() == 3);
+        MY_EXPECT(std::get<1>(t[0]) == "abc");
+        MY_EXPECT(std::get<1>(t[1]) == "def");
+        MY_EXPECT(std::get<1>(t[2]) == "ghi");
+    }
+
+    // 后面的列构造失败时，前面已经插入的列被撤销，各列长度保持一致
+    void pushRollback() {
+        my::soa_vector<int, fragile, int> v;
+        for (int i = 0; i < 5; i++) {
+            v.emplace_back(i, i, i);
+        }
+        fragile::count = 0;
+        fragile::throwAt = 0;
+        bool thrown = false;
+        try {
+            v.emplace_back(100, 100, 100);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        fragile::throwAt = -1;
+        MY_EXPECT(thrown);
+        MY_EXPECT(v.size() == 5);
+        MY_EXPECT(v.column<0>().size() == 5);
+        MY_EXPECT(v.column<1>().size() == 5);
+        MY_EXPECT(v.column<2>().size() == 5);
+        v.emplace_back(5, 5, 5);
+        MY_EXPECT(std::get<0>(v[5]) == 5 && std::get<1>(v[5]).value == 5 && std::get<2>(v[5]) == 5);
+    }
+
+    // 迭代器可以交给标准库的只读算法
+    void iteratorAlgorithms() {
+        my::soa_vector<int, double> v;
+        for (int i = 0; i < 100; i++) {
+            v.emplace_back(i, i * 0.5);
+        }
+        MY_EXPECT(std::distance(v.begin(), v.end()) == 100);
+        auto it = std::find_if(v.begin(), v.end(), [](const auto& r) { return std::get<0>(r) == 42; });
+        MY_EXPECT(it - v.begin() == 42);
+        MY_EXPECT(std::get<1>(it[1]) == 21.5);
+        MY_EXPECT(std::count_if(v.begin(), v.end(), [](const auto& r) { return std::get<1>(r) >= 25; }) == 50);
+        auto mid = v.begin();
+        std::advance(mid, 10);
+        mid += 5;
+        mid -= 3;
+        MY_EXPECT(mid - v.begin() == 12 && v.begin() < mid && mid <= v.end());
+        for (auto [id, price] : v) {
+            price = id;
+        }
+        MY_EXPECT(v.column<1>()[7] == 7.0);
+    }
+}
+
+int main() {
+    emplaceForwards();
+    pushRollback();
+    iteratorAlgorithms();
+    return MY_TEST_RESULT();
+}
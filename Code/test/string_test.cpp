@@ -0,0 +1,96 @@
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "check.h"
+#include "string/string.h"
+#include "vector/vector.h"
+
+namespace {
+    static_assert(std::is_nothrow_move_constructible_v<my::string>);
+    static_assert(std::is_nothrow_move_assignable_v<my::string>);
+
+    my::string withNul() {
+        my::string s;
+        s.append("ab\0cd", 5);
+        return s;
+    }
+
+    // 拷贝构造和拷贝赋值按长度拷贝，'\0'之后的内容也要保留
+    void embeddedNul() {
+        my::string s = withNul();
+        my::string copy(s);
+        MY_EXPECT(copy.size() == 5);
+        MY_EXPECT(std::memcmp(copy.c_str(), "ab\0cd", 6) == 0);
+        my::string assigned("x");
+        assigned = s;
+        MY_EXPECT(assigned.size() == 5 && assigned == s);
+        MY_EXPECT(copy.find('d') == 4);
+    }
+
+    // 移动后源对象是空串，仍然可以继续使用
+    void moved() {
+        my::string s = withNul();
+        const char* buf = s.c_str();
+        my::string t(std::move(s));
+        MY_EXPECT(t.c_str() == buf); // 接管存储，没有拷贝
+        MY_EXPECT(t.size() == 5);
+        MY_EXPECT(s.size() == 0 && s.empty() && s.capacity() == 0);
+        MY_EXPECT(std::strcmp(s.c_str(), "") == 0);
+        MY_EXPECT(s.find('a') == my::string::npos);
+        MY_EXPECT(s == my::string(""));
+        s.clear();
+        s.resize(0);
+        s.append("", 0);
+        s.insert(0, "");
+        MY_EXPECT(s.size() == 0);
+        s.push_back('x');
+        s.append("yz");
+        MY_EXPECT(s == my::string("xyz"));
+
+        my::string u("other");
+        u = std::move(t);
+        MY_EXPECT(u.size() == 5 && u.c_str() == buf);
+        my::string fromMoved(std::move(t)); // t与u交换后持有"other"
+        MY_EXPECT(fromMoved == my::string("other"));
+        my::string copyOfEmpty(t);
+        MY_EXPECT(copyOfEmpty.size() == 0 && std::strcmp(copyOfEmpty.c_str(), "") == 0);
+        t.reserve(8);
+        MY_EXPECT(t.capacity() == 8 && std::strcmp(t.c_str(), "") == 0);
+    }
+
+    // vector扩容时元素用移动转移，不拷贝字符数据
+    void relocation() {
+        my::vector<my::string> v;
+        v.push_back(my::string("payload"));
+        const char* buf = v[0].c_str();
+        for (int i = 0; i < 100; i++) {
+            v.push_back(my::string("x"));
+        }
+        MY_EXPECT(v[0].c_str() == buf);
+    }
+
+    // 空串和越界的pos上查找返回npos，不再触发检查
+    void findOnEmpty() {
+        my::string empty;
+        MY_EXPECT(empty.find('a') == my::string::npos);
+        MY_EXPECT(empty.find("a") == my::string::npos);
+        MY_EXPECT(empty.find("") == 0);
+        my::string abc("abc");
+        MY_EXPECT(abc.find('c', 3) == my::string::npos);
+        MY_EXPECT(abc.find('c', my::string::npos) == my::string::npos);
+        MY_EXPECT(abc.find("bc", 1) == 1);
+        MY_EXPECT(abc.find("bc", 2) == my::string::npos);
+        MY_EXPECT(abc.find("", 3) == 3);
+        MY_EXPECT(abc.find("", 4) == my::string::npos);
+        MY_EXPECT(abc.rfind('a') == 0);
+        MY_EXPECT(empty.rfind('a') == my::string::npos);
+    }
+}
+
+int main() {
+    embeddedNul();
+    moved();
+    relocation();
+    findOnEmpty();
+    return MY_TEST_RESULT();
+}
@@ -0,0 +1,98 @@
+#include <random>
+#include "check.h"
+#include "simd/simd.h"
+#include "string/string.h"
+#include "string/utf8.h"
+
+namespace {
+    using my::simd::isa;
+
+    // 随机的合法UTF-8，一到四字节的字符混在一起，序列会跨过16、32字节的块边界
+    my::string randomText(size_t chars, std::mt19937_64& rng) {
+        my::string s;
+        char buf[4];
+        for (size_t i = 0; i < chars; i++) {
+            char32_t cp;
+            switch (rng() % 5) {
+            case 0: cp = 0x80 + rng() % 0x780; break;
+            case 1: cp = 0x800 + rng() % 0xd000; break; // 跳过代理区之前的三字节范围
+            case 2: cp = 0x10000 + rng() % 0x100000; break;
+            default: cp = 0x20 + rng() % 0x5f; break;
+            }
+            char* end = my::utf8::_scalar::encode(cp, buf);
+            s.append(buf, size_t(end - buf));
+        }
+        return s;
+    }
+
+    // 标量版本作为参照，SSSE3（基线）和AVX2版本对同一输入的校验结果和码点个数必须一致
+    void checkAgainstScalar(const my::string& s) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(s.c_str());
+        bool valid = my::utf8::_scalar::validate(p, s.size());
+        size_t four = 0;
+        size_t count = valid ? my::utf8::_scalar::count(p, s.size(), four) : 0;
+        for (isa which : {isa::baseline, isa::avx2}) {
+            if (my::simd::set_isa(which) != which) {
+                continue;
+            }
+            MY_EXPECT(my::utf8::validate(s.c_str(), s.size()) == valid);
+            if (valid) {
+                MY_EXPECT(my::utf8::count(s.c_str(), s.size()) == count);
+            }
+        }
+        my::simd::set_isa(my::simd::detect());
+    }
+
+    // 合法文本，以及在随机位置改坏一个字节、截掉末尾几个字节后的文本
+    void randomInputs() {
+        std::mt19937_64 rng(1);
+        for (size_t chars : {0, 1, 5, 15, 16, 17, 31, 33, 100, 1000}) {
+            for (int round = 0; round < 20; round++) {
+                my::string s = randomText(chars, rng);
+                MY_EXPECT(my::utf8::_scalar::validate(reinterpret_cast<const uint8_t*>(s.c_str()), s.size()));
+                checkAgainstScalar(s);
+                if (s.empty()) {
+                    continue;
+                }
+                my::string bad = s;
+                bad[rng() % bad.size()] = char(0x80 + rng() % 0x80);
+                checkAgainstScalar(bad);
+                my::string cut;
+                cut.append(s.c_str(), s.size() - 1 - rng() % std::min<size_t>(3, s.size()));
+                checkAgainstScalar(cut);
+            }
+        }
+    }
+
+    // 各类不合法序列放在块内不同位置
+    void knownInvalid() {
+        const char* cases[] = {
+            "\x80", // 单独的后续字节
+            "\xC0\x80", // 两字节过长编码
+            "\xE0\x80\x80", // 三字节过长编码
+            "\xF0\x80\x80\x80", // 四字节过长编码
+            "\xED\xA0\x80", // 代理区
+            "\xF4\x90\x80\x80", // 大于0x10FFFF
+            "\xF5\x80\x80\x80",
+            "\xE4\xB8", // 截断
+            "\xC3\xA9\xA9", // 多余的后续字节
+        };
+        for (const char* c : cases) {
+            for (size_t pad = 0; pad < 40; pad++) {
+                my::string s;
+                for (size_t i = 0; i < pad; i++) {
+                    s.push_back('a');
+                }
+                s.append(c);
+                checkAgainstScalar(s);
+                MY_EXPECT(!my::utf8::validate(s.c_str(), s.size()));
+            }
+        }
+    }
+}
+
+int main() {
+    randomInputs();
+    knownInvalid();
+    return MY_TEST_RESULT();
+}
@@ -0,0 +1,58 @@
+#include <stdexcept>
+#include "check.h"
+#include "vector/vector.h"
+
+namespace {
+    // 第throwAt次拷贝时抛出异常，移动构造不是noexcept，扩容时只能拷贝
+    struct fragile {
+        static inline int live = 0;
+        static inline int copies = 0;
+        static inline int throwAt = -1;
+
+        int value;
+        explicit fragile(int v) : value(v) { live++; }
+        fragile(const fragile& o) : value(o.value) {
+            if (copies++ == throwAt) {
+                throw std::runtime_error("copy");
+            }
+            live++;
+        }
+        fragile(fragile&& o) : value(o.value) { live++; }
+        fragile& operator=(const fragile&) = default;
+        ~fragile() { live--; }
+    };
+
+    // reserve转移元素时抛出异常：已构造的元素被析构、新空间被释放，原有内容不变
+    void reserveRollback() {
+        {
+            my::vector<fragile> v;
+            v.reserve(8);
+            for (int i = 0; i < 8; i++) {
+                v.push_back(fragile(i));
+            }
+            size_t cap = v.capacity();
+            fragile::copies = 0;
+            fragile::throwAt = 5;
+            bool thrown = false;
+            try {
+                v.reserve(64);
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            fragile::throwAt = -1;
+            MY_EXPECT(thrown);
+            MY_EXPECT(v.capacity() == cap);
+            MY_EXPECT(v.size() == 8);
+            MY_EXPECT(fragile::live == 8);
+            for (int i = 0; i < 8; i++) {
+                MY_EXPECT(v[i].value == i);
+            }
+        }
+        MY_EXPECT(fragile::live == 0);
+    }
+}
+
+int main() {
+    reserveRollback();
+    return MY_TEST_RESULT();
+}
@@ -1,55 +1,117 @@
 #pragma once
+#include <algorithm>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include "../hardening/hardening.h"
+#include "../telemetry/telemetry.h"
 
 namespace my {
-    template <class T>
+inline namespace MY_HARDENING_NAMESPACE {
+    /**
+     * vector类模板
+     * Alloc为分配器类型，需满足std::allocator的接口要求，默认使用std::allocator<T>
+     * 所有内存的申请释放、元素的构造析构都通过std::allocator_traits<Alloc>完成，
+     * 因此[_finish, _end_of_storage)之间是未构造的原始内存
+     * 下标越界等检查由MY_HARDENING_LEVEL控制，见hardening.h；
+     * full等级会改变布局和迭代器类型，所以vector放在按等级命名的内联命名空间中
+     */
+    template <class T, class Alloc = std::allocator<T>>
     class vector
     {
     public:
-        // 迭代器
+        // 迭代器，full检查等级下使用能发现迭代器失效的检查迭代器
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+        typedef _checked_iterator<T, vector<T, Alloc>> iterator;
+        typedef _checked_iterator<const T, vector<T, Alloc>> const_iterator;
+#else
         typedef T* iterator;
         typedef const T* const_iterator;
-        
+#endif
+        typedef Alloc allocator_type;
+        typedef std::allocator_traits<Alloc> alloc_traits;
+
         // 默认成员函数
-        vector(); // 构造函数
-        vector(size_t n, const T& value); // 带参数的构造函数
-        vector(long n, const T& value);
-        vector(int n, const T& value);
+        constexpr vector(); // 构造函数
+        constexpr explicit vector(const Alloc& alloc); // 指定分配器的构造函数
+        constexpr vector(size_t n, const T& value, const Alloc& alloc = Alloc()); // 带参数的构造函数
+        constexpr vector(long n, const T& value, const Alloc& alloc = Alloc());
+        constexpr vector(int n, const T& value, const Alloc& alloc = Alloc());
         template<class InputIterator>
-        vector(InputIterator first, InputIterator last); // 范围构造函数
-        vector(const vector<T>& v); // 拷贝构造函数
-        vector<T>& operator=(const vector& v); // 赋值运算符重载
-        vector<T>& operator=(const vector v); // 赋值运算符重载（现代写法）
-        ~vector(); // 析构函数
+        constexpr vector(InputIterator first, InputIterator last, const Alloc& alloc = Alloc()); // 范围构造函数
+        constexpr vector(const vector<T, Alloc>& v); // 拷贝构造函数
+        constexpr vector(vector<T, Alloc>&& v) noexcept; // 移动构造函数
+        constexpr vector<T, Alloc>& operator=(const vector& v); // 赋值运算符重载
+        constexpr vector<T, Alloc>& operator=(vector&& v); // 移动赋值运算符重载
+        constexpr ~vector(); // 析构函数
 
         // 迭代器相关函数
-        iterator begin();
-        iterator end();
-        const_iterator begin()const;
-        const_iterator end()const;
+        constexpr iterator begin();
+        constexpr iterator end();
+        constexpr const_iterator begin()const;
+        constexpr const_iterator end()const;
 
         // 容量和大小
-        size_t size()const; // 有效长度
-        size_t capacity()const; // 容量
-        void reserve(size_t n); // 改变容量
-        void resize(size_t n, const T& value = T()); // 改变有效长度
-        bool empty()const;
+        constexpr size_t size()const; // 有效长度
+        constexpr size_t capacity()const; // 容量
+        constexpr void reserve(size_t n); // 改变容量
+        constexpr void resize(size_t n, const T& value = T()); // 改变有效长度
+        constexpr bool empty()const;
 
         // 修改容器内容相关函数
-        void push_back(const T& x);
-        void pop_back();
-        void insert(iterator pos, const T& x); // 在指定位置插入元素
-        iterator erase(iterator pos); // 删除指定位置的元素
-        void swap(vector<T>& v); // 交换两个vector的内容
+        constexpr void push_back(const T& x);
+        constexpr void push_back(T&& x); // 右值直接移动进容器
+        template <class... Args>
+        constexpr T& emplace_back(Args&&... args); // 用args在尾部直接构造元素
+        constexpr void pop_back();
+        constexpr void insert(iterator pos, const T& x); // 在指定位置插入元素
+        template<class InputIterator>
+        constexpr iterator insert(iterator pos, InputIterator first, InputIterator last); // 在指定位置插入一段区间
+        constexpr iterator erase(iterator pos); // 删除指定位置的元素
+        constexpr iterator erase(iterator first, iterator last); // 删除[first, last)区间的元素
+        constexpr void assign(size_t n, const T& value); // 将内容替换为n个value
+        template<class InputIterator>
+            requires (!std::is_integral_v<InputIterator>)
+        constexpr void assign(InputIterator first, InputIterator last); // 将内容替换为一段区间
+        constexpr void clear(); // 清空容器，不释放空间
+        constexpr void swap(vector<T, Alloc>& v); // 交换两个vector的内容
 
         // 访问容器相关函数
-        T& operator[](size_t i);
-        const T& operator[](size_t i)const;
+        constexpr T& operator[](size_t i);
+        constexpr const T& operator[](size_t i)const;
+        constexpr T* data(); // 底层数组，不做任何检查，用于热循环
+        constexpr const T* data()const;
+        constexpr std::span<T> span(); // 以span形式返回全部元素，不做任何检查
+        constexpr std::span<const T> span()const;
+
+        // 获取分配器
+        constexpr allocator_type get_allocator()const;
 
     private:
-        iterator _start; // 指向容器的起始位置
-        iterator _finish; // 指向容器有效数据的结束位置
-        iterator _end_of_storage; // 指向容器的结束位置
+        template <class... Args>
+        constexpr void construct(T* p, Args&&... args); // 在p处构造元素，开启遥测时统计拷贝和移动的次数
+        constexpr void destroy(T* first, T* last); // 析构[first, last)区间的元素，不释放空间
+        constexpr void release(); // 析构所有元素并把空间还给分配器
+        constexpr iterator wrap(T* p)const; // 把指针包装成迭代器
+        constexpr T* unwrap(const_iterator it)const; // 取出迭代器中的指针，full等级下检查迭代器是否有效
+        constexpr void invalidate(); // 使已有的迭代器失效（full等级下版本号加一）
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+        constexpr _iterator_anchor<vector>* anchor()const; // 获取锚，第一次创建迭代器时才分配
+#endif
+
+        T* _start; // 指向容器的起始位置
+        T* _finish; // 指向容器有效数据的结束位置
+        T* _end_of_storage; // 指向容器的结束位置
+        [[no_unique_address]] Alloc _alloc; // 分配器，无状态分配器不占用空间
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+        mutable _iterator_anchor<vector>* _anchor = nullptr; // 迭代器通过锚找到容器和版本号，swap时随元素一起交换
+
+        template <class, class>
+        friend struct ::my::_checked_iterator; // 检查迭代器在外层命名空间中，需要限定名字
+#endif
     };
 
 
@@ -57,19 +119,30 @@ namespace my {
     // 默认成员函数
 
     // 构造函数
-    template <class T>
-    vector<T>::vector()
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::vector()
+        : _start(nullptr)
+        , _finish(nullptr)
+        , _end_of_storage(nullptr)
+        , _alloc()
+    {}
+
+    // 指定分配器的构造函数
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::vector(const Alloc& alloc)
         : _start(nullptr)
         , _finish(nullptr)
         , _end_of_storage(nullptr)
+        , _alloc(alloc)
     {}
 
     // 带参数的构造函数，还有两个重载
-    template <class T>
-    vector<T>::vector(size_t n, const T& value)
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::vector(size_t n, const T& value, const Alloc& alloc)
         : _start(nullptr)
         , _finish(nullptr)
         , _end_of_storage(nullptr)
+        , _alloc(alloc)
     {
         reserve(n);
         for (size_t i = 0; i < n; i++) {
@@ -77,42 +150,43 @@ namespace my {
         }
     }
 
-    template <class T>
-    vector<T>::vector(long n, const T& value)
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::vector(long n, const T& value, const Alloc& alloc)
         : _start(nullptr)
         , _finish(nullptr)
         , _end_of_storage(nullptr)
+        , _alloc(alloc)
     {
         reserve(n);
-        for (size_t i = 0; i < n; i++) {
+        for (long i = 0; i < n; i++) {
             push_back(value);
         }
     }
 
-    template <class T>
-    vector<T>::vector(int n, const T& value)
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::vector(int n, const T& value, const Alloc& alloc)
         : _start(nullptr)
         , _finish(nullptr)
         , _end_of_storage(nullptr)
+        , _alloc(alloc)
     {
         reserve(n);
-        for (size_t i = 0; i < n; i++) {
+        for (int i = 0; i < n; i++) {
             push_back(value);
         }
     }
 
     // 范围构造函数（迭代器）
-    template <class T>
+    // 前向及以上的迭代器可以提前算出区间长度，一次性开好空间，避免多次扩容
+    template <class T, class Alloc>
     template<class InputIterator>
-    vector<T>::vector(InputIterator first, InputIterator last)
+    constexpr vector<T, Alloc>::vector(InputIterator first, InputIterator last, const Alloc& alloc)
         : _start(nullptr)
         , _finish(nullptr)
         , _end_of_storage(nullptr)
+        , _alloc(alloc)
     {
-        while (first != last) {
-            push_back(*first);
-            ++first;
-        }
+        assign(first, last);
     }
 
     // 拷贝构造函数
@@ -137,11 +211,13 @@ namespace my {
 
     // 拷贝构造函数
     // 现代写法
-    template <class T>
-    vector<T>::vector(const vector<T>& v)
+    // 分配器由select_on_container_copy_construction决定（std::allocator直接拷贝一份）
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::vector(const vector<T, Alloc>& v)
         : _start(nullptr)
         , _finish(nullptr)
         , _end_of_storage(nullptr)
+        , _alloc(alloc_traits::select_on_container_copy_construction(v._alloc))
     {
         reserve(v.capacity());
         for (auto& e : v) {
@@ -151,80 +227,132 @@ namespace my {
         }
     }
 
+    // 移动构造函数，直接接管v的空间，分配器随之移动
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::vector(vector<T, Alloc>&& v) noexcept
+        : _start(v._start)
+        , _finish(v._finish)
+        , _end_of_storage(v._end_of_storage)
+        , _alloc(std::move(v._alloc))
+    {
+        v.invalidate();
+        v._start = nullptr;
+        v._finish = nullptr;
+        v._end_of_storage = nullptr;
+    }
+
     // 赋值运算符重载
     // 传统写法
-    template <class T>
-    vector<T>& vector<T>::operator=(const vector& v) {
+    // propagate_on_container_copy_assignment为真且两个分配器不等时，要先用旧分配器释放空间再换分配器
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>& vector<T, Alloc>::operator=(const vector& v) {
         if (this != &v) {
-            delete[] _start;
-            _start = new T[v.capacity()];
+            clear();
+            if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+                if (_alloc != v._alloc) {
+                    release();
+                }
+                _alloc = v._alloc;
+            }
+            reserve(v.capacity());
             for (size_t i = 0; i < v.size(); i++) {
-                _start[i] = v[i];
+                construct(_finish, v[i]);
+                _finish++;
             }
-            _finish = _start + v.size();
-            _end_of_storage = _start + v.capacity();
         }
         return *this;
     }
 
     // 赋值运算符重载
     // 现代写法
-    template <class T>
+    // 与上面的传统写法和下面的移动赋值同时声明会产生重载歧义，且无法照顾分配器的传播规则，这里只作参考
+    // template <class T, class Alloc>
+    // /**
+    //  * 在右值传参时并没有使用引用传参
+    //  * 因为这样可以间接调用vector的拷贝构造函数
+    //  * 然后将这个拷贝构造出来的容器v与左值进行交换
+    //  * 此时就相当于完成了赋值操作
+    //  * 而容器v会在该函数调用结束时自动析构
+    //  */
+    // vector<T, Alloc>& vector<T, Alloc>::operator=(vector v) { //编译器接收右值的时候自动调用其拷贝构造函数
+    //     swap(v); // 交换两个vector的内容
+    //     return *this; // 支持连续赋值
+    // }
+
     /**
-     * 在右值传参时并没有使用引用传参
-     * 因为这样可以间接调用vector的拷贝构造函数
-     * 然后将这个拷贝构造出来的容器v与左值进行交换
-     * 此时就相当于完成了赋值操作
-     * 而容器v会在该函数调用结束时自动析构
+     * 移动赋值运算符重载
+     * 1、propagate_on_container_move_assignment为真或两个分配器相等时，直接接管v的空间。
+     * 2、否则v的空间不能由本容器的分配器释放，只能逐个移动元素。
      */
-    vector<T>& vector<T>::operator=(const vector v) { //编译器接收右值的时候自动调用其拷贝构造函数
-        swap(v); // 交换两个vector的内容
-        return *this; // 支持连续赋值
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>& vector<T, Alloc>::operator=(vector&& v) {
+        if (this == &v) {
+            return *this;
+        }
+        if constexpr (!alloc_traits::propagate_on_container_move_assignment::value) {
+            if (_alloc != v._alloc) {
+                assign(std::make_move_iterator(v.data()), std::make_move_iterator(v.data() + v.size()));
+                v.clear();
+                return *this;
+            }
+        }
+        release();
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            _alloc = std::move(v._alloc);
+        }
+        _start = v._start;
+        _finish = v._finish;
+        _end_of_storage = v._end_of_storage;
+        v.invalidate();
+        v._start = nullptr;
+        v._finish = nullptr;
+        v._end_of_storage = nullptr;
+        return *this;
     }
 
     // 析构函数
-    template <class T>
-    vector<T>::~vector() {
-        if (_start) {
-            delete[] _start;
-            _start = nullptr;
-            _finish = nullptr;
-            _end_of_storage = nullptr;
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::~vector() {
+        release();
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+        if (!std::is_constant_evaluated()) {
+            delete _anchor;
         }
+#endif
     }
 
     // 迭代器相关函数
-    template <class T>
-    vector<T>::iterator vector<T>::begin() {
-        return _start;
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::iterator vector<T, Alloc>::begin() {
+        return wrap(_start);
     }
 
-    template <class T>
-    vector<T>::iterator vector<T>::end() {
-        return _finish;
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::iterator vector<T, Alloc>::end() {
+        return wrap(_finish);
     }
 
-    template <class T>
-    vector<T>::const_iterator vector<T>::begin() const {
-        return _start;
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::const_iterator vector<T, Alloc>::begin() const {
+        return wrap(_start);
     }
 
-    template <class T>
-    vector<T>::const_iterator vector<T>::end() const {
-        return _finish;
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::const_iterator vector<T, Alloc>::end() const {
+        return wrap(_finish);
     }
 
     // 容量和大小
 
     // 有效长度
-    template <class T>
-    size_t vector<T>::size()const {
+    template <class T, class Alloc>
+    constexpr size_t vector<T, Alloc>::size()const {
         return _finish - _start;
     }
 
     // 容量
-    template <class T>
-    size_t vector<T>::capacity()const {
+    template <class T, class Alloc>
+    constexpr size_t vector<T, Alloc>::capacity()const {
         return _end_of_storage - _start;
     }
 
@@ -232,17 +360,29 @@ namespace my {
      * 改变容量
      * 1、当n大于对象当前的capacity时，将capacity扩大到n或大于n。
      * 2、当n小于对象当前的capacity时，什么也不做。
+     * 新空间由分配器申请，原有元素移动构造（移动可能抛异常时退化为拷贝）到新空间后再析构
+     * 转移中途抛出异常时，析构已经构造好的元素、释放新空间后重新抛出，原有内容不变
      */
-    template <class T>
-    void vector<T>::reserve(size_t n) {
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::reserve(size_t n) {
         if (n > capacity()) {
             size_t sz = size();
-            T* tmp = new T[n];
+            T* tmp = alloc_traits::allocate(_alloc, n);
+            MY_TELEMETRY_ALLOCATE(vector_kind, n * sizeof(T));
             if (_start) {
-                for (size_t i = 0; i < sz; i++) {
-                    tmp[i] = _start[i]; // 拷贝原有元素
+                MY_TELEMETRY_REGROW(vector_kind, sz * sizeof(T));
+                size_t i = 0;
+                try {
+                    for (; i < sz; i++) {
+                        construct(tmp + i, std::move_if_noexcept(_start[i])); // 转移原有元素
+                    }
+                } catch (...) {
+                    destroy(tmp, tmp + i);
+                    alloc_traits::deallocate(_alloc, tmp, n);
+                    MY_TELEMETRY_DEALLOCATE(vector_kind);
+                    throw;
                 }
-                delete[] _start; // 释放原有内存
+                release(); // 释放原有内存
             }
             _start = tmp; // 更新起始位置
             _finish = _start + sz; // 更新有效数据结束位置
@@ -255,92 +395,380 @@ namespace my {
      * 1、当n大于当前的size时，将size扩大到n，扩大的数据为val，若val未给出，则默认为容器所存储类型的默认构造函数所构造出来的值。
      * 2、当n小于当前的size时，将size缩小到n。
      */
-    template <class T>
-    void vector<T>::resize(size_t n, const T& value = T()) {
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::resize(size_t n, const T& value) {
         if (n < size()) {
+            invalidate();
+            destroy(_start + n, _finish);
             _finish = _start + n; // 缩小有效长度
         } else {
             if (n > capacity()) {
                 reserve(n);
             }
             while (_finish < _start + n) {
-                *_finish = value; // 扩大有效长度并填充默认值
+                construct(_finish, value); // 扩大有效长度并填充默认值
                 _finish++;
             }
         }
     }
 
-    template <class T>
-    bool vector<T>::empty()const {
+    template <class T, class Alloc>
+    constexpr bool vector<T, Alloc>::empty()const {
         return _start == _finish;
     }
 
     // 修改容器内容相关函数
-    template <class T>
-    void vector<T>::push_back(const T& x) {
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::push_back(const T& x) {
         if (_finish == _end_of_storage) {
+            T tmp(x); // 先拷贝一份，x可能就是容器中的元素，扩容后原空间会被释放
+            MY_TELEMETRY_COPY(vector_kind, 1);
             size_t new_capacity = capacity() == 0 ? 4 : capacity() * 2; // 扩大容量
             reserve(new_capacity);
+            construct(_finish, std::move(tmp));
+        } else {
+            construct(_finish, x); // 在有效数据结束位置构造新元素
         }
-        *_finish = x; // 在有效数据结束位置插入新元素
         _finish++; // 更新有效数据结束位置
     }
 
-    template <class T>
-    void vector<T>::pop_back() {
-        assert(!empty()); // 确保容器不为空
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::push_back(T&& x) {
+        if (_finish == _end_of_storage) {
+            T tmp(std::move(x)); // 先移出来，x可能就是容器中的元素
+            MY_TELEMETRY_MOVE(vector_kind, 1);
+            size_t new_capacity = capacity() == 0 ? 4 : capacity() * 2;
+            reserve(new_capacity);
+            construct(_finish, std::move(tmp));
+        } else {
+            construct(_finish, std::move(x));
+        }
+        _finish++;
+    }
+
+    // 空间足够时直接在尾部构造；需要扩容时先构造出临时对象，args可能引用容器中的元素
+    template <class T, class Alloc>
+    template <class... Args>
+    constexpr T& vector<T, Alloc>::emplace_back(Args&&... args) {
+        if (_finish == _end_of_storage) {
+            T tmp(std::forward<Args>(args)...);
+            size_t new_capacity = capacity() == 0 ? 4 : capacity() * 2;
+            reserve(new_capacity);
+            construct(_finish, std::move(tmp));
+        } else {
+            construct(_finish, std::forward<Args>(args)...);
+        }
+        return *_finish++;
+    }
+
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::pop_back() {
+        MY_CHECK_CHEAP(!empty()); // 确保容器不为空
+        invalidate();
         _finish--; // 更新有效数据结束位置，删除最后一个元素
+        alloc_traits::destroy(_alloc, _finish);
     }
 
     // 在指定位置插入元素
-    template <class T>
-    void vector<T>::insert(iterator pos, const T& x) {
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::insert(iterator it, const T& x) {
+        T* pos = unwrap(it);
+        invalidate();
+        if (pos == _finish) {
+            push_back(x);
+            return;
+        }
+        T tmp(x); // 先拷贝一份，x可能就是容器中的元素，后移时会被覆盖
+        MY_TELEMETRY_COPY(vector_kind, 1);
         if (_finish == _end_of_storage) {
             size_t len = pos - _start; // 计算插入位置前的元素个数
             size_t new_capacity = capacity() == 0 ? 4 : capacity() * 2; // 扩大容量
             reserve(new_capacity);
             pos = _start + len; // 更新插入位置
         }
-        iterator end = _finish;
-        while (end >= pos + 1) {
-            *(end) = *(end - 1); // 向后移动元素
-            end--;
-        }
-        *pos = x; // 在插入位置插入新元素
+        construct(_finish, std::move(*(_finish - 1))); // 最后一个元素移动到未构造的空间
+        std::move_backward(pos, _finish - 1, _finish); // 其余元素向后移动
+        *pos = std::move(tmp); // 在插入位置放入新元素
         _finish++; // 更新有效数据结束位置
     }
 
-    // 删除指定位置的元素
-    template <class T>
-    vector<T>::iterator vector<T>::erase(iterator pos) {
-        assert(!empty()); // 确保容器不为空
-        iterator it = pos + 1;
-        while (it != _finish) {
-            *(it - 1) = *it; // 向前移动元素
-            it++;
+    /**
+     * 在指定位置插入一段区间，返回指向第一个插入元素的迭代器
+     * 1、前向迭代器：先算出插入个数n，容量不足时一次扩容到位，
+     *    再把pos之后的元素整体后移n个位置（只移动一次），最后把区间拷贝进空出的位置。
+     *    后移时落在[_finish, _finish + n)的元素需要在未构造的空间上构造，其余的直接赋值。
+     * 2、输入迭代器只能遍历一次，无法提前知道长度，先拷贝到临时vector再按情况1插入。
+     */
+    template <class T, class Alloc>
+    template<class InputIterator>
+    constexpr vector<T, Alloc>::iterator vector<T, Alloc>::insert(iterator it, InputIterator first, InputIterator last) {
+        typedef typename std::iterator_traits<InputIterator>::iterator_category category;
+        if constexpr (!std::is_base_of_v<std::forward_iterator_tag, category>) {
+            vector<T, Alloc> tmp(first, last, _alloc);
+            return insert(it, std::make_move_iterator(tmp.data()), std::make_move_iterator(tmp.data() + tmp.size()));
+        } else {
+            T* pos = unwrap(it);
+            size_t len = pos - _start; // 计算插入位置前的元素个数
+            size_t n = std::distance(first, last);
+            if (n == 0) {
+                return it;
+            }
+            invalidate();
+            if (size() + n > capacity()) {
+                reserve(std::max(size() + n, capacity() * 2)); // 一次扩容到位
+                pos = _start + len; // 更新插入位置
+            }
+            size_t elems_after = _finish - pos; // pos之后的元素个数
+            T* old_finish = _finish;
+            if (elems_after > n) {
+                // 尾部n个元素移动到未构造的空间，其余元素整体后移
+                for (T* p = old_finish - n; p != old_finish; ++p) {
+                    construct(_finish, std::move(*p));
+                    _finish++;
+                }
+                std::move_backward(pos, old_finish - n, old_finish);
+                std::copy(first, last, pos);
+            } else {
+                // 区间的后半部分直接构造在末尾，pos之后的元素全部移动到未构造的空间
+                InputIterator mid = first;
+                std::advance(mid, elems_after);
+                for (InputIterator src = mid; src != last; ++src) {
+                    construct(_finish, *src);
+                    _finish++;
+                }
+                for (T* p = pos; p != old_finish; ++p) {
+                    construct(_finish, std::move(*p));
+                    _finish++;
+                }
+                std::copy(first, mid, pos);
+            }
+            return wrap(pos);
         }
+    }
+
+    // 删除指定位置的元素
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::iterator vector<T, Alloc>::erase(iterator it) {
+        T* pos = unwrap(it);
+        MY_CHECK_CHEAP(pos < _finish); // 确保指向有效元素
+        invalidate();
+        std::move(pos + 1, _finish, pos); // 向前移动元素
         _finish--; // 更新有效数据结束位置
-        return pos;
+        alloc_traits::destroy(_alloc, _finish);
+        return wrap(pos);
+    }
+
+    // 删除[first, last)区间的元素，后面的元素整体前移一次，返回指向被删除区间之后第一个元素的迭代器
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::iterator vector<T, Alloc>::erase(iterator first, iterator last) {
+        T* b = unwrap(first);
+        T* e = unwrap(last);
+        MY_CHECK_CHEAP(b <= e); // 确保区间合法
+        if (b != e) {
+            invalidate();
+            T* new_finish = std::move(e, _finish, b); // 整体前移
+            destroy(new_finish, _finish);
+            _finish = new_finish;
+        }
+        return wrap(b);
+    }
+
+    // 将内容替换为n个value，容量不足时才重新开辟空间
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::assign(size_t n, const T& value) {
+        clear(); // 先清空，扩容时无需转移旧元素
+        reserve(n);
+        for (size_t i = 0; i < n; i++) {
+            construct(_finish, value);
+            _finish++;
+        }
+    }
+
+    /**
+     * 将内容替换为一段区间
+     * 1、前向迭代器：先算出区间长度，最多开辟一次空间，再整体构造。
+     * 2、输入迭代器：只能逐个尾插。
+     */
+    template <class T, class Alloc>
+    template<class InputIterator>
+        requires (!std::is_integral_v<InputIterator>)
+    constexpr void vector<T, Alloc>::assign(InputIterator first, InputIterator last) {
+        typedef typename std::iterator_traits<InputIterator>::iterator_category category;
+        clear(); // 先清空，扩容时无需转移旧元素
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, category>) {
+            reserve(std::distance(first, last));
+            for (; first != last; ++first) {
+                construct(_finish, *first);
+                _finish++;
+            }
+        } else {
+            while (first != last) {
+                push_back(*first);
+                ++first;
+            }
+        }
+    }
+
+    // 清空容器，析构所有元素但保留空间
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::clear() {
+        invalidate();
+        destroy(_start, _finish);
+        _finish = _start;
     }
 
     // 交换两个vector的内容
-    template <class T>
-    void vector<T>::swap(vector<T>& v) {
+    // propagate_on_container_swap为真时分配器一起交换，否则要求两个分配器相等
+    // 与std::vector一样不使迭代器失效：full等级下锚随元素一起交换，原来的迭代器指向另一个容器中的同一元素
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::swap(vector<T, Alloc>& v) {
         std::swap(_start, v._start);
         std::swap(_finish, v._finish);
         std::swap(_end_of_storage, v._end_of_storage);
+        if constexpr (alloc_traits::propagate_on_container_swap::value) {
+            std::swap(_alloc, v._alloc);
+        }
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+        if (!std::is_constant_evaluated()) {
+            std::swap(_anchor, v._anchor);
+            if (_anchor) {
+                _anchor->_owner = this;
+            }
+            if (v._anchor) {
+                v._anchor->_owner = &v;
+            }
+        }
+#endif
     }
 
     // 访问容器相关函数
-    template <class T>
-    T& vector<T>::operator[](size_t i) {
-        assert(i < size()); // 确保下标合法
+    template <class T, class Alloc>
+    constexpr T& vector<T, Alloc>::operator[](size_t i) {
+        MY_CHECK_CHEAP(i < size()); // 确保下标合法
         return _start[i];
     }
 
-    template <class T>
-    const T& vector<T>::operator[](size_t i)const {
-        assert(i < size()); // 确保下标合法
+    template <class T, class Alloc>
+    constexpr const T& vector<T, Alloc>::operator[](size_t i)const {
+        MY_CHECK_CHEAP(i < size()); // 确保下标合法
         return _start[i];
     }
-}
\ No newline at end of file
+
+    // 底层数组
+    template <class T, class Alloc>
+    constexpr T* vector<T, Alloc>::data() {
+        return _start;
+    }
+
+    template <class T, class Alloc>
+    constexpr const T* vector<T, Alloc>::data()const {
+        return _start;
+    }
+
+    // 以span形式返回全部元素
+    template <class T, class Alloc>
+    constexpr std::span<T> vector<T, Alloc>::span() {
+        return std::span<T>(_start, size());
+    }
+
+    template <class T, class Alloc>
+    constexpr std::span<const T> vector<T, Alloc>::span()const {
+        return std::span<const T>(_start, size());
+    }
+
+    // 获取分配器
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::allocator_type vector<T, Alloc>::get_allocator()const {
+        return _alloc;
+    }
+
+    // 在p处构造元素，参数恰好是一个T时按值类别统计为拷贝或移动
+    template <class T, class Alloc>
+    template <class... Args>
+    constexpr void vector<T, Alloc>::construct(T* p, Args&&... args) {
+        alloc_traits::construct(_alloc, p, std::forward<Args>(args)...);
+#if MY_TELEMETRY
+        if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, T> && ...)) {
+            if constexpr ((std::is_rvalue_reference_v<Args&&> && ...) && !(std::is_const_v<std::remove_reference_t<Args>> || ...)) {
+                MY_TELEMETRY_MOVE(vector_kind, 1);
+            } else {
+                MY_TELEMETRY_COPY(vector_kind, 1);
+            }
+        }
+#endif
+    }
+
+    // 析构[first, last)区间的元素，不释放空间
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::destroy(T* first, T* last) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (; first != last; ++first) {
+                alloc_traits::destroy(_alloc, first);
+            }
+        }
+    }
+
+    // 析构所有元素并把空间还给分配器
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::release() {
+        if (_start) {
+            invalidate();
+            destroy(_start, _finish);
+            alloc_traits::deallocate(_alloc, _start, capacity());
+            MY_TELEMETRY_DEALLOCATE(vector_kind);
+            _start = nullptr;
+            _finish = nullptr;
+            _end_of_storage = nullptr;
+        }
+    }
+
+    // 把指针包装成迭代器，full等级下记录所属容器和当前版本号
+    template <class T, class Alloc>
+    constexpr vector<T, Alloc>::iterator vector<T, Alloc>::wrap(T* p)const {
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+        return iterator(p, anchor());
+#else
+        return p;
+#endif
+    }
+
+    // 取出迭代器中的指针，full等级下检查迭代器属于本容器、未失效且在[begin, end]之内
+    template <class T, class Alloc>
+    constexpr T* vector<T, Alloc>::unwrap(const_iterator it)const {
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+        if (!std::is_constant_evaluated()) {
+            it.check();
+            MY_CHECK_FULL(it._anchor == _anchor && it._ptr >= _start && it._ptr <= _finish);
+        }
+        return const_cast<T*>(it._ptr);
+#else
+        return const_cast<T*>(it);
+#endif
+    }
+
+    // 使已有的迭代器失效，还没有锚说明还没有创建过迭代器，不需要处理
+    template <class T, class Alloc>
+    constexpr void vector<T, Alloc>::invalidate() {
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+        if (!std::is_constant_evaluated() && _anchor) {
+            _anchor->_generation++;
+        }
+#endif
+    }
+
+#if MY_HARDENING_LEVEL >= MY_HARDENING_FULL
+    /**
+     * 获取锚，第一次创建迭代器时才分配，没有用过迭代器的vector不为此付出一次内存申请
+     * 多个线程可以同时对同一个const vector调用begin()，用CAS保证只有一个锚被留下
+     * 常量求值中不使用锚：越界和访问已释放的内存本来就是编译错误，GCC 12也不允许在常量求值中读取mutable成员
+     */
+    template <class T, class Alloc>
+    constexpr _iterator_anchor<vector<T, Alloc>>* vector<T, Alloc>::anchor()const {
+        if (std::is_constant_evaluated()) {
+            return nullptr;
+        }
+        return _install_anchor(_anchor, this);
+    }
+#endif
+}
+}